@@ -48,7 +48,8 @@ LOCAL_LDFLAGS := -fopenmp
 
 LOCAL_LDLIBS := \
 	-lapparmor \
-	-ldl
+	-ldl \
+	-lpthread
 
 LOCAL_REQUIRED_MODULES := \
 	ulogger
@@ -69,11 +70,20 @@ LOCAL_SRC_FILES := \
 
 LOCAL_LIBRARIES := \
 	libblkid \
+	libpomp \
+	librs \
 	libutils
 
 LOCAL_CFLAGS := -DFWD_INTERPRETER=\"$(TARGET_LOADER)\"
 LOCAL_LDFLAGS := -Wl,-e,$(LOCAL_MODULE)_main
 
+LOCAL_LDLIBS := \
+	-lpthread
+
+# output of LIBFWD_GET_MESSAGES= libfwd.so, to regenerate when the schema changes
+LOCAL_COPY_FILES := \
+	resources/fwd_messages:usr/share/firmwared/
+
 LOCAL_EXPORT_C_INCLUDES  := $(LOCAL_PATH)/include
 
 include $(BUILD_LIBRARY)
@@ -87,14 +97,36 @@ LOCAL_MODULE := fdc
 LOCAL_DESCRIPTION := Command line interface for firmwared
 LOCAL_CATEGORY_PATH := sphinx/firmwared
 
-LOCAL_REQUIRED_MODULES := firmwared \
-	pomp-cli
+LOCAL_SRC_FILES := \
+	utils/fdc.c
+
+LOCAL_LIBRARIES := \
+	libfwd \
+	libpomp \
+	libutils
 
 LOCAL_COPY_FILES := \
-	man/fdc.1:usr/share/man/man1/ \
-	utils/fdc:usr/bin/fdc
+	man/fdc.1:usr/share/man/man1/
+
+include $(BUILD_EXECUTABLE)
+
+################################################################################
+# fwd-client-example
+################################################################################
+
+include $(CLEAR_VARS)
+LOCAL_MODULE := fwd-client-example
+LOCAL_DESCRIPTION := Example use of the C++ client of firmwared
+LOCAL_CATEGORY_PATH := sphinx/firmwared
+
+LOCAL_SRC_FILES := \
+	examples/fwd_client.cpp
+
+LOCAL_CXXFLAGS := \
+	-std=c++20
 
 LOCAL_LIBRARIES := \
-	libfwd
+	libfwd \
+	libpomp
 
-include $(BUILD_CUSTOM)
+include $(BUILD_EXECUTABLE)
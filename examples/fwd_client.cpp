@@ -0,0 +1,120 @@
+/**
+ * @file fwd_client.cpp
+ * @brief example use of the header-only C++ client of firmwared
+ *
+ * Prints firmwared's version, its folders and the pid of the instances, then
+ * pings it from a coroutine if C++20 coroutines are available. Being compiled
+ * with the rest of the tree, it also checks that fwd_client.hpp builds and
+ * rejects the arguments which don't match a command's format.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <cstdlib>
+
+#include <exception>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "fwd_client.hpp"
+
+/* the arguments are checked at compile time against the command's format */
+static_assert(fwd::acceptsArgs<MsgFmtCommandPing>);
+static_assert(fwd::acceptsArgs<MsgFmtCommandList, const char *>);
+static_assert(fwd::acceptsArgs<MsgFmtCommandList, std::string>);
+static_assert(fwd::acceptsArgs<MsgFmtCommandGetProperty, const char *,
+		std::string, const char *>);
+/* wrong type */
+static_assert(!fwd::acceptsArgs<MsgFmtCommandList, int>);
+/* a std::string_view needn't be nul-terminated */
+static_assert(!fwd::acceptsArgs<MsgFmtCommandList, std::string_view>);
+/* wrong number of arguments */
+static_assert(!fwd::acceptsArgs<MsgFmtCommandPing, const char *>);
+static_assert(!fwd::acceptsArgs<MsgFmtCommandList>);
+/* the answer's format is deduced from the command */
+static_assert(std::is_same<fwd::AnswerOf<MsgFmtCommandPing>,
+		fwd::Reply<MsgFmtAnswerPong>>::value);
+
+#ifdef FWD_CLIENT_HAS_COROUTINES
+/* starts eagerly and isn't awaitable, enough for this example */
+struct Task {
+	struct promise_type {
+		Task get_return_object() { return {}; }
+		std::suspend_never initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() {}
+		void unhandled_exception() { std::terminate(); }
+	};
+};
+
+static Task ping(fwd::Client &client, bool &done)
+{
+	try {
+		auto pong = co_await client.awaitable<MsgFmtCommandPing>();
+
+		std::cout << "pong, seqnum " << pong.seqnum() << std::endl;
+	} catch (const fwd::Error &e) {
+		std::cerr << "ping: " << e.what() << std::endl;
+	}
+	done = true;
+}
+#endif /* FWD_CLIENT_HAS_COROUTINES */
+
+int main(int argc, char *argv[])
+{
+	std::string folder = "instances";
+
+	try {
+		/* the first argument, if any, is the socket path */
+		fwd::Client client(argc > 1 ? argv[1] : nullptr);
+
+		/* the requests are pipelined */
+		auto version = client.request<MsgFmtCommandVersion>();
+		auto folders = client.request<MsgFmtCommandFolders>();
+		auto list = client.request<MsgFmtCommandList>(folder);
+
+		std::cout << "version " << client.get(version).get<0>()
+				<< std::endl;
+		std::cout << "folders " << client.get(folders).get<0>()
+				<< std::endl;
+
+		/* the list is "name[sha1] name[sha1]..." */
+		auto l = client.get(list);
+		std::istringstream entities{std::string(l.get<2>())};
+		std::string entity;
+		/* tuples of arguments, which must be sent as strings */
+		std::vector<std::string> args{folder,
+				std::to_string(l.get<1>())};
+		while (entities >> entity) {
+			args.push_back(entity.substr(0, entity.find('[')));
+			args.emplace_back("pid");
+		}
+		auto pids = client.requestStrings<MsgFmtCommandGetProperties>(
+				args);
+		auto p = client.get(pids, 5000);
+		for (const auto &value : p.tail())
+			std::visit([](const auto &v) { std::cout << v << " "; },
+					value);
+		std::cout << std::endl;
+
+#ifdef FWD_CLIENT_HAS_COROUTINES
+		int ret;
+		bool done = false;
+
+		ping(client, done);
+		while (!done) {
+			ret = client.waitAndProcess();
+			if (ret < 0)
+				throw fwd::Error(-ret, "waitAndProcess");
+		}
+#endif /* FWD_CLIENT_HAS_COROUTINES */
+	} catch (const fwd::Error &e) {
+		std::cerr << e.what() << std::endl;
+		return EXIT_FAILURE;
+	}
+
+	return EXIT_SUCCESS;
+}
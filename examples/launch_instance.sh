@@ -65,14 +65,10 @@ fi
 instance=$(fdc prepare instances ${firmware} | tail -n 1 | sed 's/.*: //g');
 
 fdc show instances $instance
-# set which process will be used as the pid 1
-fdc set_property instances $instance cmdline[0] /sbin/boxinit
 # retrieve the pts which will be used by the boxinit console service
 console_pts=$(fdc get_property instances $instance inner_pts)
 # strip the leading /dev
 console_pts=${console_pts#/dev}
-# pass it as an argument to boxinit
-fdc set_property instances $instance cmdline[1] ro.boot.console=${console_pts}
 # set the ro.hardware property
 # the list of supported hardware corresponds to the list of the
 # /etc/default.${ro.hardware}.prop the firmware contains.
@@ -82,10 +78,17 @@ if [ -z "${hardware+x}" ]; then
 	mount_point=$(fdc get_property firmwares ${firmware} base_workspace)
 	hardware=$(ls ${mount_point}/etc/default.*.prop | head -n1 | sed 's#.*/default\.\([^.]*\)\.prop#\1#g')
 fi
-fdc set_property instances $instance cmdline[2] ro.hardware=${hardware}
-# the first nil command-line argument ends the array, it is needed to get rid of
-# the parameters which were already registered in the command-line
-fdc set_property instances $instance cmdline[3] nil
+# set the whole command-line in one message, atomically:
+#  * which process will be used as the pid 1
+#  * the console pts, as an argument to boxinit
+#  * the ro.hardware property
+#  * the first nil command-line argument ends the array, it is needed to get rid
+#    of the parameters which were already registered in the command-line
+fdc set_properties instances 1 \
+	$instance cmdline[0] /sbin/boxinit \
+	$instance cmdline[1] ro.boot.console=${console_pts} \
+	$instance cmdline[2] ro.hardware=${hardware} \
+	$instance cmdline[3] nil
 
 if [ -n "${wifi_config}" ]; then
 	fdc set_property instances $instance stolen_interface ${wifi_config}
@@ -12,141 +12,70 @@
 #include <stdbool.h>
 #include <inttypes.h>
 
+#include "fwd_schema.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /*
- * printf formats for sending a command of for reading the arguments (with _READ
- * suffix)
- */
-#define FWD_FORMAT_COMMAND_ADD_PROPERTY "%" PRIu32 "%s%s"
-#define FWD_FORMAT_COMMAND_ADD_PROPERTY_READ "%" PRIu32 "%ms%ms"
-#define FWD_FORMAT_COMMAND_COMMANDS "%" PRIu32
-#define FWD_FORMAT_COMMAND_CONFIG_KEYS "%" PRIu32
-#define FWD_FORMAT_COMMAND_DROP "%" PRIu32 "%s%s"
-#define FWD_FORMAT_COMMAND_DROP_READ "%" PRIu32 "%ms%ms"
-#define FWD_FORMAT_COMMAND_FOLDERS "%" PRIu32
-#define FWD_FORMAT_COMMAND_GET_CONFIG "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_GET_CONFIG_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_GET_PROPERTY "%" PRIu32 "%s%s%s"
-#define FWD_FORMAT_COMMAND_GET_PROPERTY_READ "%" PRIu32 "%ms%ms%ms"
-#define FWD_FORMAT_COMMAND_HELP "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_HELP_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_KILL "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_KILL_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_LIST "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_LIST_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_PING "%" PRIu32
-#define FWD_FORMAT_COMMAND_PREPARE "%" PRIu32 "%s%s"
-#define FWD_FORMAT_COMMAND_PREPARE_READ "%" PRIu32 "%ms%ms"
-#define FWD_FORMAT_COMMAND_PROPERTIES "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_PROPERTIES_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_QUIT "%" PRIu32
-#define FWD_FORMAT_COMMAND_REMOUNT "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_REMOUNT_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_SET_PROPERTY "%" PRIu32 "%s%s%s%s"
-#define FWD_FORMAT_COMMAND_SET_PROPERTY_READ "%" PRIu32 "%ms%ms%ms%ms"
-#define FWD_FORMAT_COMMAND_SHOW "%" PRIu32 "%s%s"
-#define FWD_FORMAT_COMMAND_SHOW_READ "%" PRIu32 "%ms%ms"
-#define FWD_FORMAT_COMMAND_START "%" PRIu32 "%s"
-#define FWD_FORMAT_COMMAND_START_READ "%" PRIu32 "%ms"
-#define FWD_FORMAT_COMMAND_VERSION "%" PRIu32
-
-/*
- * printf formats for sending an answer
+ * printf formats for sending a message of id FWD_<message>, or for reading its
+ * arguments with FWD_FORMAT_READ, e.g. FWD_FORMAT(COMMAND_KILL), see
+ * fwd_schema.h for the messages followed by tuples of arguments
  */
-#define FWD_FORMAT_ANSWER_COMMANDS "%" PRIu32 "%s"
-#define FWD_FORMAT_ANSWER_CONFIG_KEYS "%" PRIu32 "%s"
-#define FWD_FORMAT_ANSWER_ERROR "%" PRIu32 "%" PRIi32 "%s"
-#define FWD_FORMAT_ANSWER_FOLDERS "%" PRIu32 "%s"
-#define FWD_FORMAT_ANSWER_GET_CONFIG "%" PRIu32 "%s%s"
-#define FWD_FORMAT_ANSWER_GET_PROPERTY "%" PRIu32 "%s%s%s%s"
-#define FWD_FORMAT_ANSWER_HELP "%" PRIu32 "%s%s"
-#define FWD_FORMAT_ANSWER_LIST "%" PRIu32 "%s%" PRIu32 "%s"
-#define FWD_FORMAT_ANSWER_PONG "%" PRIu32
-#define FWD_FORMAT_ANSWER_PROPERTIES "%" PRIu32 "%s%s"
-#define FWD_FORMAT_ANSWER_PROPERTY_ADDED "%" PRIu32 "%s%s"
-#define FWD_FORMAT_ANSWER_PROPERTY_SET "%" PRIu32 "%s%s%s%s"
-#define FWD_FORMAT_ANSWER_REMOUNTED "%" PRIu32
-#define FWD_FORMAT_ANSWER_SHOW "%" PRIu32 "%s%s%s%s"
-#define FWD_FORMAT_ANSWER_VERSION "%" PRIu32 "%s"
-
-#define FWD_FORMAT_ANSWER_BYEBYE "%" PRIu32
-#define FWD_FORMAT_ANSWER_DEAD "%" PRIu32 "%s%s"
-#define FWD_FORMAT_ANSWER_DROPPED "%" PRIu32 "%s%s%s"
-#define FWD_FORMAT_ANSWER_PREPARED "%" PRIu32 "%s%s%s"
-#define FWD_FORMAT_ANSWER_PREPARE_PROGRESS "%" PRIu32 "%s%s%s"
-#define FWD_FORMAT_ANSWER_STARTED "%" PRIu32 "%s%s"
+#define FWD_FORMAT(message) FWD_SCHEMA_MAP(FWD_FORMAT_TYPE_, \
+		FWD_ARGS_##message)
+#define FWD_FORMAT_READ(message) FWD_SCHEMA_MAP(FWD_FORMAT_READ_TYPE_, \
+		FWD_ARGS_##message)
 
 #define FWD_FORMAT_INVALID ""
 
-/* values must stay consecutive */
+#define FWD_FORMAT_TYPE_(type) FWD_FORMAT_TYPE_##type
+#define FWD_FORMAT_TYPE_U32 "%" PRIu32
+#define FWD_FORMAT_TYPE_I32 "%" PRIi32
+#define FWD_FORMAT_TYPE_U64 "%" PRIu64
+#define FWD_FORMAT_TYPE_STR "%s"
+#define FWD_FORMAT_READ_TYPE_(type) FWD_FORMAT_READ_TYPE_##type
+#define FWD_FORMAT_READ_TYPE_U32 FWD_FORMAT_TYPE_U32
+#define FWD_FORMAT_READ_TYPE_I32 FWD_FORMAT_TYPE_I32
+#define FWD_FORMAT_READ_TYPE_U64 FWD_FORMAT_TYPE_U64
+#define FWD_FORMAT_READ_TYPE_STR "%ms"
+
+#define FWD_COMMAND_ID_(name, ...) FWD_COMMAND_##name,
+#define FWD_ANSWER_ID_(name, ...) FWD_ANSWER_##name,
+
+/* values must stay consecutive, their order is the one of fwd_schema.h */
 enum fwd_message {
 	FWD_MESSAGE_INVALID,
 
 	/* commands, i.e. from client to server */
-	FWD_MESSAGE_FIRST,
-	FWD_COMMAND_FIRST = FWD_MESSAGE_FIRST,
+	FWD_COMMANDS(FWD_COMMAND_ID_)
 
-	FWD_COMMAND_ADD_PROPERTY = FWD_COMMAND_FIRST,
-	FWD_COMMAND_COMMANDS,
-	FWD_COMMAND_CONFIG_KEYS,
-	FWD_COMMAND_DROP,
-	FWD_COMMAND_FOLDERS,
-	FWD_COMMAND_GET_CONFIG,
-	FWD_COMMAND_GET_PROPERTY,
-	FWD_COMMAND_HELP,
-	FWD_COMMAND_KILL,
-	FWD_COMMAND_LIST,
-	FWD_COMMAND_PING,
-	FWD_COMMAND_PREPARE,
-	FWD_COMMAND_PROPERTIES,
-	FWD_COMMAND_QUIT,
-	FWD_COMMAND_REMOUNT,
-	FWD_COMMAND_SET_PROPERTY,
-	FWD_COMMAND_SHOW,
-	FWD_COMMAND_START,
-	FWD_COMMAND_VERSION,
-
-	FWD_COMMAND_LAST = FWD_COMMAND_VERSION,
-
-	/* answers, i.e. from server to client */
-	FWD_ANSWER_FIRST,
+	/* answers, i.e. from server to client, acks then notifications */
+	FWD_ANSWERS(FWD_ANSWER_ID_)
 
-	/* acks */
-	FWD_ANSWER_COMMANDS = FWD_ANSWER_FIRST,
-	FWD_ANSWER_CONFIG_KEYS,
-	FWD_ANSWER_ERROR,
-	FWD_ANSWER_FOLDERS,
-	FWD_ANSWER_GET_CONFIG,
-	FWD_ANSWER_GET_PROPERTY,
-	FWD_ANSWER_HELP,
-	FWD_ANSWER_LIST,
-	FWD_ANSWER_PONG,
-	FWD_ANSWER_PROPERTIES,
-	FWD_ANSWER_PROPERTY_ADDED,
-	FWD_ANSWER_PROPERTY_SET,
-	FWD_ANSWER_REMOUNTED,
-	FWD_ANSWER_SHOW,
-	FWD_ANSWER_VERSION,
-
-	/* notifications */
-	FWD_ANSWER_BYEBYE,
-	FWD_ANSWER_DEAD,
-	FWD_ANSWER_DROPPED,
-	FWD_ANSWER_PREPARED,
-	FWD_ANSWER_PREPARE_PROGRESS,
-	FWD_ANSWER_STARTED,
-
-	FWD_ANSWER_LAST = FWD_ANSWER_STARTED,
+	FWD_MESSAGE_FIRST = FWD_MESSAGE_INVALID + 1,
+	FWD_COMMAND_FIRST = FWD_MESSAGE_FIRST,
+	FWD_COMMAND_LAST = FWD_COMMAND_FIRST +
+			FWD_SCHEMA_COUNT(FWD_COMMANDS) - 1,
+	FWD_ANSWER_FIRST,
+	FWD_ANSWER_LAST = FWD_ANSWER_FIRST + FWD_SCHEMA_COUNT(FWD_ANSWERS) - 1,
 	FWD_MESSAGE_LAST = FWD_ANSWER_LAST,
 };
 
 const char *fwd_message_str(enum fwd_message message);
 
+/**
+ * Looks a message up by name, in constant time.
+ * @param str Name of the message, some commands and answers share the same
+ * name, e.g. HELP, in which case the command is returned
+ * @return message, or FWD_MESSAGE_INVALID if not found
+ */
 enum fwd_message fwd_message_from_str(const char *str);
 
+/* same as fwd_message_from_str(), but only the answers are looked up */
+enum fwd_message fwd_answer_from_str(const char *str);
+
 bool fwd_message_is_invalid(enum fwd_message message);
 
 /**
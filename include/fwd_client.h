@@ -0,0 +1,172 @@
+/**
+ * @file fwd_client.h
+ * @brief asynchronous client of firmwared
+ *
+ * A client owns a connection to firmwared, re-established automatically when
+ * lost. Commands are sent without waiting for the answers of the previous ones,
+ * each with a sequence number of its own, so that its answer, the one given by
+ * fwd_message_command_answer() or an ERROR, is routed to the callback passed
+ * when sending it. The other messages are routed to the notification callbacks.
+ *
+ * The client runs in its own libpomp loop, whose file descriptor can be
+ * monitored by an external event loop, fwd_client_process_fd() being called
+ * when it is readable. No callback can destroy the client.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef INCLUDE_FWD_CLIENT_H_
+#define INCLUDE_FWD_CLIENT_H_
+#include <stdbool.h>
+#include <stdarg.h>
+
+#include <libpomp.h>
+
+#include <fwd.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FWD_CLIENT_DEFAULT_SOCKET_PATH "/var/run/firmwared.sock"
+
+struct fwd_client;
+
+/**
+ * Called once for each request, when it's over.
+ * @param client Client the command was sent with
+ * @param status 0 if msg is the answer indicating the command has succeeded,
+ * the negative errno value sent by firmwared if msg is an ERROR. msg is NULL
+ * if the connection was lost after the command was sent, status being then
+ * -ECONNRESET, or if the request was cancelled or the client destroyed, status
+ * being then -ECANCELED
+ * @param msg Answer, valid only during the call
+ * @param userdata User data passed when sending the command
+ */
+typedef void (*fwd_client_answer_cb)(struct fwd_client *client, int status,
+		const struct pomp_msg *msg, void *userdata);
+
+/**
+ * Called for each message received which doesn't terminate a request, e.g. the
+ * PREPARE_PROGRESS of a pending PREPARE, or the PROPERTY_CHANGED following a
+ * WATCH.
+ */
+typedef void (*fwd_client_notification_cb)(struct fwd_client *client,
+		const struct pomp_msg *msg, void *userdata);
+
+/**
+ * Called each time the connection to firmwared is established or lost. A new
+ * connection is a new client for firmwared, which doesn't know the previous
+ * SUBSCRIBE, WATCH or SET_DEADLINE commands anymore.
+ */
+typedef void (*fwd_client_connection_cb)(struct fwd_client *client,
+		bool connected, void *userdata);
+
+/**
+ * Creates a client and starts connecting to firmwared.
+ * @param socket_path Path of the socket firmwared listens on, NULL for
+ * FWD_CLIENT_DEFAULT_SOCKET_PATH, or address of one of the listeners configured
+ * with FIRMWARED_LISTEN, tcp:HOST:PORT or unix:PATH
+ * @return Client, to destroy with fwd_client_destroy(), or NULL on error, with
+ * errno set
+ */
+struct fwd_client *fwd_client_new(const char *socket_path);
+
+/**
+ * Sends a command, with the arguments following the sequence number in its
+ * fwd_message_format(). The commands sent while the client isn't connected are
+ * queued, then sent in a row once the connection is established.
+ * @param command Command to send
+ * @param cb Callback called when the request is over
+ * @param userdata User data passed to cb
+ * @return 0 on success, a negative errno value on error, in which case cb won't
+ * be called
+ */
+int fwd_client_send(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, ...);
+
+/**
+ * Same as fwd_client_send, but the arguments are described by the format fmt,
+ * sequence number excluded, needed for the commands followed by tuples of
+ * arguments, e.g. GET_PROPERTIES.
+ */
+int fwd_client_send_fmt(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, const char *fmt, ...);
+
+int fwd_client_sendv(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, const char *fmt,
+		va_list args);
+
+/**
+ * Sends a command whose arguments are given as strings, the numbers being
+ * converted according to the command's fwd_message_format(). The arguments
+ * given after those of the format are sent as strings, e.g. the tuples
+ * following the COUNT argument of GET_PROPERTIES.
+ * @param argc Number of arguments, sequence number excluded
+ * @param argv Arguments, sequence number excluded
+ * @return 0 on success, -EINVAL if an argument is missing or if a number is
+ * invalid, another negative errno value on error, in which case cb won't be
+ * called
+ */
+int fwd_client_send_strv(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, unsigned argc,
+		const char * const argv[]);
+
+/**
+ * Tells whether a message bears the sequence number of a request sent with
+ * userdata and not terminated yet, e.g. a PREPARE_PROGRESS notification.
+ */
+bool fwd_client_msg_matches(const struct fwd_client *client,
+		const struct pomp_msg *msg, const void *userdata);
+
+/**
+ * Cancels the pending requests sent with userdata, their callbacks are called
+ * with -ECANCELED and their answers, if any, will be ignored.
+ * @return number of requests cancelled
+ */
+unsigned fwd_client_cancel(struct fwd_client *client, void *userdata);
+
+/**
+ * Sets the callback called for the messages of id message which don't
+ * terminate a request, FWD_MESSAGE_INVALID sets the one called for the
+ * messages without a callback of their own. A NULL cb removes the callback.
+ */
+int fwd_client_set_notification_cb(struct fwd_client *client,
+		enum fwd_message message, fwd_client_notification_cb cb,
+		void *userdata);
+
+int fwd_client_set_connection_cb(struct fwd_client *client,
+		fwd_client_connection_cb cb, void *userdata);
+
+bool fwd_client_is_connected(const struct fwd_client *client);
+
+/* number of requests sent or queued, not terminated yet */
+unsigned fwd_client_get_pending(const struct fwd_client *client);
+
+/**
+ * Returns the file descriptor to monitor for reading in an external event loop.
+ * @return file descriptor, or a negative errno value on error
+ */
+int fwd_client_get_fd(const struct fwd_client *client);
+
+/* processes the events pending on the client's file descriptor */
+int fwd_client_process_fd(struct fwd_client *client);
+
+/**
+ * Waits for events and processes them, for the clients not integrated in an
+ * external event loop.
+ * @param timeout In ms, -1 to wait forever
+ * @return 0 on success, -ETIMEDOUT if no event occurred, a negative errno value
+ * on error
+ */
+int fwd_client_wait_and_process(struct fwd_client *client, int timeout);
+
+/* the requests still pending are cancelled */
+void fwd_client_destroy(struct fwd_client **client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_FWD_CLIENT_H_ */
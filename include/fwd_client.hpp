@@ -0,0 +1,644 @@
+/**
+ * @file fwd_client.hpp
+ * @brief header-only C++ asynchronous client of firmwared
+ *
+ * Thin layer over the C client of fwd_client.h, typed by the message formats of
+ * fwd.hpp: the arguments of a request are checked at compile time against its
+ * MsgFmtCommand* format, its answer type is deduced from the command and is
+ * decoded without copying, the strings being std::string_view pointing into the
+ * message received, which the Reply keeps alive. Requests are pipelined and
+ * correlated with their answers by sequence number by the C client.
+ *
+ *	fwd::Client client;
+ *	auto pong = client.request<MsgFmtCommandPing>();
+ *	auto started = client.request<MsgFmtCommandStart>(name);
+ *
+ *	client.get(pong);
+ *	std::string_view instance = client.get(started).get<1>();
+ *
+ * Nothing here is thread-safe, all the callbacks are called from the client's
+ * process() or waitAndProcess() and must not throw.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef INCLUDE_FWD_CLIENT_HPP_
+#define INCLUDE_FWD_CLIENT_HPP_
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+
+#include <array>
+#include <chrono>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#if defined(__cpp_impl_coroutine) && __has_include(<coroutine>)
+#include <coroutine>
+#define FWD_CLIENT_HAS_COROUTINES 1
+#endif
+
+#include "fwd.hpp"
+#include "fwd_client.h"
+
+namespace fwd {
+
+/* value of an argument of a message, as decoded */
+typedef std::variant<uint32_t, int32_t, uint64_t, std::string_view> Value;
+
+/* firmwared answered with an ERROR, or the request couldn't complete */
+class Error : public std::system_error {
+public:
+	Error(int err, const std::string &what) :
+		std::system_error(err, std::generic_category(), what) {}
+};
+
+namespace internal {
+
+template<typename Arg> struct ArgTraits;
+
+template<> struct ArgTraits<pomp::ArgU32> {
+	typedef uint32_t type;
+	/* only the unsigned integers which can't be truncated */
+	template<typename T> static constexpr bool accepts =
+			std::is_integral<T>::value &&
+			std::is_unsigned<T>::value &&
+			!std::is_same<T, bool>::value &&
+			sizeof(T) <= sizeof(type);
+	template<typename T> static type wire(T value) { return value; }
+};
+
+template<> struct ArgTraits<pomp::ArgI32> {
+	typedef int32_t type;
+	template<typename T> static constexpr bool accepts =
+			std::is_integral<T>::value &&
+			!std::is_same<T, bool>::value &&
+			sizeof(T) <= sizeof(type) &&
+			(std::is_signed<T>::value || sizeof(T) < sizeof(type));
+	template<typename T> static type wire(T value) { return value; }
+};
+
+template<> struct ArgTraits<pomp::ArgU64> {
+	typedef uint64_t type;
+	template<typename T> static constexpr bool accepts =
+			std::is_integral<T>::value &&
+			std::is_unsigned<T>::value &&
+			!std::is_same<T, bool>::value;
+	template<typename T> static type wire(T value) { return value; }
+};
+
+template<> struct ArgTraits<pomp::ArgStr> {
+	typedef std::string_view type;
+	/* std::string_view isn't accepted, it needn't be nul-terminated */
+	template<typename T> static constexpr bool accepts =
+			std::is_convertible<T, const char *>::value ||
+			std::is_same<T, std::string>::value;
+	static const char *wire(const char *value) { return value; }
+	static const char *wire(const std::string &value)
+	{
+		return value.c_str();
+	}
+};
+
+template<typename Fmt> struct FormatTraits;
+
+template<uint32_t Id, typename Seqnum, typename... Args>
+struct FormatTraits<pomp::MessageFormat<Id, Seqnum, Args...>> {
+	static_assert(std::is_same<Seqnum, pomp::ArgU32>::value,
+			"a message starts with its sequence number");
+
+	static constexpr enum fwd_message id =
+			static_cast<enum fwd_message>(Id);
+	/* the arguments following the sequence number */
+	typedef std::tuple<Args...> Args_;
+	typedef std::tuple<typename ArgTraits<Args>::type...> Values;
+	static constexpr std::size_t count = sizeof...(Args);
+};
+
+template<enum fwd_message Id> struct FormatOf;
+
+#define FWD_CLIENT_FORMAT_OF(name, camel_case_name) \
+	template<> struct FormatOf<FWD_ANSWER_##name> { \
+		typedef MsgFmtAnswer##camel_case_name type; \
+	};
+
+FWD_ANSWERS(FWD_CLIENT_FORMAT_OF)
+
+#undef FWD_CLIENT_FORMAT_OF
+
+template<typename Command> struct AnswerOf;
+
+#define FWD_CLIENT_ANSWER_OF(name, camel_case_name, answer) \
+	template<> struct AnswerOf<MsgFmtCommand##camel_case_name> { \
+		typedef FormatOf<FWD_ANSWER_##answer>::type type; \
+	};
+
+FWD_COMMANDS(FWD_CLIENT_ANSWER_OF)
+
+#undef FWD_CLIENT_ANSWER_OF
+
+template<typename Fmt, typename... T> struct ArgsMatch;
+
+template<typename... Args, typename... T>
+struct ArgsMatch<std::tuple<Args...>, T...> {
+	static constexpr bool value = (ArgTraits<Args>::template accepts<
+			typename std::decay<T>::type> && ...);
+};
+
+/* true if T are valid arguments for the format Fmt, never fails to compile */
+template<typename Fmt, typename... T>
+constexpr bool args_match()
+{
+	typedef FormatTraits<Fmt> Traits;
+
+	if constexpr (Traits::count == sizeof...(T))
+		return ArgsMatch<typename Traits::Args_, T...>::value;
+
+	return false;
+}
+
+/* fails to compile if T aren't valid arguments for the format Fmt */
+template<typename Fmt, typename... T>
+constexpr bool check_args()
+{
+	typedef FormatTraits<Fmt> Traits;
+
+	static_assert(Traits::count == sizeof...(T),
+			"wrong number of arguments for this command");
+	if constexpr (Traits::count == sizeof...(T)) {
+		static_assert(ArgsMatch<typename Traits::Args_, T...>::value,
+				"wrong argument types for this command");
+		return ArgsMatch<typename Traits::Args_, T...>::value;
+	}
+
+	return false;
+}
+
+/* shares the message's buffer, instead of copying it */
+inline std::shared_ptr<struct pomp_msg> share(const struct pomp_msg *msg)
+{
+	struct pomp_msg *copy;
+
+	copy = pomp_msg_new_with_buffer(pomp_msg_get_buffer(msg));
+	if (copy == nullptr)
+		throw Error(ENOMEM, "pomp_msg_new_with_buffer");
+
+	return std::shared_ptr<struct pomp_msg>(copy, pomp_msg_destroy);
+}
+
+inline int decode_cb(struct pomp_decoder *, uint8_t type,
+		const union pomp_value *v, uint32_t, void *userdata)
+{
+	auto values = static_cast<std::vector<Value> *>(userdata);
+
+	switch (type) {
+	case POMP_PROT_DATA_TYPE_U32:
+		values->emplace_back(v->u32);
+		return 1;
+	case POMP_PROT_DATA_TYPE_I32:
+		values->emplace_back(v->i32);
+		return 1;
+	case POMP_PROT_DATA_TYPE_U64:
+		values->emplace_back(v->u64);
+		return 1;
+	case POMP_PROT_DATA_TYPE_STR:
+		values->emplace_back(std::string_view(v->str));
+		return 1;
+	default:
+		values->clear();
+		return 0;
+	}
+}
+
+/* returns -EPROTO if a value has a type no firmwared message uses */
+inline int decode(const struct pomp_msg *msg, std::vector<Value> &values)
+{
+	int ret;
+	struct pomp_decoder *dec;
+
+	dec = pomp_decoder_new();
+	if (dec == nullptr)
+		return -ENOMEM;
+	ret = pomp_decoder_init(dec, msg);
+	if (ret == 0)
+		ret = pomp_decoder_walk(dec, decode_cb, &values, 0);
+	pomp_decoder_destroy(dec);
+	if (ret == 0 && values.empty())
+		ret = -EPROTO;
+
+	return ret;
+}
+
+template<typename Values, std::size_t... I>
+bool to_tuple(const std::vector<Value> &values, Values &tuple,
+		std::index_sequence<I...>)
+{
+	/* values[0] is the sequence number */
+	return ((std::holds_alternative<
+			typename std::tuple_element<I, Values>::type>(
+					values[I + 1]) &&
+			(std::get<I>(tuple) = std::get<
+					typename std::tuple_element<I,
+					Values>::type>(values[I + 1]),
+					true)) && ...);
+}
+
+} /* namespace internal */
+
+/**
+ * true if Client::request<Command>() accepts arguments of types Args, e.g.
+ * static_assert(!fwd::acceptsArgs<MsgFmtCommandStart, int>)
+ */
+template<typename Command, typename... Args>
+constexpr bool acceptsArgs = internal::args_match<Command, Args...>();
+
+/**
+ * Message of format Fmt received, either the answer to a request or a
+ * notification. The string_view values stay valid as long as the Reply, or one
+ * of its copies, exists.
+ */
+template<typename Fmt>
+class Reply {
+public:
+	typedef internal::FormatTraits<Fmt> Traits;
+	typedef typename Traits::Values Values;
+
+	Reply() : mStatus(0), mSeqnum(0) {}
+
+	/*
+	 * 0 on success, the negative errno sent by firmwared in its ERROR,
+	 * -ECONNRESET, -ECANCELED or -EPROTO if the message is malformed
+	 */
+	int status() const { return mStatus; }
+	/* message of the ERROR, or empty */
+	std::string_view error() const { return mError; }
+	uint32_t seqnum() const { return mSeqnum; }
+	/* the arguments of the format, following the sequence number */
+	const Values &values() const { return mValues; }
+	template<std::size_t I>
+	const typename std::tuple_element<I, Values>::type &get() const
+	{
+		return std::get<I>(mValues);
+	}
+	/*
+	 * the arguments following those of the format, e.g. the tuples
+	 * following the COUNT argument of GET_PROPERTIES
+	 */
+	const std::vector<Value> &tail() const { return mTail; }
+	/* the underlying message, nullptr if status() < 0 */
+	const struct pomp_msg *msg() const { return mMsg.get(); }
+
+	/* builds the reply of a request terminated with status */
+	static Reply fromAnswer(int status, const struct pomp_msg *msg)
+	{
+		Reply reply;
+		std::vector<Value> values;
+
+		if (status == 0 && msg != nullptr)
+			return fromMessage(msg);
+		reply.mStatus = status;
+		if (msg == nullptr)
+			return reply;
+		reply.mMsg = internal::share(msg);
+
+		/* ERROR: seqnum, errno, message */
+		if (internal::decode(reply.mMsg.get(), values) == 0 &&
+				values.size() == 3 &&
+				std::holds_alternative<std::string_view>(
+						values[2]))
+			reply.mError = std::get<std::string_view>(values[2]);
+
+		return reply;
+	}
+
+	static Reply fromMessage(const struct pomp_msg *msg)
+	{
+		Reply reply;
+		std::vector<Value> values;
+
+		reply.mMsg = internal::share(msg);
+		reply.mStatus = internal::decode(reply.mMsg.get(), values);
+		if (reply.mStatus < 0)
+			return reply;
+		if (values.size() < Traits::count + 1 ||
+				!std::holds_alternative<uint32_t>(values[0]) ||
+				!internal::to_tuple(values, reply.mValues,
+				std::make_index_sequence<Traits::count>())) {
+			reply.mStatus = -EPROTO;
+			return reply;
+		}
+		reply.mSeqnum = std::get<uint32_t>(values[0]);
+		reply.mTail.assign(values.begin() + Traits::count + 1,
+				values.end());
+
+		return reply;
+	}
+
+	/* throws an Error if the request has failed */
+	const Reply &check() const
+	{
+		if (mStatus < 0)
+			throw Error(-mStatus, mError.empty() ?
+					fwd_message_str(Traits::id) :
+					std::string(mError));
+		return *this;
+	}
+
+private:
+	/* keeps the message's buffer, hence the string values, alive */
+	std::shared_ptr<struct pomp_msg> mMsg;
+	int mStatus;
+	std::string_view mError;
+	uint32_t mSeqnum;
+	Values mValues;
+	std::vector<Value> mTail;
+};
+
+template<typename Command>
+using AnswerOf = Reply<typename internal::AnswerOf<Command>::type>;
+
+#ifdef FWD_CLIENT_HAS_COROUTINES
+/* returned by Client::awaitable(), co_await-ing it sends the request */
+template<typename Answer>
+class Awaitable {
+public:
+	typedef std::function<void(std::function<void(Answer &&)>)> Sender;
+
+	explicit Awaitable(Sender &&sender) : mSender(std::move(sender)) {}
+
+	bool await_ready() const noexcept { return false; }
+
+	void await_suspend(std::coroutine_handle<> handle)
+	{
+		mSender([this, handle](Answer &&answer) {
+			mAnswer.emplace(std::move(answer));
+			handle.resume();
+		});
+	}
+
+	/* throws an Error if the request has failed */
+	Answer await_resume()
+	{
+		mAnswer->check();
+
+		return std::move(*mAnswer);
+	}
+
+private:
+	Sender mSender;
+	std::optional<Answer> mAnswer;
+};
+#endif /* FWD_CLIENT_HAS_COROUTINES */
+
+class Client {
+public:
+	/* socketPath is nullptr for FWD_CLIENT_DEFAULT_SOCKET_PATH */
+	explicit Client(const char *socketPath = nullptr) :
+		mClient(fwd_client_new(socketPath))
+	{
+		if (mClient == nullptr)
+			throw Error(errno, "fwd_client_new");
+	}
+
+	/* the requests still pending are called back with -ECANCELED */
+	~Client() { fwd_client_destroy(&mClient); }
+
+	Client(const Client &) = delete;
+	Client &operator=(const Client &) = delete;
+
+	/* the underlying C client */
+	struct fwd_client *get() const { return mClient; }
+	int fd() const { return fwd_client_get_fd(mClient); }
+	bool connected() const { return fwd_client_is_connected(mClient); }
+	unsigned pending() const { return fwd_client_get_pending(mClient); }
+	int process() { return fwd_client_process_fd(mClient); }
+	int waitAndProcess(int timeout = -1)
+	{
+		return fwd_client_wait_and_process(mClient, timeout);
+	}
+
+	/**
+	 * Sends the command Command, cb being called with its answer, of type
+	 * AnswerOf<Command>, once it's over. The arguments are those following
+	 * the sequence number in the command's format.
+	 */
+	template<typename Command, typename Callback, typename... Args>
+	void send(Callback &&cb, const Args &... args)
+	{
+		typedef AnswerOf<Command> Answer;
+		typedef typename internal::FormatTraits<Command>::Args_ Fmt;
+		int ret;
+		auto request = new Request<Answer>{std::forward<Callback>(cb)};
+
+		if constexpr (internal::check_args<Command, Args...>())
+			ret = sendArgs<Answer>(
+					internal::FormatTraits<Command>::id,
+					request,
+					static_cast<const Fmt *>(nullptr),
+					std::index_sequence_for<Args...>(),
+					args...);
+		else
+			ret = -EINVAL;
+		if (ret < 0) {
+			delete request;
+			throw Error(-ret, fwd_message_str(
+					internal::FormatTraits<Command>::id));
+		}
+	}
+
+	/**
+	 * Same as send(), the arguments being strings converted according to
+	 * the command's format, needed for the commands followed by tuples of
+	 * arguments, e.g. SET_PROPERTIES.
+	 */
+	template<typename Command, typename Callback>
+	void sendStrings(Callback &&cb, const std::vector<std::string> &args)
+	{
+		typedef AnswerOf<Command> Answer;
+		int ret;
+		std::vector<const char *> argv;
+		auto request = new Request<Answer>{std::forward<Callback>(cb)};
+
+		for (const auto &arg : args)
+			argv.push_back(arg.c_str());
+		ret = fwd_client_send_strv(mClient,
+				internal::FormatTraits<Command>::id,
+				&Client::answerCb<Answer>, request, argv.size(),
+				argv.data());
+		if (ret < 0) {
+			delete request;
+			throw Error(-ret, fwd_message_str(
+					internal::FormatTraits<Command>::id));
+		}
+	}
+
+	/* the future throws an Error if the request fails */
+	template<typename Command, typename... Args>
+	std::future<AnswerOf<Command>> request(const Args &... args)
+	{
+		auto promise = std::make_shared<
+				std::promise<AnswerOf<Command>>>();
+		auto future = promise->get_future();
+
+		send<Command>([promise](AnswerOf<Command> &&answer) {
+			fulfill(*promise, std::move(answer));
+		}, args...);
+
+		return future;
+	}
+
+	template<typename Command>
+	std::future<AnswerOf<Command>> requestStrings(
+			const std::vector<std::string> &args)
+	{
+		auto promise = std::make_shared<
+				std::promise<AnswerOf<Command>>>();
+		auto future = promise->get_future();
+
+		sendStrings<Command>([promise](AnswerOf<Command> &&answer) {
+			fulfill(*promise, std::move(answer));
+		}, args);
+
+		return future;
+	}
+
+	/**
+	 * Processes the events until future is ready, then returns its value.
+	 * @param timeout In ms, -1 to wait forever, an Error(ETIMEDOUT) is
+	 * thrown when it expires
+	 */
+	template<typename T>
+	T get(std::future<T> &future, int timeout = -1)
+	{
+		typedef std::chrono::milliseconds ms;
+		typedef std::chrono::steady_clock clock;
+		int ret;
+		auto deadline = clock::now() + ms(timeout);
+		ms left(timeout);
+
+		while (future.wait_for(std::chrono::seconds(0)) !=
+				std::future_status::ready) {
+			if (timeout >= 0) {
+				left = std::chrono::duration_cast<ms>(deadline -
+						clock::now());
+				if (left.count() <= 0)
+					throw Error(ETIMEDOUT, "fwd::Client");
+			}
+			ret = waitAndProcess(timeout >= 0 ? left.count() : -1);
+			if (ret < 0 && ret != -ETIMEDOUT)
+				throw Error(-ret, "fwd::Client");
+		}
+
+		return future.get();
+	}
+
+#ifdef FWD_CLIENT_HAS_COROUTINES
+	/* co_await client.awaitable<MsgFmtCommandPing>() */
+	template<typename Command, typename... Args>
+	Awaitable<AnswerOf<Command>> awaitable(const Args &... args)
+	{
+		internal::check_args<Command, Args...>();
+
+		return Awaitable<AnswerOf<Command>>(
+				[this, args...](auto &&cb) {
+			send<Command>(std::move(cb), args...);
+		});
+	}
+#endif /* FWD_CLIENT_HAS_COROUTINES */
+
+	/**
+	 * Sets the callback called with the Reply<Fmt> of each message of
+	 * format Fmt which doesn't terminate a request, e.g. PROPERTY_CHANGED
+	 * after a WATCH, an empty cb removes it.
+	 */
+	template<typename Fmt, typename Callback>
+	void on(Callback &&cb)
+	{
+		int ret;
+		enum fwd_message id = internal::FormatTraits<Fmt>::id;
+		std::function<void(Reply<Fmt> &&)> handler(
+				std::forward<Callback>(cb));
+
+		if (handler)
+			mHandlers[id] = [handler](const struct pomp_msg *msg) {
+				handler(Reply<Fmt>::fromMessage(msg));
+			};
+		else
+			mHandlers[id] = nullptr;
+		ret = fwd_client_set_notification_cb(mClient, id,
+				handler ? &Client::notificationCb : nullptr,
+				this);
+		if (ret < 0)
+			throw Error(-ret, "fwd_client_set_notification_cb");
+	}
+
+private:
+	template<typename Answer>
+	struct Request {
+		std::function<void(Answer &&)> cb;
+	};
+
+	template<typename Answer>
+	static void fulfill(std::promise<Answer> &promise, Answer &&answer)
+	{
+		try {
+			answer.check();
+			promise.set_value(std::move(answer));
+		} catch (...) {
+			promise.set_exception(std::current_exception());
+		}
+	}
+
+	template<typename Answer, typename... Fmt, std::size_t... I,
+			typename... Args>
+	int sendArgs(enum fwd_message id, Request<Answer> *request,
+			const std::tuple<Fmt...> *, std::index_sequence<I...>,
+			const Args &... args)
+	{
+		return fwd_client_send(mClient, id, &Client::answerCb<Answer>,
+				request, internal::ArgTraits<typename
+				std::tuple_element<I, std::tuple<Fmt...>>::type>
+				::wire(args)...);
+	}
+
+	/* a callback throwing or exhausting memory terminates the program */
+	template<typename Answer>
+	static void answerCb(struct fwd_client *, int status,
+			const struct pomp_msg *msg, void *userdata) noexcept
+	{
+		std::unique_ptr<Request<Answer>> request(
+				static_cast<Request<Answer> *>(userdata));
+
+		request->cb(Answer::fromAnswer(status, msg));
+	}
+
+	static void notificationCb(struct fwd_client *,
+			const struct pomp_msg *msg, void *userdata) noexcept
+	{
+		auto self = static_cast<Client *>(userdata);
+		uint32_t id = pomp_msg_get_id(msg);
+
+		if (id < self->mHandlers.size() && self->mHandlers[id])
+			self->mHandlers[id](msg);
+	}
+
+	struct fwd_client *mClient;
+	std::array<std::function<void(const struct pomp_msg *)>,
+			FWD_MESSAGE_LAST + 1> mHandlers;
+};
+
+} /* namespace fwd */
+
+#endif /* INCLUDE_FWD_CLIENT_HPP_ */
@@ -0,0 +1,226 @@
+/**
+ * @file fwd_schema.h
+ * @brief description of the firmwared protocol, from which the message ids, the
+ * printf formats and the tables of libfwd, the C++ formats of fwd.hpp and the
+ * fwd_messages mapping file are generated
+ *
+ * Adding a message consists in appending its line to FWD_COMMANDS or
+ * FWD_ANSWERS, the ids following the order of the lines, and the types of its
+ * arguments, sequence number included, to the FWD_ARGS_* list, a message
+ * missing there fails to compile. The lines are only ever appended, for the ids
+ * the clients have been built with to stay valid, the answers following the
+ * commands, their ids are still shifted by the commands added.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef INCLUDE_FWD_SCHEMA_H_
+#define INCLUDE_FWD_SCHEMA_H_
+
+/* X(NAME, CamelCaseName, NAME of the answer acknowledging its success) */
+#define FWD_COMMANDS(X) \
+	X(ADD_PROPERTY, AddProperty, PROPERTY_ADDED) \
+	X(CHANGES_SINCE, ChangesSince, CHANGES) \
+	X(COMMANDS, Commands, COMMANDS) \
+	X(CONFIG_KEYS, ConfigKeys, CONFIG_KEYS) \
+	X(DEFINE_TEMPLATE, DefineTemplate, TEMPLATE_DEFINED) \
+	X(DROP, Drop, DROPPED) \
+	X(FOLDERS, Folders, FOLDERS) \
+	X(GET_CONFIG, GetConfig, GET_CONFIG) \
+	X(GET_PROPERTIES, GetProperties, GET_PROPERTIES) \
+	X(GET_PROPERTY, GetProperty, GET_PROPERTY) \
+	X(GROUP, Group, GROUP_DONE) \
+	X(HELP, Help, HELP) \
+	X(KILL, Kill, DEAD) \
+	X(LIST, List, LIST) \
+	X(LIST_PAGE, ListPage, LIST_PAGE) \
+	X(PING, Ping, PONG) \
+	X(PREPARE, Prepare, PREPARED) \
+	X(PROPERTIES, Properties, PROPERTIES) \
+	X(QUERY, Query, QUERY) \
+	X(QUIT, Quit, BYEBYE) \
+	X(REMOUNT, Remount, REMOUNTED) \
+	X(SET_DEADLINE, SetDeadline, DEADLINE_SET) \
+	X(SET_PROPERTIES, SetProperties, PROPERTIES_SET) \
+	X(SET_PROPERTY, SetProperty, PROPERTY_SET) \
+	X(SHOW, Show, SHOW) \
+	X(SHOW_PROPERTIES, ShowProperties, SHOW_PROPERTIES) \
+	X(START, Start, STARTED) \
+	X(STATS, Stats, STATS) \
+	X(SUBSCRIBE, Subscribe, SUBSCRIBED) \
+	X(UNWATCH, Unwatch, UNWATCHED) \
+	X(VERSION, Version, VERSION) \
+	X(WATCH, Watch, WATCHED) \
+	X(ABORT, Abort, ABORTED)
+
+/*
+ * X(NAME, CamelCaseName), the acks, then the notifications, the answers added
+ * since being appended after them
+ */
+#define FWD_ANSWERS(X) \
+	X(CHANGES, Changes) \
+	X(COMMANDS, Commands) \
+	X(CONFIG_KEYS, ConfigKeys) \
+	X(DEADLINE_SET, DeadlineSet) \
+	X(ERROR, Error) \
+	X(FOLDERS, Folders) \
+	X(GET_CONFIG, GetConfig) \
+	X(GET_PROPERTIES, GetProperties) \
+	X(GET_PROPERTY, GetProperty) \
+	X(GROUP_DONE, GroupDone) \
+	X(HELP, Help) \
+	X(LIST, List) \
+	X(LIST_PAGE, ListPage) \
+	X(PONG, Pong) \
+	X(PROPERTIES, Properties) \
+	X(PROPERTIES_SET, PropertiesSet) \
+	X(PROPERTY_ADDED, PropertyAdded) \
+	X(PROPERTY_SET, PropertySet) \
+	X(QUERY, Query) \
+	X(REMOUNTED, Remounted) \
+	X(SHOW, Show) \
+	X(SHOW_PROPERTIES, ShowProperties) \
+	X(STATS, Stats) \
+	X(SUBSCRIBED, Subscribed) \
+	X(TEMPLATE_DEFINED, TemplateDefined) \
+	X(UNWATCHED, Unwatched) \
+	X(VERSION, Version) \
+	X(WATCHED, Watched) \
+	X(BATCH, Batch) \
+	X(BYEBYE, Byebye) \
+	X(DEAD, Dead) \
+	X(DROPPED, Dropped) \
+	X(PREPARED, Prepared) \
+	X(PREPARE_PROGRESS, PrepareProgress) \
+	X(PROPERTY_CHANGED, PropertyChanged) \
+	X(STARTED, Started) \
+	X(ABORTED, Aborted)
+
+/*
+ * arguments of the messages, of types U32, I32, U64 or STR, for
+ * DEFINE_TEMPLATE, GET_PROPERTIES and SET_PROPERTIES, only the leading
+ * arguments are described, they are followed by COUNT tuples of string
+ * arguments
+ */
+#define FWD_ARGS_COMMAND_ADD_PROPERTY U32, STR, STR
+#define FWD_ARGS_COMMAND_CHANGES_SINCE U32, STR, U64
+#define FWD_ARGS_COMMAND_COMMANDS U32
+#define FWD_ARGS_COMMAND_CONFIG_KEYS U32
+#define FWD_ARGS_COMMAND_DEFINE_TEMPLATE U32, STR, STR, U32
+#define FWD_ARGS_COMMAND_DROP U32, STR, STR
+#define FWD_ARGS_COMMAND_FOLDERS U32
+#define FWD_ARGS_COMMAND_GET_CONFIG U32, STR
+#define FWD_ARGS_COMMAND_GET_PROPERTIES U32, STR, U32
+#define FWD_ARGS_COMMAND_GET_PROPERTY U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_GROUP U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_HELP U32, STR
+#define FWD_ARGS_COMMAND_KILL U32, STR
+#define FWD_ARGS_COMMAND_LIST U32, STR
+#define FWD_ARGS_COMMAND_LIST_PAGE U32, STR, STR, U32
+#define FWD_ARGS_COMMAND_PING U32
+#define FWD_ARGS_COMMAND_PREPARE U32, STR, STR
+#define FWD_ARGS_COMMAND_PROPERTIES U32, STR
+#define FWD_ARGS_COMMAND_QUERY U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_QUIT U32
+#define FWD_ARGS_COMMAND_REMOUNT U32, STR
+#define FWD_ARGS_COMMAND_SET_DEADLINE U32, U32
+#define FWD_ARGS_COMMAND_SET_PROPERTIES U32, STR, U32, U32
+#define FWD_ARGS_COMMAND_SET_PROPERTY U32, STR, STR, STR, STR
+#define FWD_ARGS_COMMAND_SHOW U32, STR, STR
+#define FWD_ARGS_COMMAND_SHOW_PROPERTIES U32, STR, STR
+#define FWD_ARGS_COMMAND_START U32, STR
+#define FWD_ARGS_COMMAND_STATS U32
+#define FWD_ARGS_COMMAND_SUBSCRIBE U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_UNWATCH U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_VERSION U32
+#define FWD_ARGS_COMMAND_WATCH U32, STR, STR, STR
+#define FWD_ARGS_COMMAND_ABORT U32, STR, STR
+
+/*
+ * for CHANGES, GET_PROPERTIES, GROUP_DONE, LIST_PAGE, PROPERTIES_SET, QUERY and
+ * SHOW_PROPERTIES, only the leading arguments are described, they are followed
+ * by COUNT tuples of arguments, for QUERY, by the column names, then the values
+ * of each row
+ */
+#define FWD_ARGS_ANSWER_CHANGES U32, STR, U64, U32, U32
+#define FWD_ARGS_ANSWER_COMMANDS U32, STR
+#define FWD_ARGS_ANSWER_CONFIG_KEYS U32, STR
+#define FWD_ARGS_ANSWER_DEADLINE_SET U32, U32
+#define FWD_ARGS_ANSWER_ERROR U32, I32, STR
+#define FWD_ARGS_ANSWER_FOLDERS U32, STR
+#define FWD_ARGS_ANSWER_GET_CONFIG U32, STR, STR
+#define FWD_ARGS_ANSWER_GET_PROPERTIES U32, STR, U32
+#define FWD_ARGS_ANSWER_GET_PROPERTY U32, STR, STR, STR, STR
+#define FWD_ARGS_ANSWER_GROUP_DONE U32, STR, STR, U32
+#define FWD_ARGS_ANSWER_HELP U32, STR, STR
+#define FWD_ARGS_ANSWER_LIST U32, STR, U32, STR
+#define FWD_ARGS_ANSWER_LIST_PAGE U32, STR, STR, U32
+#define FWD_ARGS_ANSWER_PONG U32
+#define FWD_ARGS_ANSWER_PROPERTIES U32, STR, STR
+#define FWD_ARGS_ANSWER_PROPERTIES_SET U32, STR, U32, U32
+#define FWD_ARGS_ANSWER_PROPERTY_ADDED U32, STR, STR
+#define FWD_ARGS_ANSWER_PROPERTY_SET U32, STR, STR, STR, STR
+#define FWD_ARGS_ANSWER_QUERY U32, STR, U32, U32
+#define FWD_ARGS_ANSWER_REMOUNTED U32
+#define FWD_ARGS_ANSWER_SHOW U32, STR, STR, STR, STR
+#define FWD_ARGS_ANSWER_SHOW_PROPERTIES U32, STR, STR, STR, U32
+#define FWD_ARGS_ANSWER_STATS U32, STR
+#define FWD_ARGS_ANSWER_SUBSCRIBED U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_TEMPLATE_DEFINED U32, STR, STR, U32
+#define FWD_ARGS_ANSWER_UNWATCHED U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_VERSION U32, STR
+#define FWD_ARGS_ANSWER_WATCHED U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_BATCH U32, STR, U32, STR
+#define FWD_ARGS_ANSWER_BYEBYE U32
+#define FWD_ARGS_ANSWER_DEAD U32, STR, STR
+#define FWD_ARGS_ANSWER_DROPPED U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_PREPARED U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_PREPARE_PROGRESS U32, STR, STR, STR
+#define FWD_ARGS_ANSWER_PROPERTY_CHANGED U32, STR, STR, STR, STR, STR
+#define FWD_ARGS_ANSWER_STARTED U32, STR, STR
+#define FWD_ARGS_ANSWER_ABORTED U32, STR, STR
+
+/*
+ * helpers for generating code from the schema
+ */
+
+/* number of X lines of a list, as an integer constant expression */
+#define FWD_SCHEMA_COUNT(list) ((int)sizeof("" list(FWD_SCHEMA_ONE_)) - 1)
+#define FWD_SCHEMA_ONE_(...) "."
+
+/*
+ * applies m to each of the argument types given, e.g. FWD_ARGS_ANSWER_PONG, the
+ * results being juxtaposed for FWD_SCHEMA_MAP and separated by commas for
+ * FWD_SCHEMA_LIST
+ */
+#define FWD_SCHEMA_MAP(m, ...) FWD_SCHEMA_CAT_(FWD_SCHEMA_MAP_, \
+		FWD_SCHEMA_NARGS_(__VA_ARGS__))(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST(m, ...) FWD_SCHEMA_CAT_(FWD_SCHEMA_LIST_, \
+		FWD_SCHEMA_NARGS_(__VA_ARGS__))(m, __VA_ARGS__)
+
+#define FWD_SCHEMA_CAT_(a, b) FWD_SCHEMA_CAT2_(a, b)
+#define FWD_SCHEMA_CAT2_(a, b) a##b
+#define FWD_SCHEMA_NARGS_(...) FWD_SCHEMA_NARGS2_(__VA_ARGS__, 8, 7, 6, 5, 4, \
+		3, 2, 1, 0)
+#define FWD_SCHEMA_NARGS2_(_1, _2, _3, _4, _5, _6, _7, _8, n, ...) n
+
+#define FWD_SCHEMA_MAP_1(m, t) m(t)
+#define FWD_SCHEMA_MAP_2(m, t, ...) m(t) FWD_SCHEMA_MAP_1(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_3(m, t, ...) m(t) FWD_SCHEMA_MAP_2(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_4(m, t, ...) m(t) FWD_SCHEMA_MAP_3(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_5(m, t, ...) m(t) FWD_SCHEMA_MAP_4(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_6(m, t, ...) m(t) FWD_SCHEMA_MAP_5(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_7(m, t, ...) m(t) FWD_SCHEMA_MAP_6(m, __VA_ARGS__)
+#define FWD_SCHEMA_MAP_8(m, t, ...) m(t) FWD_SCHEMA_MAP_7(m, __VA_ARGS__)
+
+#define FWD_SCHEMA_LIST_1(m, t) m(t)
+#define FWD_SCHEMA_LIST_2(m, t, ...) m(t), FWD_SCHEMA_LIST_1(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_3(m, t, ...) m(t), FWD_SCHEMA_LIST_2(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_4(m, t, ...) m(t), FWD_SCHEMA_LIST_3(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_5(m, t, ...) m(t), FWD_SCHEMA_LIST_4(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_6(m, t, ...) m(t), FWD_SCHEMA_LIST_5(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_7(m, t, ...) m(t), FWD_SCHEMA_LIST_6(m, __VA_ARGS__)
+#define FWD_SCHEMA_LIST_8(m, t, ...) m(t), FWD_SCHEMA_LIST_7(m, __VA_ARGS__)
+
+#endif /* INCLUDE_FWD_SCHEMA_H_ */
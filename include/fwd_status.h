@@ -0,0 +1,114 @@
+/**
+ * @file fwd_status.h
+ * @brief read-only status table of the entities, published by firmwared in
+ * shared memory
+ *
+ * The table is a file firmwared maps and other processes can map read-only,
+ * made of a header followed by fixed-size slots, one per entity. Each slot is
+ * protected by a sequence lock: its sequence number is odd while firmwared
+ * writes it, and is incremented again once the write is done. The readers copy
+ * the slot and retry if the sequence number was odd or has changed. Thus they
+ * never block firmwared, nor go through its event loop.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef INCLUDE_FWD_STATUS_H_
+#define INCLUDE_FWD_STATUS_H_
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define FWD_STATUS_DEFAULT_PATH "/dev/shm/firmwared.status"
+
+/* "FWDS", cleared when firmwared exits */
+#define FWD_STATUS_MAGIC 0x46574453
+#define FWD_STATUS_VERSION 1
+
+#define FWD_STATUS_FOLDER_SIZE 0x10
+#define FWD_STATUS_NAME_SIZE 0x40
+#define FWD_STATUS_SHA1_SIZE 0x29
+#define FWD_STATUS_STATE_SIZE 0x10
+#define FWD_STATUS_IP_SIZE 0x10
+#define FWD_STATUS_FIRMWARE_SIZE 0x100
+
+/*
+ * the strings are null-terminated, truncated if needed, the fields which don't
+ * make sense for an entity, e.g. the state of a firmware, are empty or 0
+ */
+struct fwd_status_entry {
+	char folder[FWD_STATUS_FOLDER_SIZE];
+	char name[FWD_STATUS_NAME_SIZE];
+	char sha1[FWD_STATUS_SHA1_SIZE];
+	char state[FWD_STATUS_STATE_SIZE];
+	int32_t pid;
+	uint32_t id;
+	/* address of the instance in its network namespace */
+	char ip[FWD_STATUS_IP_SIZE];
+	/* path of the firmware an instance has been prepared from */
+	char firmware[FWD_STATUS_FIRMWARE_SIZE];
+};
+
+struct fwd_status_slot {
+	/* odd while the slot is being written */
+	uint32_t sequence;
+	/* 0 if the slot is free */
+	uint32_t used;
+	struct fwd_status_entry entry;
+};
+
+struct fwd_status_header {
+	uint32_t magic;
+	uint32_t version;
+	/* sizeof(struct fwd_status_slot) of the writer */
+	uint32_t slot_size;
+	uint32_t nb_slots;
+	/* incremented after each change, for the readers to poll cheaply */
+	uint32_t generation;
+	/* of firmwared, a new table is created each time it's started */
+	int32_t pid;
+};
+
+struct fwd_status;
+
+/**
+ * Maps the status table read-only.
+ * @param path Path of the table, NULL for FWD_STATUS_DEFAULT_PATH
+ * @return Table, to close with fwd_status_close(), or NULL on error, with
+ * errno set, EPROTO if the file isn't a status table of a compatible version
+ */
+struct fwd_status *fwd_status_open(const char *path);
+
+unsigned fwd_status_get_nb_slots(const struct fwd_status *status);
+
+/* returns 0 if firmwared isn't running anymore */
+uint32_t fwd_status_get_generation(const struct fwd_status *status);
+
+/**
+ * Copies a consistent version of a slot.
+ * @return 0 on success, -ENOENT if the slot is free, -ESTALE if firmwared has
+ * exited, the table has then to be reopened, -EBUSY if the slot kept changing
+ * while it was read, -EINVAL if slot is out of range
+ */
+int fwd_status_read(const struct fwd_status *status, unsigned slot,
+		struct fwd_status_entry *entry);
+
+/**
+ * Copies the entries of all the used slots, each of them being consistent.
+ * @param entries Array of at least fwd_status_get_nb_slots() entries
+ * @return number of entries copied, or a negative errno value on error, as for
+ * fwd_status_read()
+ */
+int fwd_status_snapshot(const struct fwd_status *status,
+		struct fwd_status_entry *entries);
+
+void fwd_status_close(struct fwd_status **status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* INCLUDE_FWD_STATUS_H_ */
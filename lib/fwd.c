@@ -8,8 +8,10 @@
  */
 #include <unistd.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include <blkid/blkid.h>
 
@@ -22,35 +24,158 @@ const char fwd_interp[] __attribute__((section(".interp"))) = FWD_INTERPRETER;
 
 #define FWD_MESSAGE_INVALID_STR "(invalid)"
 
+/* slots of the perfect hash table of the message names, a power of 2 */
+#define FWD_NAMES_SLOTS 512
+/* number of seeds tried before giving up and falling back to a linear scan */
+#define FWD_NAMES_MAX_SEEDS 0x10000
+
+#define FWD_COMMAND_NAME_(name, ...) [FWD_COMMAND_##name] = #name,
+#define FWD_ANSWER_NAME_(name, ...) [FWD_ANSWER_##name] = #name,
+
+static const char * const fwd_message_names[FWD_MESSAGE_LAST + 1] = {
+		FWD_COMMANDS(FWD_COMMAND_NAME_)
+		FWD_ANSWERS(FWD_ANSWER_NAME_)
+};
+
+#define FWD_COMMAND_FORMAT_(name, ...) \
+		[FWD_COMMAND_##name] = FWD_FORMAT(COMMAND_##name),
+#define FWD_ANSWER_FORMAT_(name, ...) \
+		[FWD_ANSWER_##name] = FWD_FORMAT(ANSWER_##name),
+
+static const char * const fwd_message_formats[FWD_MESSAGE_LAST + 1] = {
+		FWD_COMMANDS(FWD_COMMAND_FORMAT_)
+		FWD_ANSWERS(FWD_ANSWER_FORMAT_)
+};
+
+/* types of the arguments, as written in the fwd_messages mapping file */
+#define FWD_TYPE_NAME_(type) FWD_TYPE_NAME_##type
+#define FWD_TYPE_NAME_U32 " u32"
+#define FWD_TYPE_NAME_I32 " i32"
+#define FWD_TYPE_NAME_U64 " u64"
+#define FWD_TYPE_NAME_STR " str"
+
+#define FWD_COMMAND_TYPES_(name, ...) [FWD_COMMAND_##name] = \
+		FWD_SCHEMA_MAP(FWD_TYPE_NAME_, FWD_ARGS_COMMAND_##name),
+#define FWD_ANSWER_TYPES_(name, ...) [FWD_ANSWER_##name] = \
+		FWD_SCHEMA_MAP(FWD_TYPE_NAME_, FWD_ARGS_ANSWER_##name),
+
+static const char * const fwd_message_types[FWD_MESSAGE_LAST + 1] = {
+		FWD_COMMANDS(FWD_COMMAND_TYPES_)
+		FWD_ANSWERS(FWD_ANSWER_TYPES_)
+};
+
+#define FWD_COMMAND_ANSWER_(name, camel_case_name, answer) \
+		[FWD_COMMAND_##name] = FWD_ANSWER_##answer,
+
 /*
  * associates with a command, the answer indicating it has completed
  * successfully
- * @note this array passes through a sed command to generate the corresponding
- * mapping for the fdc shell script, so, changes to it's layout must be thought
- * of carefully and precisely reflected in the fdc.answers generation command
  */
 static const enum fwd_message fwd_command_answer_pair[] = {
-		[FWD_COMMAND_ADD_PROPERTY] = FWD_ANSWER_PROPERTY_ADDED,
-		[FWD_COMMAND_COMMANDS] =     FWD_ANSWER_COMMANDS,
-		[FWD_COMMAND_CONFIG_KEYS] =  FWD_ANSWER_CONFIG_KEYS,
-		[FWD_COMMAND_DROP] =         FWD_ANSWER_DROPPED,
-		[FWD_COMMAND_FOLDERS] =      FWD_ANSWER_FOLDERS,
-		[FWD_COMMAND_GET_CONFIG] =   FWD_ANSWER_GET_CONFIG,
-		[FWD_COMMAND_GET_PROPERTY] = FWD_ANSWER_GET_PROPERTY,
-		[FWD_COMMAND_HELP] =         FWD_ANSWER_HELP,
-		[FWD_COMMAND_KILL] =         FWD_ANSWER_DEAD,
-		[FWD_COMMAND_LIST] =         FWD_ANSWER_LIST,
-		[FWD_COMMAND_PING] =         FWD_ANSWER_PONG,
-		[FWD_COMMAND_PREPARE] =      FWD_ANSWER_PREPARED,
-		[FWD_COMMAND_PROPERTIES] =   FWD_ANSWER_PROPERTIES,
-		[FWD_COMMAND_QUIT] =         FWD_ANSWER_BYEBYE,
-		[FWD_COMMAND_REMOUNT] =      FWD_ANSWER_REMOUNTED,
-		[FWD_COMMAND_SET_PROPERTY] = FWD_ANSWER_PROPERTY_SET,
-		[FWD_COMMAND_SHOW] =         FWD_ANSWER_SHOW,
-		[FWD_COMMAND_START] =        FWD_ANSWER_STARTED,
-		[FWD_COMMAND_VERSION] =      FWD_ANSWER_VERSION,
+		FWD_COMMANDS(FWD_COMMAND_ANSWER_)
 };
 
+struct fwd_names_slot {
+	/* first message of this name, i.e. the command if there is one */
+	uint8_t message;
+	/* answer of this name, if any */
+	uint8_t answer;
+};
+
+static struct {
+	bool perfect;
+	uint32_t seed;
+	struct fwd_names_slot slots[FWD_NAMES_SLOTS];
+} fwd_names;
+
+static pthread_once_t fwd_names_once = PTHREAD_ONCE_INIT;
+
+/* FNV-1a, the seed perturbing the offset basis */
+static uint32_t fwd_names_hash(uint32_t seed, const char *str)
+{
+	uint32_t hash = 2166136261u ^ seed;
+
+	while (*str != '\0') {
+		hash ^= (uint8_t)*str++;
+		hash *= 16777619u;
+	}
+
+	return hash % FWD_NAMES_SLOTS;
+}
+
+/* returns false if two different names collide with this seed */
+static bool fwd_names_fill(uint32_t seed)
+{
+	enum fwd_message m;
+	struct fwd_names_slot *slot;
+
+	memset(fwd_names.slots, 0, sizeof(fwd_names.slots));
+	for (m = FWD_MESSAGE_FIRST; m <= FWD_MESSAGE_LAST; m++) {
+		slot = fwd_names.slots + fwd_names_hash(seed,
+				fwd_message_names[m]);
+		if (slot->message == FWD_MESSAGE_INVALID)
+			slot->message = m;
+		else if (!ut_string_match(fwd_message_names[slot->message],
+				fwd_message_names[m]))
+			return false;
+		if (m >= FWD_ANSWER_FIRST)
+			slot->answer = m;
+	}
+	fwd_names.seed = seed;
+
+	return true;
+}
+
+/*
+ * searches a seed for which the names don't collide, with 512 slots for less
+ * than 70 names, around 1 seed in 20 is good
+ */
+static void fwd_names_init(void)
+{
+	uint32_t seed;
+
+	for (seed = 0; seed < FWD_NAMES_MAX_SEEDS; seed++) {
+		if (fwd_names_fill(seed)) {
+			fwd_names.perfect = true;
+			return;
+		}
+	}
+}
+
+static struct fwd_names_slot fwd_names_find(const char *str)
+{
+	struct fwd_names_slot slot = {
+		.message = FWD_MESSAGE_INVALID,
+		.answer = FWD_MESSAGE_INVALID,
+	};
+	enum fwd_message m;
+
+	if (str == NULL)
+		return slot;
+
+	pthread_once(&fwd_names_once, fwd_names_init);
+	if (fwd_names.perfect) {
+		slot = fwd_names.slots[fwd_names_hash(fwd_names.seed, str)];
+		if (slot.message != FWD_MESSAGE_INVALID &&
+				ut_string_match(fwd_message_names[slot.message],
+						str))
+			return slot;
+		slot.message = slot.answer = FWD_MESSAGE_INVALID;
+		return slot;
+	}
+
+	/* only if the hash function became unsuitable for the schema */
+	for (m = FWD_MESSAGE_LAST; m >= FWD_MESSAGE_FIRST; m--) {
+		if (!ut_string_match(fwd_message_names[m], str))
+			continue;
+		slot.message = m;
+		if (m >= FWD_ANSWER_FIRST)
+			slot.answer = m;
+	}
+
+	return slot;
+}
+
 static void free_blkid_probe(blkid_probe *pr)
 {
 	if (pr == NULL || *pr == NULL)
@@ -61,205 +186,33 @@ static void free_blkid_probe(blkid_probe *pr)
 
 const char *fwd_message_str(enum fwd_message message)
 {
-	switch (message) {
-	/* commands, i.e. from client to server */
-	case FWD_COMMAND_ADD_PROPERTY:
-		return "ADD_PROPERTY";
-	case FWD_COMMAND_COMMANDS:
-		return "COMMANDS";
-	case FWD_COMMAND_CONFIG_KEYS:
-		return "CONFIG_KEYS";
-	case FWD_COMMAND_DROP:
-		return "DROP";
-	case FWD_COMMAND_FOLDERS:
-		return "FOLDERS";
-	case FWD_COMMAND_GET_CONFIG:
-		return "GET_CONFIG";
-	case FWD_COMMAND_GET_PROPERTY:
-		return "GET_PROPERTY";
-	case FWD_COMMAND_HELP:
-		return "HELP";
-	case FWD_COMMAND_KILL:
-		return "KILL";
-	case FWD_COMMAND_LIST:
-		return "LIST";
-	case FWD_COMMAND_PING:
-		return "PING";
-	case FWD_COMMAND_PREPARE:
-		return "PREPARE";
-	case FWD_COMMAND_PROPERTIES:
-		return "PROPERTIES";
-	case FWD_COMMAND_QUIT:
-		return "QUIT";
-	case FWD_COMMAND_REMOUNT:
-		return "REMOUNT";
-	case FWD_COMMAND_SET_PROPERTY:
-		return "SET_PROPERTY";
-	case FWD_COMMAND_SHOW:
-		return "SHOW";
-	case FWD_COMMAND_START:
-		return "START";
-	case FWD_COMMAND_VERSION:
-		return "VERSION";
-	/* answers, i.e. from server to client */
-	/* acks */
-	case FWD_ANSWER_COMMANDS:
-		return "COMMANDS";
-	case FWD_ANSWER_CONFIG_KEYS:
-		return "CONFIG_KEYS";
-	case FWD_ANSWER_ERROR:
-		return "ERROR";
-	case FWD_ANSWER_FOLDERS:
-		return "FOLDERS";
-	case FWD_ANSWER_GET_CONFIG:
-		return "GET_CONFIG";
-	case FWD_ANSWER_GET_PROPERTY:
-		return "GET_PROPERTY";
-	case FWD_ANSWER_HELP:
-		return "HELP";
-	case FWD_ANSWER_LIST:
-		return "LIST";
-	case FWD_ANSWER_PONG:
-		return "PONG";
-	case FWD_ANSWER_PROPERTIES:
-		return "PROPERTIES";
-	case FWD_ANSWER_PROPERTY_ADDED:
-		return "PROPERTY_ADDED";
-	case FWD_ANSWER_PROPERTY_SET:
-		return "PROPERTY_SET";
-	case FWD_ANSWER_REMOUNTED:
-		return "REMOUNTED";
-	case FWD_ANSWER_SHOW:
-		return "SHOW";
-	case FWD_ANSWER_VERSION:
-		return "VERSION";
-	/* notifications */
-	case FWD_ANSWER_BYEBYE:
-		return "BYEBYE";
-	case FWD_ANSWER_DEAD:
-		return "DEAD";
-	case FWD_ANSWER_DROPPED:
-		return "DROPPED";
-	case FWD_ANSWER_PREPARED:
-		return "PREPARED";
-	case FWD_ANSWER_PREPARE_PROGRESS:
-		return "PREPARE_PROGRESS";
-	case FWD_ANSWER_STARTED:
-		return "STARTED";
-
-	default:
+	if (message < FWD_MESSAGE_FIRST || message > FWD_MESSAGE_LAST)
 		return FWD_MESSAGE_INVALID_STR;
-	}
+
+	return fwd_message_names[message];
 }
 
 const char *fwd_message_format(enum fwd_message message)
 {
-	switch (message) {
-	/* commands, i.e. from client to server */
-	case FWD_COMMAND_ADD_PROPERTY:
-		return FWD_FORMAT_COMMAND_ADD_PROPERTY;
-	case FWD_COMMAND_COMMANDS:
-		return FWD_FORMAT_COMMAND_COMMANDS;
-	case FWD_COMMAND_CONFIG_KEYS:
-		return FWD_FORMAT_COMMAND_CONFIG_KEYS;
-	case FWD_COMMAND_DROP:
-		return FWD_FORMAT_COMMAND_DROP;
-	case FWD_COMMAND_FOLDERS:
-		return FWD_FORMAT_COMMAND_FOLDERS;
-	case FWD_COMMAND_GET_CONFIG:
-		return FWD_FORMAT_COMMAND_GET_CONFIG;
-	case FWD_COMMAND_GET_PROPERTY:
-		return FWD_FORMAT_COMMAND_GET_PROPERTY;
-	case FWD_COMMAND_HELP:
-		return FWD_FORMAT_COMMAND_HELP;
-	case FWD_COMMAND_KILL:
-		return FWD_FORMAT_COMMAND_KILL;
-	case FWD_COMMAND_LIST:
-		return FWD_FORMAT_COMMAND_LIST;
-	case FWD_COMMAND_PING:
-		return FWD_FORMAT_COMMAND_PING;
-	case FWD_COMMAND_PREPARE:
-		return FWD_FORMAT_COMMAND_PREPARE;
-	case FWD_COMMAND_PROPERTIES:
-		return FWD_FORMAT_COMMAND_PROPERTIES;
-	case FWD_COMMAND_QUIT:
-		return FWD_FORMAT_COMMAND_QUIT;
-	case FWD_COMMAND_REMOUNT:
-		return FWD_FORMAT_COMMAND_REMOUNT;
-	case FWD_COMMAND_SET_PROPERTY:
-		return FWD_FORMAT_COMMAND_SET_PROPERTY;
-	case FWD_COMMAND_SHOW:
-		return FWD_FORMAT_COMMAND_SHOW;
-	case FWD_COMMAND_START:
-		return FWD_FORMAT_COMMAND_START;
-	case FWD_COMMAND_VERSION:
-		return FWD_FORMAT_COMMAND_VERSION;
-	/* answers, i.e. from server to client */
-	/* acks */
-	case FWD_ANSWER_COMMANDS:
-		return FWD_FORMAT_ANSWER_COMMANDS;
-	case FWD_ANSWER_CONFIG_KEYS:
-		return FWD_FORMAT_ANSWER_CONFIG_KEYS;
-	case FWD_ANSWER_ERROR:
-		return FWD_FORMAT_ANSWER_ERROR;
-	case FWD_ANSWER_FOLDERS:
-		return FWD_FORMAT_ANSWER_FOLDERS;
-	case FWD_ANSWER_GET_CONFIG:
-		return FWD_FORMAT_ANSWER_GET_CONFIG;
-	case FWD_ANSWER_GET_PROPERTY:
-		return FWD_FORMAT_ANSWER_GET_PROPERTY;
-	case FWD_ANSWER_HELP:
-		return FWD_FORMAT_ANSWER_HELP;
-	case FWD_ANSWER_LIST:
-		return FWD_FORMAT_ANSWER_LIST;
-	case FWD_ANSWER_PONG:
-		return FWD_FORMAT_ANSWER_PONG;
-	case FWD_ANSWER_PROPERTIES:
-		return FWD_FORMAT_ANSWER_PROPERTIES;
-	case FWD_ANSWER_PROPERTY_ADDED:
-		return FWD_FORMAT_ANSWER_PROPERTY_ADDED;
-	case FWD_ANSWER_PROPERTY_SET:
-		return FWD_FORMAT_ANSWER_PROPERTY_SET;
-	case FWD_ANSWER_REMOUNTED:
-		return FWD_FORMAT_ANSWER_REMOUNTED;
-	case FWD_ANSWER_SHOW:
-		return FWD_FORMAT_ANSWER_SHOW;
-	case FWD_ANSWER_VERSION:
-		return FWD_FORMAT_ANSWER_VERSION;
-	/* notifications */
-	case FWD_ANSWER_BYEBYE:
-		return FWD_FORMAT_ANSWER_BYEBYE;
-	case FWD_ANSWER_DEAD:
-		return FWD_FORMAT_ANSWER_DEAD;
-	case FWD_ANSWER_DROPPED:
-		return FWD_FORMAT_ANSWER_DROPPED;
-	case FWD_ANSWER_PREPARED:
-		return FWD_FORMAT_ANSWER_PREPARED;
-	case FWD_ANSWER_PREPARE_PROGRESS:
-		return FWD_FORMAT_ANSWER_PREPARE_PROGRESS;
-	case FWD_ANSWER_STARTED:
-		return FWD_FORMAT_ANSWER_STARTED;
-
-	default:
+	if (message < FWD_MESSAGE_FIRST || message > FWD_MESSAGE_LAST)
 		return FWD_FORMAT_INVALID;
-	}
+
+	return fwd_message_formats[message];
 }
 
 enum fwd_message fwd_message_from_str(const char *str)
 {
-	enum fwd_message m;
-
-	for (m = FWD_MESSAGE_FIRST; m < FWD_MESSAGE_LAST; m++)
-		if (ut_string_match(fwd_message_str(m), str))
-			return m;
+	return fwd_names_find(str).message;
+}
 
-	return FWD_MESSAGE_INVALID;
+enum fwd_message fwd_answer_from_str(const char *str)
+{
+	return fwd_names_find(str).answer;
 }
 
 bool fwd_message_is_invalid(enum fwd_message message)
 {
-	return ut_string_match(fwd_message_str(message),
-			FWD_MESSAGE_INVALID_STR);
+	return message < FWD_MESSAGE_FIRST || message > FWD_MESSAGE_LAST;
 }
 
 enum fwd_message fwd_message_command_answer(enum fwd_message command)
@@ -293,12 +246,35 @@ char *fwd_read_uuid(const char *path)
 	return strdup(uuid);
 }
 
+/*
+ * outputs the fwd_messages mapping file, allowing clients to know the ids and
+ * the arguments of the messages without executing libfwd.so
+ */
+static void print_messages(void)
+{
+	enum fwd_message m;
+
+	puts("# firmwared messages, from LIBFWD_GET_MESSAGES= libfwd.so\n"
+			"# ID KIND NAME ANSWER_ID ARGUMENT_TYPES...");
+	for (m = FWD_MESSAGE_FIRST; m <= FWD_MESSAGE_LAST; m++)
+		printf("%d %s %s %d%s\n", m,
+				m <= FWD_COMMAND_LAST ? "command" : "answer",
+				fwd_message_names[m],
+				m <= FWD_COMMAND_LAST ?
+						fwd_command_answer_pair[m] :
+						FWD_MESSAGE_INVALID,
+				fwd_message_types[m]);
+}
+
 const char libfwd_usage[] = "usage: [LIBFWD_GET_ANSWER_ID=] "
 		"LIBFWD_MESSAGE=MESSAGE_NAME libfwd.so\n"
 		"\tIf LIBFWD_GET_ANSWER_ID is defined, outputs the answer id a "
 		"client must wait for, in order to know if the command "
 		"MESSAGE_NAME was successful, otherwise, outputs the command's "
-		"id.";
+		"id.\n"
+		"usage: LIBFWD_GET_MESSAGES= libfwd.so\n"
+		"\tOutputs the ids, names and argument types of all the "
+		"messages, as installed in usr/share/firmwared/fwd_messages.";
 
 void libfwd_main(void)
 {
@@ -313,7 +289,9 @@ void libfwd_main(void)
 		_exit(EXIT_SUCCESS);
 	}
 
-	if (getenv("LIBFWD_GET_MESSAGE_FORMAT") != NULL) {
+	if (getenv("LIBFWD_GET_MESSAGES") != NULL) {
+		print_messages();
+	} else if (getenv("LIBFWD_GET_MESSAGE_FORMAT") != NULL) {
 		puts(fwd_message_format(message));
 	} else {
 		if (getenv("LIBFWD_GET_ANSWER_ID") != NULL)
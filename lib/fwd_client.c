@@ -0,0 +1,684 @@
+/**
+ * @file fwd_client.c
+ * @brief asynchronous client of firmwared
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <sys/socket.h>
+#include <sys/un.h>
+
+#include <netdb.h>
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rs_dll.h>
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#include <fwd_client.h>
+
+struct fwd_request {
+	struct rs_node node;
+	uint32_t seqnum;
+	/* answer terminating the request, besides ERROR */
+	enum fwd_message answer;
+	/* kept until the request is sent */
+	struct pomp_msg *msg;
+	fwd_client_answer_cb cb;
+	void *userdata;
+};
+
+struct fwd_notification_handler {
+	fwd_client_notification_cb cb;
+	void *userdata;
+};
+
+struct fwd_client {
+	struct pomp_ctx *pomp;
+	bool connected;
+	uint32_t seqnum;
+	/* requests sent, waiting for their answer */
+	struct rs_dll requests;
+	/* requests waiting for the connection to be established */
+	struct rs_dll queue;
+	fwd_client_connection_cb connection_cb;
+	void *connection_userdata;
+	/* indexed by message id, FWD_MESSAGE_INVALID's is the default one */
+	struct fwd_notification_handler handlers[FWD_MESSAGE_LAST + 1];
+};
+
+static struct fwd_request *to_request(struct rs_node *node)
+{
+	return ut_container_of(node, struct fwd_request, node);
+}
+
+static void request_destroy(struct fwd_request **request)
+{
+	struct fwd_request *r = *request;
+
+	if (r == NULL)
+		return;
+
+	if (r->msg != NULL)
+		pomp_msg_destroy(r->msg);
+	memset(r, 0, sizeof(*r));
+	free(r);
+	*request = NULL;
+}
+
+/* the request must have been removed from its list */
+static void request_complete(struct fwd_client *client,
+		struct fwd_request *request, int status,
+		const struct pomp_msg *msg)
+{
+	request->cb(client, status, msg, request->userdata);
+	request_destroy(&request);
+}
+
+/* completes all the requests of the list, with msg NULL */
+static void requests_fail(struct fwd_client *client, struct rs_dll *requests,
+		int status)
+{
+	struct rs_node *node;
+
+	while ((node = rs_dll_next_from(requests, NULL)) != NULL) {
+		rs_dll_remove(requests, node);
+		request_complete(client, to_request(node), status, NULL);
+	}
+}
+
+/* UINT32_MAX is the sequence number of the unsolicited notifications */
+static uint32_t next_seqnum(struct fwd_client *client)
+{
+	client->seqnum++;
+	if (client->seqnum == UINT32_MAX)
+		client->seqnum = 0;
+
+	return client->seqnum;
+}
+
+static int request_send(struct fwd_client *client, struct fwd_request *request)
+{
+	int ret;
+
+	ret = pomp_ctx_send_msg(client->pomp, request->msg);
+	if (ret < 0)
+		return ret;
+	pomp_msg_destroy(request->msg);
+	request->msg = NULL;
+
+	return 0;
+}
+
+/* sends the requests queued, in order, until one fails */
+static void queue_flush(struct fwd_client *client)
+{
+	int ret;
+	struct rs_node *node;
+
+	while (client->connected &&
+			(node = rs_dll_next_from(&client->queue, NULL)) != NULL) {
+		ret = request_send(client, to_request(node));
+		if (ret < 0)
+			return;
+		rs_dll_remove(&client->queue, node);
+		rs_dll_enqueue(&client->requests, node);
+	}
+}
+
+static struct fwd_request *find_request(struct fwd_client *client,
+		uint32_t seqnum)
+{
+	struct rs_node *node = NULL;
+
+	while ((node = rs_dll_next_from(&client->requests, node)) != NULL)
+		if (to_request(node)->seqnum == seqnum)
+			return to_request(node);
+
+	return NULL;
+}
+
+static void notify(struct fwd_client *client, const struct pomp_msg *msg)
+{
+	enum fwd_message id = pomp_msg_get_id(msg);
+	struct fwd_notification_handler *handler;
+
+	if (fwd_message_is_invalid(id) || client->handlers[id].cb == NULL)
+		id = FWD_MESSAGE_INVALID;
+	handler = client->handlers + id;
+	if (handler->cb != NULL)
+		handler->cb(client, msg, handler->userdata);
+}
+
+static void process_message(struct fwd_client *client,
+		const struct pomp_msg *msg)
+{
+	int ret;
+	enum fwd_message id = pomp_msg_get_id(msg);
+	uint32_t seqnum;
+	int32_t error = 0;
+	struct fwd_request *request;
+
+	ret = pomp_msg_read(msg, "%"PRIu32, &seqnum);
+	if (ret < 0)
+		goto notify;
+	request = find_request(client, seqnum);
+	if (request == NULL ||
+			(id != request->answer && id != FWD_ANSWER_ERROR))
+		goto notify;
+
+	if (id == FWD_ANSWER_ERROR) {
+		ret = pomp_msg_read(msg, "%"PRIu32"%"PRIi32, &seqnum, &error);
+		if (ret < 0 || error <= 0)
+			error = EIO;
+	}
+	rs_dll_remove(&client->requests, &request->node);
+	request_complete(client, request, -error, msg);
+
+	return;
+notify:
+	notify(client, msg);
+}
+
+static void event_cb(struct pomp_ctx *ctx, enum pomp_event event,
+		struct pomp_conn *conn, const struct pomp_msg *msg,
+		void *userdata)
+{
+	struct fwd_client *client = userdata;
+
+	switch (event) {
+	case POMP_EVENT_CONNECTED:
+		client->connected = true;
+		queue_flush(client);
+		break;
+	case POMP_EVENT_DISCONNECTED:
+		client->connected = false;
+		/* the new connection won't know about the commands sent */
+		requests_fail(client, &client->requests, -ECONNRESET);
+		break;
+	case POMP_EVENT_MSG:
+		process_message(client, msg);
+		return;
+	}
+
+	if (client->connection_cb != NULL)
+		client->connection_cb(client, client->connected,
+				client->connection_userdata);
+}
+
+/* address is HOST:PORT, an IPv6 HOST being enclosed in brackets */
+static int parse_tcp_address(const char *address,
+		struct sockaddr_storage *addr, size_t *len)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *host = NULL;
+	const char *port;
+	size_t host_len;
+	struct addrinfo *res;
+	struct addrinfo hints = {
+		.ai_family = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+		.ai_flags = AI_NUMERICSERV,
+	};
+
+	port = strrchr(address, ':');
+	if (port == NULL || port == address || port[1] == '\0')
+		return -EINVAL;
+	host_len = port - address;
+	if (host_len >= 2 && address[0] == '[' &&
+			address[host_len - 1] == ']') {
+		address++;
+		host_len -= 2;
+	}
+	host = strndup(address, host_len);
+	if (host == NULL)
+		return -errno;
+
+	ret = getaddrinfo(host, port + 1, &hints, &res);
+	if (ret != 0)
+		return ret == EAI_SYSTEM ? -errno : -EINVAL;
+	memcpy(addr, res->ai_addr, res->ai_addrlen);
+	*len = res->ai_addrlen;
+	freeaddrinfo(res);
+
+	return 0;
+}
+
+static int parse_address(const char *address, struct sockaddr_storage *addr,
+		size_t *len)
+{
+	struct sockaddr_un *addr_un = (struct sockaddr_un *)addr;
+
+	memset(addr, 0, sizeof(*addr));
+	if (strncmp(address, "tcp:", 4) == 0)
+		return parse_tcp_address(address + 4, addr, len);
+	if (strncmp(address, "unix:", 5) == 0)
+		address += 5;
+	if (strlen(address) >= sizeof(addr_un->sun_path))
+		return -ENAMETOOLONG;
+	addr_un->sun_family = AF_UNIX;
+	strcpy(addr_un->sun_path, address);
+	*len = sizeof(*addr_un);
+
+	return 0;
+}
+
+struct fwd_client *fwd_client_new(const char *socket_path)
+{
+	int ret;
+	struct fwd_client *client;
+	struct sockaddr_storage addr;
+	size_t len;
+
+	if (socket_path == NULL)
+		socket_path = FWD_CLIENT_DEFAULT_SOCKET_PATH;
+	ret = parse_address(socket_path, &addr, &len);
+	if (ret < 0) {
+		errno = -ret;
+		return NULL;
+	}
+
+	client = calloc(1, sizeof(*client));
+	if (client == NULL)
+		return NULL;
+	rs_dll_init(&client->requests, NULL);
+	rs_dll_init(&client->queue, NULL);
+	/* limits the collisions with the sequence numbers of other clients */
+	client->seqnum = (uint32_t)getpid() << 12;
+	client->pomp = pomp_ctx_new(event_cb, client);
+	if (client->pomp == NULL) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	/* the connection is asynchronous and retried until it succeeds */
+	ret = pomp_ctx_connect(client->pomp, (const struct sockaddr *)&addr,
+			len);
+	if (ret < 0)
+		goto err;
+
+	return client;
+err:
+	fwd_client_destroy(&client);
+	errno = -ret;
+
+	return NULL;
+}
+
+/*
+ * creates a request whose message starts with its sequence number, enc being
+ * initialized to write the following arguments
+ */
+static struct fwd_request *request_new(struct fwd_client *client,
+		enum fwd_message command, fwd_client_answer_cb cb,
+		void *userdata, struct pomp_encoder *enc)
+{
+	int ret;
+	struct fwd_request *request;
+
+	if (client == NULL || cb == NULL || fwd_message_is_invalid(command) ||
+			command > FWD_COMMAND_LAST) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	request = calloc(1, sizeof(*request));
+	if (request == NULL)
+		return NULL;
+	request->seqnum = next_seqnum(client);
+	request->answer = fwd_message_command_answer(command);
+	request->cb = cb;
+	request->userdata = userdata;
+	request->msg = pomp_msg_new();
+	if (request->msg == NULL) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	ret = pomp_msg_init(request->msg, command);
+	if (ret < 0)
+		goto err;
+	ret = pomp_encoder_init(enc, request->msg);
+	if (ret < 0)
+		goto err;
+	ret = pomp_encoder_write_u32(enc, request->seqnum);
+	if (ret < 0)
+		goto err;
+
+	return request;
+err:
+	request_destroy(&request);
+	errno = -ret;
+
+	return NULL;
+}
+
+/* sends the request, or queues it if it can't be sent yet */
+static int request_submit(struct fwd_client *client,
+		struct fwd_request **request)
+{
+	int ret;
+	struct fwd_request *r = *request;
+
+	ret = pomp_msg_finish(r->msg);
+	if (ret < 0)
+		return ret;
+
+	/* the order of the commands is kept */
+	if (client->connected && rs_dll_get_count(&client->queue) == 0 &&
+			request_send(client, r) == 0)
+		rs_dll_enqueue(&client->requests, &r->node);
+	else
+		rs_dll_enqueue(&client->queue, &r->node);
+	*request = NULL;
+
+	return 0;
+}
+
+static void pomp_encoder_destroy_p(struct pomp_encoder **enc)
+{
+	if (*enc != NULL)
+		pomp_encoder_destroy(*enc);
+	*enc = NULL;
+}
+
+int fwd_client_sendv(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, const char *fmt,
+		va_list args)
+{
+	int ret;
+	struct fwd_request *request;
+	struct pomp_encoder __attribute__((cleanup(pomp_encoder_destroy_p)))
+			*enc = NULL;
+
+	if (fmt == NULL)
+		return -EINVAL;
+
+	enc = pomp_encoder_new();
+	if (enc == NULL)
+		return -ENOMEM;
+	request = request_new(client, command, cb, userdata, enc);
+	if (request == NULL)
+		return -errno;
+	ret = pomp_encoder_writev(enc, fmt, args);
+	if (ret == 0)
+		ret = request_submit(client, &request);
+	request_destroy(&request);
+
+	return ret;
+}
+
+/*
+ * returns the next conversion of a libfwd format, 'u', 'i', 's', or 'U' for a
+ * 64 bits unsigned, '\0' at its end
+ */
+static char next_conversion(const char **format)
+{
+	const char *p;
+	bool wide = false;
+
+	p = strchr(*format, '%');
+	if (p == NULL)
+		return '\0';
+	for (p++; *p == 'l' || *p == 'h' || *p == 'm'; p++)
+		if (*p == 'l')
+			wide = true;
+	if (*p == '\0')
+		return '\0';
+	*format = p + 1;
+
+	switch (*p) {
+	case 'u':
+		return wide ? 'U' : 'u';
+	case 'd':
+	case 'i':
+		return 'i';
+	case 's':
+		return 's';
+	default:
+		return '\0';
+	}
+}
+
+static int encode_argument(struct pomp_encoder *enc, char conversion,
+		const char *arg)
+{
+	char *endptr;
+	unsigned long long ull;
+	long long ll;
+
+	if (conversion == 's' || conversion == '\0')
+		return pomp_encoder_write_str(enc, arg);
+
+	errno = 0;
+	if (conversion == 'i') {
+		ll = strtoll(arg, &endptr, 0);
+		if (errno != 0 || *arg == '\0' || *endptr != '\0' ||
+				ll < INT32_MIN || ll > INT32_MAX)
+			return -EINVAL;
+		return pomp_encoder_write_i32(enc, ll);
+	}
+	ull = strtoull(arg, &endptr, 0);
+	if (errno != 0 || *arg == '\0' || *endptr != '\0' || *arg == '-')
+		return -EINVAL;
+	if (conversion == 'U')
+		return pomp_encoder_write_u64(enc, ull);
+	if (ull > UINT32_MAX)
+		return -EINVAL;
+
+	return pomp_encoder_write_u32(enc, ull);
+}
+
+int fwd_client_send_strv(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, unsigned argc,
+		const char * const argv[])
+{
+	int ret;
+	unsigned i;
+	const char *fmt = fwd_message_format(command);
+	struct fwd_request *request;
+	struct pomp_encoder __attribute__((cleanup(pomp_encoder_destroy_p)))
+			*enc = NULL;
+
+	if (argc != 0 && argv == NULL)
+		return -EINVAL;
+	/* the sequence number is added by the client */
+	if (next_conversion(&fmt) != 'u')
+		return -EINVAL;
+	for (i = 0; i < argc; i++)
+		if (argv[i] == NULL)
+			return -EINVAL;
+
+	enc = pomp_encoder_new();
+	if (enc == NULL)
+		return -ENOMEM;
+	request = request_new(client, command, cb, userdata, enc);
+	if (request == NULL)
+		return -errno;
+	for (i = 0, ret = 0; i < argc && ret == 0; i++)
+		ret = encode_argument(enc, next_conversion(&fmt), argv[i]);
+	/* all the arguments of the format must be given */
+	if (ret == 0 && next_conversion(&fmt) != '\0')
+		ret = -EINVAL;
+	if (ret == 0)
+		ret = request_submit(client, &request);
+	request_destroy(&request);
+
+	return ret;
+}
+
+int fwd_client_send_fmt(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, const char *fmt, ...)
+{
+	int ret;
+	va_list args;
+
+	va_start(args, fmt);
+	ret = fwd_client_sendv(client, command, cb, userdata, fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+int fwd_client_send(struct fwd_client *client, enum fwd_message command,
+		fwd_client_answer_cb cb, void *userdata, ...)
+{
+	int ret;
+	va_list args;
+	const char *fmt = fwd_message_format(command);
+
+	/* the sequence number is added by the client */
+	if (!ut_string_match_prefix(fmt, "%"PRIu32))
+		return -EINVAL;
+	fmt += strlen("%"PRIu32);
+
+	va_start(args, userdata);
+	ret = fwd_client_sendv(client, command, cb, userdata, fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+bool fwd_client_msg_matches(const struct fwd_client *client,
+		const struct pomp_msg *msg, const void *userdata)
+{
+	int ret;
+	uint32_t seqnum;
+	struct rs_node *node = NULL;
+	struct fwd_request *request;
+
+	if (client == NULL || msg == NULL)
+		return false;
+
+	ret = pomp_msg_read(msg, "%"PRIu32, &seqnum);
+	if (ret < 0)
+		return false;
+	while ((node = rs_dll_next_from(&client->requests, node)) != NULL) {
+		request = to_request(node);
+		if (request->seqnum == seqnum && request->userdata == userdata)
+			return true;
+	}
+
+	return false;
+}
+
+unsigned fwd_client_cancel(struct fwd_client *client, void *userdata)
+{
+	unsigned count;
+	struct rs_dll cancelled;
+	struct rs_dll *lists[2];
+	struct rs_node *node;
+	struct rs_node *next;
+	unsigned i;
+
+	if (client == NULL)
+		return 0;
+
+	lists[0] = &client->queue;
+	lists[1] = &client->requests;
+	rs_dll_init(&cancelled, NULL);
+	for (i = 0; i < UT_ARRAY_SIZE(lists); i++) {
+		for (node = rs_dll_next_from(lists[i], NULL); node != NULL;
+				node = next) {
+			next = rs_dll_next_from(lists[i], node);
+			if (to_request(node)->userdata != userdata)
+				continue;
+			rs_dll_remove(lists[i], node);
+			rs_dll_enqueue(&cancelled, node);
+		}
+	}
+	count = rs_dll_get_count(&cancelled);
+	/* the callbacks can send or cancel other requests */
+	requests_fail(client, &cancelled, -ECANCELED);
+
+	return count;
+}
+
+int fwd_client_set_notification_cb(struct fwd_client *client,
+		enum fwd_message message, fwd_client_notification_cb cb,
+		void *userdata)
+{
+	if (client == NULL || (message != FWD_MESSAGE_INVALID &&
+			fwd_message_is_invalid(message)))
+		return -EINVAL;
+
+	client->handlers[message].cb = cb;
+	client->handlers[message].userdata = userdata;
+
+	return 0;
+}
+
+int fwd_client_set_connection_cb(struct fwd_client *client,
+		fwd_client_connection_cb cb, void *userdata)
+{
+	if (client == NULL)
+		return -EINVAL;
+
+	client->connection_cb = cb;
+	client->connection_userdata = userdata;
+
+	return 0;
+}
+
+bool fwd_client_is_connected(const struct fwd_client *client)
+{
+	return client != NULL && client->connected;
+}
+
+unsigned fwd_client_get_pending(const struct fwd_client *client)
+{
+	if (client == NULL)
+		return 0;
+
+	return rs_dll_get_count(&client->requests) +
+			rs_dll_get_count(&client->queue);
+}
+
+int fwd_client_get_fd(const struct fwd_client *client)
+{
+	if (client == NULL)
+		return -EINVAL;
+
+	return pomp_ctx_get_fd(client->pomp);
+}
+
+int fwd_client_process_fd(struct fwd_client *client)
+{
+	if (client == NULL)
+		return -EINVAL;
+
+	return pomp_ctx_process_fd(client->pomp);
+}
+
+int fwd_client_wait_and_process(struct fwd_client *client, int timeout)
+{
+	if (client == NULL)
+		return -EINVAL;
+
+	return pomp_ctx_wait_and_process(client->pomp, timeout);
+}
+
+void fwd_client_destroy(struct fwd_client **client)
+{
+	struct fwd_client *c = *client;
+
+	if (c == NULL)
+		return;
+
+	/* the user mustn't be called back by the disconnection */
+	c->connection_cb = NULL;
+	requests_fail(c, &c->queue, -ECANCELED);
+	requests_fail(c, &c->requests, -ECANCELED);
+	if (c->pomp != NULL) {
+		pomp_ctx_stop(c->pomp);
+		pomp_ctx_destroy(c->pomp);
+	}
+	memset(c, 0, sizeof(*c));
+	free(c);
+	*client = NULL;
+}
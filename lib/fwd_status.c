@@ -0,0 +1,205 @@
+/**
+ * @file fwd_status.c
+ * @brief reader of the status table published by firmwared
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include <fwd_status.h>
+
+/* a slot is rewritten at most a few times per second, retrying is cheap */
+#define FWD_STATUS_MAX_TRIES 100
+
+struct fwd_status {
+	const struct fwd_status_header *header;
+	size_t size;
+	/* copied at open, the header is rewritten when firmwared exits */
+	unsigned nb_slots;
+	size_t slot_size;
+};
+
+static const struct fwd_status_slot *get_slot(const struct fwd_status *status,
+		unsigned slot)
+{
+	const char *slots = (const char *)(status->header + 1);
+
+	return (const struct fwd_status_slot *)(slots +
+			slot * status->slot_size);
+}
+
+static bool is_stale(const struct fwd_status *status)
+{
+	return __atomic_load_n(&status->header->magic, __ATOMIC_ACQUIRE) !=
+			FWD_STATUS_MAGIC;
+}
+
+/* the writer is trusted, but a truncated string would be read out of bounds */
+static void terminate_strings(struct fwd_status_entry *entry)
+{
+	entry->folder[FWD_STATUS_FOLDER_SIZE - 1] = '\0';
+	entry->name[FWD_STATUS_NAME_SIZE - 1] = '\0';
+	entry->sha1[FWD_STATUS_SHA1_SIZE - 1] = '\0';
+	entry->state[FWD_STATUS_STATE_SIZE - 1] = '\0';
+	entry->ip[FWD_STATUS_IP_SIZE - 1] = '\0';
+	entry->firmware[FWD_STATUS_FIRMWARE_SIZE - 1] = '\0';
+}
+
+struct fwd_status *fwd_status_open(const char *path)
+{
+	int ret;
+	int fd;
+	struct stat st;
+	struct fwd_status *status;
+	const struct fwd_status_header *header;
+
+	if (path == NULL)
+		path = FWD_STATUS_DEFAULT_PATH;
+
+	fd = open(path, O_RDONLY | O_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+	ret = fstat(fd, &st);
+	if (ret == -1) {
+		ret = -errno;
+		goto err;
+	}
+	if ((size_t)st.st_size < sizeof(*header)) {
+		ret = -EPROTO;
+		goto err;
+	}
+	header = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	if (header == MAP_FAILED) {
+		ret = -errno;
+		goto err;
+	}
+	close(fd);
+	fd = -1;
+
+	if (header->magic != FWD_STATUS_MAGIC ||
+			header->version != FWD_STATUS_VERSION ||
+			header->slot_size < sizeof(struct fwd_status_slot) ||
+			(st.st_size - sizeof(*header)) / header->slot_size <
+			header->nb_slots) {
+		ret = -EPROTO;
+		goto err_unmap;
+	}
+
+	status = calloc(1, sizeof(*status));
+	if (status == NULL) {
+		ret = -errno;
+		goto err_unmap;
+	}
+	status->header = header;
+	status->size = st.st_size;
+	status->nb_slots = header->nb_slots;
+	status->slot_size = header->slot_size;
+
+	return status;
+err_unmap:
+	munmap((void *)header, st.st_size);
+err:
+	if (fd != -1)
+		close(fd);
+	errno = -ret;
+
+	return NULL;
+}
+
+unsigned fwd_status_get_nb_slots(const struct fwd_status *status)
+{
+	if (status == NULL)
+		return 0;
+
+	return status->nb_slots;
+}
+
+uint32_t fwd_status_get_generation(const struct fwd_status *status)
+{
+	if (status == NULL || is_stale(status))
+		return 0;
+
+	return __atomic_load_n(&status->header->generation, __ATOMIC_ACQUIRE);
+}
+
+int fwd_status_read(const struct fwd_status *status, unsigned slot,
+		struct fwd_status_entry *entry)
+{
+	unsigned tries;
+	uint32_t sequence;
+	uint32_t used;
+	const struct fwd_status_slot *s;
+
+	if (status == NULL || entry == NULL || slot >= status->nb_slots)
+		return -EINVAL;
+
+	s = get_slot(status, slot);
+	for (tries = 0; tries < FWD_STATUS_MAX_TRIES; tries++) {
+		if (is_stale(status))
+			return -ESTALE;
+		sequence = __atomic_load_n(&s->sequence, __ATOMIC_ACQUIRE);
+		if (sequence & 1) {
+			sched_yield();
+			continue;
+		}
+		used = __atomic_load_n(&s->used, __ATOMIC_RELAXED);
+		memcpy(entry, &s->entry, sizeof(*entry));
+		/* the copy must be done before the sequence is checked again */
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if (__atomic_load_n(&s->sequence, __ATOMIC_RELAXED) != sequence)
+			continue;
+		if (!used)
+			return -ENOENT;
+		terminate_strings(entry);
+
+		return 0;
+	}
+
+	return -EBUSY;
+}
+
+int fwd_status_snapshot(const struct fwd_status *status,
+		struct fwd_status_entry *entries)
+{
+	int ret;
+	unsigned i;
+	int count = 0;
+
+	if (status == NULL || entries == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < status->nb_slots; i++) {
+		ret = fwd_status_read(status, i, entries + count);
+		if (ret == -ENOENT)
+			continue;
+		if (ret < 0)
+			return ret;
+		count++;
+	}
+
+	return count;
+}
+
+void fwd_status_close(struct fwd_status **status)
+{
+	struct fwd_status *s = *status;
+
+	if (s == NULL)
+		return;
+
+	munmap((void *)s->header, s->size);
+	memset(s, 0, sizeof(*s));
+	free(s);
+	*status = NULL;
+}
@@ -0,0 +1,136 @@
+/**
+ * @file answer.c
+ * @brief builder for the answers whose number of arguments varies
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <string.h>
+#include <errno.h>
+
+#include "clients.h"
+#include "answer.h"
+
+int answer_init(struct answer *answer, uint32_t msgid, uint32_t seqnum)
+{
+	int ret;
+
+	if (answer == NULL)
+		return -EINVAL;
+	memset(answer, 0, sizeof(*answer));
+
+	answer->msg = pomp_msg_new();
+	answer->encoder = pomp_encoder_new();
+	if (answer->msg == NULL || answer->encoder == NULL) {
+		ret = -ENOMEM;
+		goto err;
+	}
+	ret = pomp_msg_init(answer->msg, msgid);
+	if (ret < 0)
+		goto err;
+	ret = pomp_encoder_init(answer->encoder, answer->msg);
+	if (ret < 0)
+		goto err;
+	answer_add_u32(answer, seqnum);
+
+	return answer->error;
+err:
+	answer_clean(answer);
+
+	return ret;
+}
+
+void answer_add_u32(struct answer *answer, uint32_t value)
+{
+	int ret;
+
+	if (answer->error != 0)
+		return;
+
+	ret = pomp_encoder_write_u32(answer->encoder, value);
+	if (ret < 0)
+		answer->error = ret;
+}
+
+void answer_add_i32(struct answer *answer, int32_t value)
+{
+	int ret;
+
+	if (answer->error != 0)
+		return;
+
+	ret = pomp_encoder_write_i32(answer->encoder, value);
+	if (ret < 0)
+		answer->error = ret;
+}
+
+void answer_add_u64(struct answer *answer, uint64_t value)
+{
+	int ret;
+
+	if (answer->error != 0)
+		return;
+
+	ret = pomp_encoder_write_u64(answer->encoder, value);
+	if (ret < 0)
+		answer->error = ret;
+}
+
+void answer_add_str(struct answer *answer, const char *value)
+{
+	int ret;
+
+	if (answer->error != 0)
+		return;
+
+	ret = pomp_encoder_write_str(answer->encoder, value);
+	if (ret < 0)
+		answer->error = ret;
+}
+
+int answer_send(struct answer *answer, struct pomp_conn *conn)
+{
+	int ret;
+
+	ret = answer->error;
+	if (ret < 0)
+		goto out;
+	ret = pomp_msg_finish(answer->msg);
+	if (ret < 0)
+		goto out;
+
+	ret = client_answer(conn, answer->msg);
+out:
+	answer_clean(answer);
+
+	return ret;
+}
+
+int answer_notify(struct answer *answer,
+		const struct notification_scope *scope)
+{
+	int ret;
+
+	ret = answer->error;
+	if (ret < 0)
+		goto out;
+	ret = pomp_msg_finish(answer->msg);
+	if (ret < 0)
+		goto out;
+
+	clients_notify(scope, answer->msg);
+out:
+	answer_clean(answer);
+
+	return ret;
+}
+
+void answer_clean(struct answer *answer)
+{
+	if (answer->encoder != NULL)
+		pomp_encoder_destroy(answer->encoder);
+	if (answer->msg != NULL)
+		pomp_msg_destroy(answer->msg);
+	memset(answer, 0, sizeof(*answer));
+}
@@ -0,0 +1,44 @@
+/**
+ * @file answer.h
+ * @brief builder for the answers whose number of arguments varies, e.g. a list
+ * of entities encoded as consecutive string arguments
+ *
+ * Errors are sticky, the first one is returned by answer_send(), so that the
+ * arguments can be added without checking each call.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef ANSWER_H_
+#define ANSWER_H_
+#include <stdint.h>
+
+#include <libpomp.h>
+
+#include "firmwared.h"
+
+struct answer {
+	struct pomp_msg *msg;
+	struct pomp_encoder *encoder;
+	/* first error encountered, 0 if none */
+	int error;
+};
+
+/* the sequence number is written as the first argument */
+int answer_init(struct answer *answer, uint32_t msgid, uint32_t seqnum);
+void answer_add_u32(struct answer *answer, uint32_t value);
+void answer_add_i32(struct answer *answer, int32_t value);
+void answer_add_u64(struct answer *answer, uint64_t value);
+void answer_add_str(struct answer *answer, const char *value);
+/* sends the answer to the client which issued the command and cleans it */
+int answer_send(struct answer *answer, struct pomp_conn *conn);
+/*
+ * sends the answer like firmwared_notify() does, for the commands answered once
+ * the client's connection may be gone, and cleans it
+ */
+int answer_notify(struct answer *answer,
+		const struct notification_scope *scope);
+void answer_clean(struct answer *answer);
+
+#endif /* ANSWER_H_ */
@@ -77,13 +77,14 @@ int apparmor_init(void)
 	return 0;
 }
 
-__attribute__ ((format (printf, 2, 3)))
-static int vload_profile(const char *action, const char *fmt, ...)
+/* if cb is NULL, the apparmor_parser is waited for */
+__attribute__ ((format (printf, 4, 5)))
+static int vload_profile(struct hook *hook, hook_cb cb, const char *action,
+		const char *fmt, ...)
 {
 	int ret;
 	va_list args;
 	char __attribute__((cleanup(ut_string_free)))*buf = NULL;
-	struct io_process process;
 	struct io_process_parameters prms = process_default_parameters;
 
 	va_start(args, fmt);
@@ -98,23 +99,24 @@ static int vload_profile(const char *action, const char *fmt, ...)
 
 	prms.buffer = buf;
 	prms.len = ret;
-	prms.copy = false;
-	ret = io_process_init_prepare_launch_and_wait(&process, &prms, NULL,
+	/* buf is freed on return, before an asynchronous parser reads it */
+	prms.copy = cb != NULL;
+	ret = hook_launch(hook, "apparmor_parser", &prms, cb,
 			APPARMOR_PARSER_COMMAND, action, "--quiet", NULL);
 	if (config_get_bool(CONFIG_DUMP_PROFILE))
 		fputs(buf, stderr);
-	ret = 0;
 out:
 
 	return ret;
 }
 
-int apparmor_load_profile(const char *root, const char *name)
+int apparmor_load_profile(struct hook *hook, hook_cb cb, const char *root,
+		const char *name)
 {
 	ULOGI("%s(%s, %s)", __func__, root, name);
 
-	return vload_profile("--replace", STATIC_PROFILE_PATTERN, root, name,
-			static_apparmor_profile);
+	return vload_profile(hook, cb, "--replace", STATIC_PROFILE_PATTERN,
+			root, name, static_apparmor_profile);
 }
 
 int apparmor_change_profile(const char *name)
@@ -136,11 +138,12 @@ int apparmor_change_profile(const char *name)
 	return ret;
 }
 
-int apparmor_remove_profile(const char *name)
+int apparmor_remove_profile(struct hook *hook, hook_cb cb, const char *name)
 {
 	ULOGI("%s(%s)", __func__, name);
 
-	return vload_profile("--remove", REMOVE_PROFILE_PATTERN, name);
+	return vload_profile(hook, cb, "--remove", REMOVE_PROFILE_PATTERN,
+			name);
 }
 
 void apparmor_remove_all_firmwared_profiles(void)
@@ -165,7 +168,8 @@ void apparmor_remove_all_firmwared_profiles(void)
 		needle = strchr(line, ' ');
 		if (needle != NULL)
 			*needle = '\0';
-		apparmor_remove_profile(line + PROFILE_NAME_PREFIX_LEN);
+		apparmor_remove_profile(NULL, NULL,
+				line + PROFILE_NAME_PREFIX_LEN);
 	}
 }
 
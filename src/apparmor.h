@@ -9,10 +9,17 @@
 #ifndef APPARMOR_H_
 #define APPARMOR_H_
 
+#include "process.h"
+
+/*
+ * for the functions taking a hook and a callback, if the callback is NULL, the
+ * operation is synchronous, hook can be NULL in this case
+ */
 int apparmor_init(void);
-int apparmor_load_profile(const char *root, const char *name);
+int apparmor_load_profile(struct hook *hook, hook_cb cb, const char *root,
+		const char *name);
 int apparmor_change_profile(const char *name);
-int apparmor_remove_profile(const char *name);
+int apparmor_remove_profile(struct hook *hook, hook_cb cb, const char *name);
 void apparmor_remove_all_firmwared_profiles(void);
 void apparmor_cleanup(void);
 
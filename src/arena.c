@@ -0,0 +1,166 @@
+/**
+ * @file arena.c
+ * @brief bump allocator for the temporaries of a request
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+
+#include "arena.h"
+
+/* suitable for any type */
+#define ARENA_ALIGNMENT __alignof__(long double)
+
+struct arena_chunk {
+	struct arena_chunk *next;
+	size_t size;
+	char data[] __attribute__((aligned(ARENA_ALIGNMENT)));
+};
+
+static size_t align(size_t size)
+{
+	return (size + ARENA_ALIGNMENT - 1) & ~(ARENA_ALIGNMENT - 1);
+}
+
+static size_t room(const struct arena *arena)
+{
+	if (arena->chunks == NULL)
+		return 0;
+
+	return arena->chunks->size - arena->used;
+}
+
+static int add_chunk(struct arena *arena, size_t size)
+{
+	struct arena_chunk *chunk;
+
+	if (size < ARENA_CHUNK_SIZE)
+		size = ARENA_CHUNK_SIZE;
+	chunk = malloc(sizeof(*chunk) + size);
+	if (chunk == NULL)
+		return -errno;
+	chunk->size = size;
+	chunk->next = arena->chunks;
+	arena->chunks = chunk;
+	arena->used = 0;
+
+	return 0;
+}
+
+void *arena_alloc(struct arena *arena, size_t size)
+{
+	int ret;
+	void *p;
+
+	if (arena == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	size = align(size == 0 ? 1 : size);
+	if (room(arena) < size) {
+		ret = add_chunk(arena, size);
+		if (ret < 0) {
+			errno = -ret;
+			return NULL;
+		}
+	}
+	p = arena->chunks->data + arena->used;
+	arena->used += size;
+
+	return memset(p, 0, size);
+}
+
+char *arena_strndup(struct arena *arena, const char *str, size_t n)
+{
+	char *copy;
+
+	if (str == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	n = strnlen(str, n);
+	copy = arena_alloc(arena, n + 1);
+	if (copy == NULL)
+		return NULL;
+
+	return memcpy(copy, str, n);
+}
+
+char *arena_strdup(struct arena *arena, const char *str)
+{
+	return arena_strndup(arena, str, (size_t)-1);
+}
+
+char *arena_printf(struct arena *arena, const char *fmt, ...)
+{
+	int len;
+	char *str;
+	va_list args;
+
+	if (arena == NULL || fmt == NULL) {
+		errno = EINVAL;
+		return NULL;
+	}
+
+	/* formatted in place if it fits in the current chunk */
+	va_start(args, fmt);
+	len = vsnprintf(room(arena) == 0 ? NULL :
+			arena->chunks->data + arena->used, room(arena), fmt,
+			args);
+	va_end(args);
+	if (len < 0)
+		return NULL;
+	if ((size_t)len < room(arena)) {
+		str = arena->chunks->data + arena->used;
+		arena->used += align(len + 1);
+		return str;
+	}
+
+	str = arena_alloc(arena, len + 1);
+	if (str == NULL)
+		return NULL;
+	va_start(args, fmt);
+	vsnprintf(str, len + 1, fmt, args);
+	va_end(args);
+
+	return str;
+}
+
+static void free_chunks(struct arena_chunk *chunk)
+{
+	struct arena_chunk *next;
+
+	for (; chunk != NULL; chunk = next) {
+		next = chunk->next;
+		free(chunk);
+	}
+}
+
+void arena_reset(struct arena *arena)
+{
+	if (arena == NULL || arena->chunks == NULL)
+		return;
+
+	/* the chunk in use is kept, the full ones are released */
+	free_chunks(arena->chunks->next);
+	arena->chunks->next = NULL;
+	arena->used = 0;
+}
+
+void arena_clean(struct arena *arena)
+{
+	if (arena == NULL)
+		return;
+
+	free_chunks(arena->chunks);
+	arena->chunks = NULL;
+	arena->used = 0;
+}
@@ -0,0 +1,40 @@
+/**
+ * @file arena.h
+ * @brief bump allocator for the temporaries of a request, released in one go
+ * once the request is over, instead of freeing each of them
+ *
+ * The memory is allocated by chunks, the first one being kept on reset, so
+ * that the requests of usual size don't allocate at all.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef ARENA_H_
+#define ARENA_H_
+#include <stddef.h>
+
+#ifndef ARENA_CHUNK_SIZE
+#define ARENA_CHUNK_SIZE 0x4000
+#endif /* ARENA_CHUNK_SIZE */
+
+struct arena_chunk;
+
+struct arena {
+	/* the chunk allocated from, followed by the full ones */
+	struct arena_chunk *chunks;
+	/* bytes used in the first chunk */
+	size_t used;
+};
+
+/* the memory returned is zeroed, NULL is returned on error with errno set */
+void *arena_alloc(struct arena *arena, size_t size);
+char *arena_strdup(struct arena *arena, const char *str);
+char *arena_strndup(struct arena *arena, const char *str, size_t n);
+__attribute__ ((format (printf, 2, 3)))
+char *arena_printf(struct arena *arena, const char *fmt, ...);
+/* invalidates all the memory allocated, keeps the first chunk */
+void arena_reset(struct arena *arena);
+void arena_clean(struct arena *arena);
+
+#endif /* ARENA_H_ */
@@ -0,0 +1,1088 @@
+/**
+ * @file clients.c
+ * @brief registry of the clients connected to firmwared
+ *
+ * The commands are not executed as soon as they are received, but are queued
+ * per client and executed in a round-robin fashion between the clients, one
+ * command for each client with pending commands, at each loop iteration.
+ *
+ * The notifications are sent to the client whose command triggered them, and to
+ * the clients which subscribed to them. A client which never subscribed gets
+ * all of them.
+ *
+ * The messages are only handed to libpomp when the socket has room for them,
+ * otherwise they are kept in a per-client output queue, whose size is limited
+ * in bytes and in messages. When the limits are exceeded, the policy of the
+ * class of the message queued is applied: the notifications with the same
+ * subject can be coalesced, the oldest messages dropped, or the client
+ * disconnected.
+ *
+ * The clients which subscribed to the BATCH notification receive the DEAD,
+ * DROPPED and PREPARED notifications emitted during a loop iteration grouped
+ * by type in one BATCH message, instead of one message each, so that bursts,
+ * e.g. when a lot of preparations end at once, don't flood them.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+
+#include <argz.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+
+#define ULOG_TAG firmwared_clients
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_clients);
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#include <fwd.h>
+
+#include "firmwared.h"
+#include "commands.h"
+#include "utils.h"
+#include "config.h"
+#include "folders.h"
+#include "clients.h"
+
+#define to_client(p) ut_container_of(p, struct client, node)
+#define to_queued_command(p) ut_container_of(p, struct queued_command, node)
+#define to_queued_output(p) ut_container_of(p, struct queued_output, node)
+#define to_watch(p) ut_container_of(p, struct watch, node)
+
+/* used if the size of the socket's send buffer can't be retrieved */
+#define DEFAULT_SNDBUF 0x30000
+
+struct queued_command {
+	struct rs_node node;
+	struct pomp_msg *msg;
+	struct timespec arrival;
+};
+
+#define SUBSCRIBE_ANY "*"
+
+enum output_class {
+	OUTPUT_CLASS_ACK,
+	OUTPUT_CLASS_NOTIFICATION,
+	OUTPUT_CLASS_PROGRESS,
+
+	OUTPUT_CLASS_NB,
+};
+
+enum output_policy {
+	OUTPUT_POLICY_COALESCE,
+	OUTPUT_POLICY_DROP_OLDEST,
+	OUTPUT_POLICY_DISCONNECT,
+};
+
+struct queued_output {
+	struct rs_node node;
+	struct pomp_msg *msg;
+	size_t size;
+	enum output_class class;
+	/* see struct notification_scope */
+	char *key;
+};
+
+struct watch {
+	struct rs_node node;
+	char *folder;
+	/* sha1 or name, or SUBSCRIBE_ANY */
+	char *entity;
+	/* property name, or SUBSCRIBE_ANY */
+	char *property;
+};
+
+static struct rs_dll clients;
+
+/* total number of watches, to skip looking for property changes if 0 */
+static unsigned nb_watches;
+
+static uint32_t last_id;
+
+static size_t max_output_bytes;
+static unsigned max_output_messages;
+static enum output_policy policies[OUTPUT_CLASS_NB];
+
+static struct {
+	uint64_t coalesced;
+	uint64_t dropped;
+	uint64_t disconnections;
+	size_t max_output_bytes;
+} stats;
+
+static int queued_output_destroy(struct rs_node *node)
+{
+	struct queued_output *output = to_queued_output(node);
+
+	pomp_msg_destroy(output->msg);
+	free(output->key);
+	free(output);
+
+	return 0;
+}
+
+static const struct rs_dll_vtable output_vtable = {
+	.remove = queued_output_destroy,
+};
+
+static int watch_destroy(struct rs_node *node)
+{
+	struct watch *watch = to_watch(node);
+
+	free(watch->folder);
+	free(watch->entity);
+	free(watch->property);
+	free(watch);
+	nb_watches--;
+
+	return 0;
+}
+
+static const struct rs_dll_vtable watches_vtable = {
+	.remove = watch_destroy,
+};
+
+static int queued_command_destroy(struct rs_node *node)
+{
+	struct queued_command *command = to_queued_command(node);
+
+	pomp_msg_destroy(command->msg);
+	free(command);
+
+	return 0;
+}
+
+static const struct rs_dll_vtable commands_vtable = {
+	.remove = queued_command_destroy,
+};
+
+static void batch_clean(struct notification_batch *batch)
+{
+	pomp_msg_destroy(batch->first);
+	ut_string_free(&batch->entries);
+	memset(batch, 0, sizeof(*batch));
+}
+
+static int client_destroy(struct rs_node *node)
+{
+	unsigned i;
+	struct client *client = to_client(node);
+
+	for (i = 0; i < CLIENTS_BATCH_TYPES; i++)
+		batch_clean(client->batches + i);
+	rs_dll_remove_all(&client->commands);
+	rs_dll_remove_all(&client->output);
+	rs_dll_remove_all(&client->watches);
+	free(client->folders);
+	free(client->entities);
+	free(client);
+
+	return 0;
+}
+
+static const struct rs_dll_vtable clients_vtable = {
+	.remove = client_destroy,
+};
+
+static int client_match_conn(struct rs_node *node, const void *data)
+{
+	return to_client(node)->conn == data;
+}
+
+static void command_expired(struct client *client,
+		struct queued_command *command)
+{
+	int ret;
+	uint32_t seqnum;
+
+	ret = pomp_msg_read(command->msg, "%"PRIu32, &seqnum);
+	if (ret < 0) {
+		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		return;
+	}
+	ULOGW("command %s (seqnum %"PRIu32") dropped, deadline of %"PRIu32
+			"ms expired", fwd_message_str(
+					pomp_msg_get_id(command->msg)),
+			seqnum, client->deadline);
+
+	ret = firmwared_answer(client->conn, FWD_ANSWER_ERROR,
+			FWD_FORMAT(ANSWER_ERROR), seqnum, ETIMEDOUT,
+			strerror(ETIMEDOUT));
+	if (ret < 0)
+		ULOGE("firmwared_answer: %s", strerror(-ret));
+}
+
+static void command_denied(struct client *client,
+		struct queued_command *command)
+{
+	int ret;
+	uint32_t seqnum;
+
+	ret = pomp_msg_read(command->msg, "%"PRIu32, &seqnum);
+	if (ret < 0) {
+		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		return;
+	}
+	ULOGW("command %s (seqnum %"PRIu32") of client %"PRIu32" denied, "
+			"it is read-only", fwd_message_str(
+					pomp_msg_get_id(command->msg)),
+			seqnum, client->id);
+
+	ret = firmwared_answer(client->conn, FWD_ANSWER_ERROR,
+			FWD_FORMAT(ANSWER_ERROR), seqnum, EPERM,
+			strerror(EPERM));
+	if (ret < 0)
+		ULOGE("firmwared_answer: %s", strerror(-ret));
+}
+
+static void client_process_command(struct client *client)
+{
+	int ret;
+	struct rs_node *node;
+	struct queued_command *command;
+
+	node = rs_dll_pop(&client->commands);
+	if (node == NULL)
+		return;
+	command = to_queued_command(node);
+
+	/* the deadline is read now, in case a command of the queue changed it */
+	if (client->deadline != 0 &&
+			time_elapsed_ms(&command->arrival) > client->deadline) {
+		command_expired(client, command);
+	} else if (client->read_only && !command_is_read_only(
+			pomp_msg_get_id(command->msg))) {
+		command_denied(client, command);
+	} else {
+		ret = command_invoke(client->conn, command->msg);
+		if (ret < 0)
+			ULOGE("command_invoke: %s", strerror(-ret));
+	}
+
+	queued_command_destroy(&command->node);
+}
+
+static enum output_policy get_policy(enum config_key key)
+{
+	const char *policy = config_get(key);
+
+	if (ut_string_match(policy, "coalesce"))
+		return OUTPUT_POLICY_COALESCE;
+	if (ut_string_match(policy, "drop_oldest"))
+		return OUTPUT_POLICY_DROP_OLDEST;
+
+	return OUTPUT_POLICY_DISCONNECT;
+}
+
+int clients_init(void)
+{
+	ULOGD("%s", __func__);
+
+	memset(&stats, 0, sizeof(stats));
+	max_output_bytes = config_get_int(CONFIG_MAX_OUTPUT_BYTES);
+	max_output_messages = config_get_int(CONFIG_MAX_OUTPUT_MESSAGES);
+	policies[OUTPUT_CLASS_ACK] = get_policy(CONFIG_ACK_POLICY);
+	policies[OUTPUT_CLASS_NOTIFICATION] =
+			get_policy(CONFIG_NOTIFICATION_POLICY);
+	policies[OUTPUT_CLASS_PROGRESS] = get_policy(CONFIG_PROGRESS_POLICY);
+
+	return rs_dll_init(&clients, &clients_vtable);
+}
+
+int clients_add(struct pomp_conn *conn, bool read_only)
+{
+	int ret;
+	struct client *client;
+	socklen_t len;
+
+	client = calloc(1, sizeof(*client));
+	if (client == NULL) {
+		ret = -errno;
+		ULOGE("calloc: %m");
+		return ret;
+	}
+	client->conn = conn;
+	/* skips 0 when wrapping */
+	if (++last_id == 0)
+		last_id++;
+	client->id = last_id;
+	client->read_only = read_only;
+	rs_dll_init(&client->commands, &commands_vtable);
+	rs_dll_init(&client->output, &output_vtable);
+	rs_dll_init(&client->watches, &watches_vtable);
+	len = sizeof(client->sndbuf);
+	ret = getsockopt(pomp_conn_get_fd(conn), SOL_SOCKET, SO_SNDBUF,
+			&client->sndbuf, &len);
+	if (ret < 0) {
+		ULOGW("getsockopt SO_SNDBUF: %m");
+		client->sndbuf = DEFAULT_SNDBUF;
+	}
+
+	return rs_dll_enqueue(&clients, &client->node);
+}
+
+/* the commands not executed yet are discarded */
+void clients_remove(struct pomp_conn *conn)
+{
+	struct rs_node *node;
+
+	node = rs_dll_remove_match(&clients, client_match_conn, conn);
+	if (node == NULL)
+		return;
+
+	client_destroy(node);
+}
+
+struct client *client_find(struct pomp_conn *conn)
+{
+	struct rs_node *node;
+
+	node = rs_dll_find_match(&clients, client_match_conn, conn);
+	if (node == NULL) {
+		errno = ENOENT;
+		return NULL;
+	}
+
+	return to_client(node);
+}
+
+uint32_t client_get_id(struct pomp_conn *conn)
+{
+	struct client *client;
+
+	client = client_find(conn);
+
+	return client == NULL ? 0 : client->id;
+}
+
+/* a NULL argz means anything */
+static int parse_list(const char *list, char **argz, size_t *argz_len)
+{
+	int ret;
+	char *entry = NULL;
+
+	*argz = NULL;
+	*argz_len = 0;
+	if (ut_string_match(list, SUBSCRIBE_ANY))
+		return 0;
+
+	ret = -argz_create_sep(list, ',', argz, argz_len);
+	if (ret < 0)
+		return ret;
+	if (*argz_len == 0)
+		return -EINVAL;
+	while ((entry = argz_next(*argz, *argz_len, entry)) != NULL)
+		if (*entry == '\0')
+			return -EINVAL;
+
+	return 0;
+}
+
+static int check_folders(const char *folders, size_t folders_len)
+{
+	const char *folder = NULL;
+
+	while ((folder = argz_next(folders, folders_len, folder)) != NULL)
+		if (folder_find(folder) == NULL)
+			return -errno;
+
+	return 0;
+}
+
+static int parse_notifications(const char *list,
+		bool notifications[FWD_MESSAGE_LAST + 1])
+{
+	int ret;
+	enum fwd_message id;
+	char __attribute__((cleanup(ut_string_free))) *argz = NULL;
+	size_t argz_len;
+	const char *entry = NULL;
+
+	ret = parse_list(list, &argz, &argz_len);
+	if (ret < 0)
+		return ret;
+	for (id = FWD_ANSWER_FIRST; id <= FWD_ANSWER_LAST; id++)
+		notifications[id] = argz == NULL;
+	while ((entry = argz_next(argz, argz_len, entry)) != NULL) {
+		id = fwd_answer_from_str(entry);
+		if (id == FWD_MESSAGE_INVALID)
+			return -EINVAL;
+		notifications[id] = true;
+	}
+
+	return 0;
+}
+
+int client_subscribe(struct client *client, const char *folders,
+		const char *entities, const char *notifications)
+{
+	int ret;
+	char *folders_argz = NULL;
+	size_t folders_len;
+	char *entities_argz = NULL;
+	size_t entities_len;
+	bool ids[FWD_MESSAGE_LAST + 1] = {false};
+
+	if (client == NULL || folders == NULL || entities == NULL ||
+			notifications == NULL)
+		return -EINVAL;
+
+	ret = parse_list(folders, &folders_argz, &folders_len);
+	if (ret < 0)
+		goto err;
+	ret = check_folders(folders_argz, folders_len);
+	if (ret < 0)
+		goto err;
+	ret = parse_list(entities, &entities_argz, &entities_len);
+	if (ret < 0)
+		goto err;
+	ret = parse_notifications(notifications, ids);
+	if (ret < 0)
+		goto err;
+
+	free(client->folders);
+	free(client->entities);
+	client->folders = folders_argz;
+	client->folders_len = folders_len;
+	client->entities = entities_argz;
+	client->entities_len = entities_len;
+	memcpy(client->notifications, ids, sizeof(ids));
+	client->subscribed = true;
+
+	return 0;
+err:
+	free(folders_argz);
+	free(entities_argz);
+
+	return ret;
+}
+
+static struct watch *watch_find(const struct client *client,
+		const char *folder, const char *entity, const char *property)
+{
+	struct rs_node *node = NULL;
+	struct watch *watch;
+
+	while ((node = rs_dll_next_from(&client->watches, node)) != NULL) {
+		watch = to_watch(node);
+		if (ut_string_match(watch->folder, folder) &&
+				ut_string_match(watch->entity, entity) &&
+				ut_string_match(watch->property, property))
+			return watch;
+	}
+
+	return NULL;
+}
+
+int client_watch(struct client *client, const char *folder,
+		const char *entity, const char *property)
+{
+	struct watch *watch;
+
+	if (client == NULL || ut_string_is_invalid(folder) ||
+			ut_string_is_invalid(entity) ||
+			ut_string_is_invalid(property))
+		return -EINVAL;
+	if (folder_find(folder) == NULL)
+		return -errno;
+	if (watch_find(client, folder, entity, property) != NULL)
+		return 0;
+	if (rs_dll_get_count(&client->watches) >= CLIENTS_MAX_WATCHES)
+		return -E2BIG;
+
+	watch = calloc(1, sizeof(*watch));
+	if (watch == NULL)
+		return -errno;
+	nb_watches++;
+	watch->folder = strdup(folder);
+	watch->entity = strdup(entity);
+	watch->property = strdup(property);
+	if (watch->folder == NULL || watch->entity == NULL ||
+			watch->property == NULL) {
+		watch_destroy(&watch->node);
+		return -ENOMEM;
+	}
+
+	return rs_dll_enqueue(&client->watches, &watch->node);
+}
+
+int client_unwatch(struct client *client, const char *folder,
+		const char *entity, const char *property)
+{
+	struct watch *watch;
+
+	if (client == NULL || folder == NULL || entity == NULL ||
+			property == NULL)
+		return -EINVAL;
+
+	watch = watch_find(client, folder, entity, property);
+	if (watch == NULL)
+		return -ENOENT;
+	rs_dll_remove(&client->watches, &watch->node);
+	watch_destroy(&watch->node);
+
+	return 0;
+}
+
+bool clients_have_watches(void)
+{
+	return nb_watches != 0;
+}
+
+static bool watch_match(const struct watch *watch,
+		const struct notification_scope *scope)
+{
+	if (!ut_string_match(watch->folder, scope->folder))
+		return false;
+	if (!ut_string_match(watch->entity, SUBSCRIBE_ANY) &&
+			!ut_string_match(watch->entity, scope->entity) &&
+			!ut_string_match(watch->entity, scope->name))
+		return false;
+
+	return ut_string_match(watch->property, SUBSCRIBE_ANY) ||
+			ut_string_match(watch->property, scope->property);
+}
+
+static bool client_watches(const struct client *client,
+		const struct notification_scope *scope)
+{
+	struct rs_node *node = NULL;
+
+	while ((node = rs_dll_next_from(&client->watches, node)) != NULL)
+		if (watch_match(to_watch(node), scope))
+			return true;
+
+	return false;
+}
+
+static bool argz_contains(const char *argz, size_t argz_len, const char *str)
+{
+	const char *entry = NULL;
+
+	if (str == NULL)
+		return false;
+
+	while ((entry = argz_next(argz, argz_len, entry)) != NULL)
+		if (ut_string_match(entry, str))
+			return true;
+
+	return false;
+}
+
+static bool client_is_concerned(const struct client *client,
+		const struct notification_scope *scope, uint32_t msgid)
+{
+	if (scope->origin_only)
+		return scope->origin == client->id;
+
+	/* sent only to the watchers, whatever their subscription */
+	if (msgid == FWD_ANSWER_PROPERTY_CHANGED)
+		return client_watches(client, scope);
+
+	if (scope->origin == client->id || !client->subscribed)
+		return true;
+
+	if (msgid > FWD_MESSAGE_LAST || !client->notifications[msgid])
+		return false;
+	/* notifications concerning no folder, e.g. BYEBYE, pass the filters */
+	if (scope->folder == NULL)
+		return true;
+	if (client->folders != NULL && !argz_contains(client->folders,
+			client->folders_len, scope->folder))
+		return false;
+	if (client->entities != NULL &&
+			!argz_contains(client->entities, client->entities_len,
+					scope->entity) &&
+			!argz_contains(client->entities, client->entities_len,
+					scope->name))
+		return false;
+
+	return true;
+}
+
+static size_t msg_size(const struct pomp_msg *msg)
+{
+	int ret;
+	const void *data;
+	size_t len;
+	size_t capacity;
+
+	ret = pomp_buffer_get_cdata(pomp_msg_get_buffer(msg), &data, &len,
+			&capacity);
+
+	return ret < 0 ? 0 : len;
+}
+
+/*
+ * a message bigger than the room available is still sent if the socket is
+ * empty, so that it can't be blocked forever
+ */
+static bool socket_has_room(const struct client *client, size_t size)
+{
+	int ret;
+	int outq;
+
+	ret = ioctl(pomp_conn_get_fd(client->conn), TIOCOUTQ, &outq);
+	if (ret < 0)
+		return true;
+
+	return outq == 0 || outq + size <= (size_t)client->sndbuf / 2;
+}
+
+static bool output_exceeds_limits(const struct client *client)
+{
+	return client->output_bytes > max_output_bytes ||
+			rs_dll_get_count(&client->output) > max_output_messages;
+}
+
+static void output_remove(struct client *client, struct queued_output *output)
+{
+	rs_dll_remove(&client->output, &output->node);
+	client->output_bytes -= output->size;
+	queued_output_destroy(&output->node);
+}
+
+static struct queued_output *output_find(const struct client *client,
+		uint32_t msgid, const char *key)
+{
+	struct rs_node *node = NULL;
+	struct queued_output *output;
+
+	while ((node = rs_dll_next_from(&client->output, node)) != NULL) {
+		output = to_queued_output(node);
+		if (output->key != NULL && ut_string_match(output->key, key) &&
+				pomp_msg_get_id(output->msg) == msgid)
+			return output;
+	}
+
+	return NULL;
+}
+
+/* replaces the message queued with the same type and key, if any */
+static bool output_coalesce(struct client *client, const struct pomp_msg *msg,
+		const char *key)
+{
+	struct queued_output *output;
+	struct pomp_msg *copy;
+	size_t size;
+
+	if (key == NULL)
+		return false;
+	output = output_find(client, pomp_msg_get_id(msg), key);
+	if (output == NULL)
+		return false;
+	copy = pomp_msg_new_copy(msg);
+	if (copy == NULL)
+		return false;
+
+	size = msg_size(msg);
+	client->output_bytes = client->output_bytes - output->size + size;
+	pomp_msg_destroy(output->msg);
+	output->msg = copy;
+	output->size = size;
+	stats.coalesced++;
+
+	return true;
+}
+
+static void output_drop_oldest(struct client *client, enum output_class class)
+{
+	struct rs_node *node;
+	struct rs_node *next;
+	struct queued_output *output;
+
+	for (node = rs_dll_get_head(&client->output);
+			node != NULL && output_exceeds_limits(client);
+			node = next) {
+		next = rs_dll_next_from(&client->output, node);
+		output = to_queued_output(node);
+		if (output->class != class)
+			continue;
+		output_remove(client, output);
+		stats.dropped++;
+	}
+}
+
+static void output_disconnect(struct client *client)
+{
+	ULOGW("client %"PRIu32" too slow, %zu bytes pending, disconnecting it",
+			client->id, client->output_bytes);
+	rs_dll_remove_all(&client->output);
+	client->output_bytes = 0;
+	client->disconnect = true;
+	stats.disconnections++;
+}
+
+static int output_enqueue(struct client *client, const struct pomp_msg *msg,
+		enum output_class class, const char *key)
+{
+	int ret;
+	struct queued_output *output;
+
+	output = calloc(1, sizeof(*output));
+	if (output == NULL)
+		return -errno;
+	output->msg = pomp_msg_new_copy(msg);
+	if (output->msg == NULL) {
+		ret = -errno;
+		free(output);
+		return ret;
+	}
+	if (key != NULL) {
+		output->key = strdup(key);
+		if (output->key == NULL) {
+			ret = -errno;
+			queued_output_destroy(&output->node);
+			return ret;
+		}
+	}
+	output->size = msg_size(msg);
+	output->class = class;
+	rs_dll_enqueue(&client->output, &output->node);
+	client->output_bytes += output->size;
+	if (client->output_bytes > stats.max_output_bytes)
+		stats.max_output_bytes = client->output_bytes;
+
+	return 0;
+}
+
+static int client_send(struct client *client, const struct pomp_msg *msg,
+		enum output_class class, const char *key)
+{
+	int ret;
+	enum output_policy policy = policies[class];
+
+	if (client->disconnect)
+		return 0;
+
+	/* fast path, nothing is pending */
+	if (rs_dll_get_count(&client->output) == 0 &&
+			socket_has_room(client, msg_size(msg)))
+		return pomp_conn_send_msg(client->conn, msg);
+
+	if (policy == OUTPUT_POLICY_COALESCE &&
+			output_coalesce(client, msg, key))
+		return 0;
+	ret = output_enqueue(client, msg, class, key);
+	if (ret < 0)
+		return ret;
+	if (!output_exceeds_limits(client))
+		return 0;
+
+	if (policy == OUTPUT_POLICY_DISCONNECT)
+		output_disconnect(client);
+	else
+		output_drop_oldest(client, class);
+
+	return 0;
+}
+
+static enum output_class notification_class(uint32_t msgid)
+{
+	return msgid == FWD_ANSWER_PREPARE_PROGRESS ? OUTPUT_CLASS_PROGRESS :
+			OUTPUT_CLASS_NOTIFICATION;
+}
+
+/* returns -1 if the notification can't be batched */
+static int batch_index(uint32_t msgid)
+{
+	switch (msgid) {
+	case FWD_ANSWER_DEAD:
+		return 0;
+	case FWD_ANSWER_DROPPED:
+		return 1;
+	case FWD_ANSWER_PREPARED:
+		return 2;
+	default:
+		return -1;
+	}
+}
+
+/* formats the arguments of the notification as a line of a batch */
+static char *batch_entry(const struct pomp_msg *msg)
+{
+	int ret;
+	uint32_t seqnum;
+	char __attribute__((cleanup(ut_string_free))) *a = NULL;
+	char __attribute__((cleanup(ut_string_free))) *b = NULL;
+	char __attribute__((cleanup(ut_string_free))) *c = NULL;
+	char *entry = NULL;
+
+	if (pomp_msg_get_id(msg) == FWD_ANSWER_DEAD)
+		ret = pomp_msg_read(msg, "%" PRIu32 "%ms%ms", &seqnum, &a, &b);
+	else
+		ret = pomp_msg_read(msg, "%" PRIu32 "%ms%ms%ms", &seqnum, &a,
+				&b, &c);
+	if (ret < 0) {
+		a = b = c = NULL;
+		errno = -ret;
+		return NULL;
+	}
+	ret = asprintf(&entry, "%" PRIu32 " %s %s%s%s", seqnum, a, b,
+			c == NULL ? "" : " ", c == NULL ? "" : c);
+	if (ret < 0) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return entry;
+}
+
+static int batch_add(struct notification_batch *batch,
+		const struct pomp_msg *msg)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *entry = NULL;
+
+	entry = batch_entry(msg);
+	if (entry == NULL)
+		return -errno;
+	ret = ut_string_append(&batch->entries, "%s%s",
+			batch->count == 0 ? "" : "\n", entry);
+	if (ret < 0)
+		return ret;
+	if (batch->count == 0) {
+		batch->first = pomp_msg_new_copy(msg);
+		if (batch->first == NULL)
+			return -errno;
+	}
+	batch->count++;
+
+	return 0;
+}
+
+static int batch_send(struct client *client, struct notification_batch *batch)
+{
+	int ret;
+	struct pomp_msg *msg;
+
+	if (batch->count == 1)
+		return client_send(client, batch->first,
+				OUTPUT_CLASS_NOTIFICATION, NULL);
+
+	msg = pomp_msg_new();
+	if (msg == NULL)
+		return -errno;
+	ret = pomp_msg_write(msg, FWD_ANSWER_BATCH, FWD_FORMAT(ANSWER_BATCH),
+			UINT32_MAX, fwd_message_str(pomp_msg_get_id(
+					batch->first)), batch->count,
+			batch->entries);
+	if (ret >= 0)
+		ret = client_send(client, msg, OUTPUT_CLASS_NOTIFICATION, NULL);
+	pomp_msg_destroy(msg);
+
+	return ret;
+}
+
+static void client_flush_batches(struct client *client)
+{
+	int ret;
+	unsigned i;
+	struct notification_batch *batch;
+
+	for (i = 0; i < CLIENTS_BATCH_TYPES; i++) {
+		batch = client->batches + i;
+		if (batch->count == 0)
+			continue;
+		ret = batch_send(client, batch);
+		if (ret < 0)
+			ULOGE("batch_send: %s", strerror(-ret));
+		batch_clean(batch);
+	}
+}
+
+static int client_notify(struct client *client,
+		const struct notification_scope *scope,
+		const struct pomp_msg *msg)
+{
+	int ret;
+	int index;
+	uint32_t msgid = pomp_msg_get_id(msg);
+
+	index = batch_index(msgid);
+	if (index < 0 || !client->notifications[FWD_ANSWER_BATCH])
+		return client_send(client, msg, notification_class(msgid),
+				scope->key);
+
+	ret = batch_add(client->batches + index, msg);
+	if (ret < 0) {
+		ULOGW("batch_add: %s, sending the notification as is",
+				strerror(-ret));
+		return client_send(client, msg, notification_class(msgid),
+				scope->key);
+	}
+
+	return 0;
+}
+
+void clients_notify(const struct notification_scope *scope,
+		const struct pomp_msg *msg)
+{
+	int ret;
+	struct rs_node *node = NULL;
+	struct client *client;
+	uint32_t msgid = pomp_msg_get_id(msg);
+
+	while ((node = rs_dll_next_from(&clients, node)) != NULL) {
+		client = to_client(node);
+		if (!client_is_concerned(client, scope, msgid))
+			continue;
+		ret = client_notify(client, scope, msg);
+		if (ret < 0)
+			ULOGE("client_notify: %s", strerror(-ret));
+	}
+}
+
+int client_answer(struct pomp_conn *conn, const struct pomp_msg *msg)
+{
+	struct client *client;
+
+	client = client_find(conn);
+	if (client == NULL)
+		return pomp_conn_send_msg(conn, msg);
+
+	return client_send(client, msg, OUTPUT_CLASS_ACK, NULL);
+}
+
+bool clients_have_output(void)
+{
+	struct rs_node *node = NULL;
+
+	while ((node = rs_dll_next_from(&clients, node)) != NULL)
+		if (rs_dll_get_count(&to_client(node)->output) != 0)
+			return true;
+
+	return false;
+}
+
+static void client_flush_output(struct client *client)
+{
+	int ret;
+	struct rs_node *node;
+	struct queued_output *output;
+
+	while ((node = rs_dll_get_head(&client->output)) != NULL) {
+		output = to_queued_output(node);
+		if (!socket_has_room(client, output->size))
+			return;
+		ret = pomp_conn_send_msg(client->conn, output->msg);
+		if (ret < 0)
+			ULOGE("pomp_conn_send_msg: %s", strerror(-ret));
+		output_remove(client, output);
+	}
+}
+
+void clients_flush_output(void)
+{
+	int ret;
+	struct rs_node *node;
+	struct rs_node *next;
+	struct client *client;
+
+	/* disconnecting a client can remove it from the list */
+	for (node = rs_dll_get_head(&clients); node != NULL; node = next) {
+		next = rs_dll_next_from(&clients, node);
+		client = to_client(node);
+		if (!client->disconnect) {
+			client_flush_batches(client);
+			client_flush_output(client);
+			continue;
+		}
+		if (client->disconnected)
+			continue;
+		client->disconnected = true;
+		ret = pomp_conn_disconnect(client->conn);
+		if (ret < 0)
+			ULOGE("pomp_conn_disconnect: %s", strerror(-ret));
+	}
+}
+
+char *clients_get_stats(void)
+{
+	int ret;
+	char *report = NULL;
+
+	ret = asprintf(&report, "clients: %u\n"
+			"output_coalesced: %"PRIu64"\n"
+			"output_dropped: %"PRIu64"\n"
+			"output_disconnections: %"PRIu64"\n"
+			"output_max_queued_bytes: %zu\n",
+			rs_dll_get_count(&clients), stats.coalesced,
+			stats.dropped, stats.disconnections,
+			stats.max_output_bytes);
+	if (ret < 0) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return report;
+}
+
+int client_enqueue_command(struct pomp_conn *conn, const struct pomp_msg *msg)
+{
+	int ret;
+	struct client *client;
+	struct queued_command *command;
+
+	client = client_find(conn);
+	if (client == NULL) {
+		ULOGE("message received from an unknown client");
+		return -ENOENT;
+	}
+
+	command = calloc(1, sizeof(*command));
+	if (command == NULL) {
+		ret = -errno;
+		ULOGE("calloc: %m");
+		return ret;
+	}
+	/* msg is only valid during the event callback */
+	command->msg = pomp_msg_new_copy(msg);
+	if (command->msg == NULL) {
+		ret = -errno;
+		ULOGE("pomp_msg_new_copy: %m");
+		free(command);
+		return ret;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &command->arrival);
+
+	return rs_dll_enqueue(&client->commands, &command->node);
+}
+
+bool clients_have_commands(void)
+{
+	struct rs_node *node = NULL;
+
+	while ((node = rs_dll_next_from(&clients, node)) != NULL)
+		if (rs_dll_get_count(&to_client(node)->commands) != 0)
+			return true;
+
+	return false;
+}
+
+void clients_process_commands(void)
+{
+	struct rs_node *node = NULL;
+
+	while ((node = rs_dll_next_from(&clients, node)) != NULL)
+		client_process_command(to_client(node));
+}
+
+void clients_cleanup(void)
+{
+	ULOGD("%s", __func__);
+
+	rs_dll_remove_all(&clients);
+}
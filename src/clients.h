@@ -0,0 +1,135 @@
+/**
+ * @file clients.h
+ * @brief registry of the clients connected to firmwared, each of them having
+ * it's own queue of pending commands
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef CLIENTS_H_
+#define CLIENTS_H_
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <rs_dll.h>
+
+#include <libpomp.h>
+
+#include <fwd.h>
+
+#include "firmwared.h"
+
+/* DEAD, DROPPED and PREPARED notifications can be batched */
+#define CLIENTS_BATCH_TYPES 3
+
+/* notifications of one type, sent during the same loop iteration */
+struct notification_batch {
+	/* sent as is if it is the only one of the batch */
+	struct pomp_msg *first;
+	uint32_t count;
+	/* one line per notification, its arguments separated by spaces */
+	char *entries;
+};
+
+struct client {
+	struct rs_node node;
+	struct pomp_conn *conn;
+	/* commands received but not executed yet, in their arrival order */
+	struct rs_dll commands;
+	/*
+	 * maximum time in ms a command can stay in the queue, it is answered
+	 * with an ERROR if it is reached, 0 means no deadline
+	 */
+	uint32_t deadline;
+	/* unique identifier, never reused, 0 means no client */
+	uint32_t id;
+	/* connected through a read-only listener, see FIRMWARED_LISTEN */
+	bool read_only;
+	/*
+	 * until it sends a SUBSCRIBE command, a client receives all the
+	 * notifications
+	 */
+	bool subscribed;
+	/* argz of the folders and entities subscribed to, NULL for any */
+	char *folders;
+	size_t folders_len;
+	char *entities;
+	size_t entities_len;
+	/* notifications subscribed to, indexed by message id */
+	bool notifications[FWD_MESSAGE_LAST + 1];
+	/*
+	 * messages waiting for room in the socket, so that they don't pile up
+	 * in libpomp, in their sending order
+	 */
+	struct rs_dll output;
+	size_t output_bytes;
+	/* size of the socket's send buffer */
+	int sndbuf;
+	/* the output limits have been exceeded, with the disconnect policy */
+	bool disconnect;
+	bool disconnected;
+	/* only used by the clients which subscribed to BATCH */
+	struct notification_batch batches[CLIENTS_BATCH_TYPES];
+	/* properties watched, for which PROPERTY_CHANGED is sent */
+	struct rs_dll watches;
+};
+
+/* maximum number of properties watched by a client */
+#define CLIENTS_MAX_WATCHES 128
+
+/* period in ms at which the output queues are flushed while not empty */
+#define CLIENTS_FLUSH_PERIOD 10
+
+int clients_init(void);
+/* a read-only client can only run the commands which don't modify anything */
+int clients_add(struct pomp_conn *conn, bool read_only);
+void clients_remove(struct pomp_conn *conn);
+struct client *client_find(struct pomp_conn *conn);
+/* returns 0 if the connection isn't a known client */
+uint32_t client_get_id(struct pomp_conn *conn);
+/*
+ * each parameter is a comma-separated list, or "*" to match anything, the
+ * subscription replaces the previous one
+ */
+int client_subscribe(struct client *client, const char *folders,
+		const char *entities, const char *notifications);
+/*
+ * entity is a sha1 or a name, entity and property can be "*" to match anything,
+ * watching the same property twice is a no-op
+ */
+int client_watch(struct client *client, const char *folder,
+		const char *entity, const char *property);
+/* returns -ENOENT if the property wasn't watched with the same parameters */
+int client_unwatch(struct client *client, const char *folder,
+		const char *entity, const char *property);
+/* true if at least one client watches a property */
+bool clients_have_watches(void);
+int client_enqueue_command(struct pomp_conn *conn, const struct pomp_msg *msg);
+/* sends an ack, subject to the limits of the client's output queue */
+int client_answer(struct pomp_conn *conn, const struct pomp_msg *msg);
+bool clients_have_commands(void);
+/*
+ * executes at most one command for each client, so that a client sending a lot
+ * of commands doesn't delay the others' ones
+ */
+void clients_process_commands(void);
+/*
+ * sends a message to the client at the origin of the scope and to those which
+ * subscribed to it
+ */
+void clients_notify(const struct notification_scope *scope,
+		const struct pomp_msg *msg);
+bool clients_have_output(void);
+/*
+ * sends the notifications batched during the loop iteration and the queued
+ * messages the sockets have room for, then disconnects the clients which
+ * exceeded their output limits
+ */
+void clients_flush_output(void);
+/* returns a text report of the output queues counters, to be freed */
+char *clients_get_stats(void);
+void clients_cleanup(void);
+
+#endif /* CLIENTS_H_ */
@@ -10,6 +10,7 @@
 #define _GNU_SOURCE
 #endif /* _GNU_SOURCE */
 #include <errno.h>
+#include <stdarg.h>
 #include <stdbool.h>
 #include <string.h>
 #include <stdio.h>
@@ -17,6 +18,8 @@
 
 #include <ut_string.h>
 
+#include "arena.h"
+#include "watchdog.h"
 #include "commands.h"
 
 #define ULOG_TAG firmwared_commands
@@ -25,20 +28,14 @@ ULOG_DECLARE_TAG(firmwared_commands);
 
 #define COMMANDS_MAX (FWD_COMMAND_LAST + 1)
 
+/* indexed by message id, the slots of the unregistered commands are zeroed */
 static struct command commands[COMMANDS_MAX];
 
 static char *list;
 
-static struct command *command_find(enum fwd_message msgid)
-{
-	int i;
-
-	for (i = 0; i < COMMANDS_MAX; i++)
-		if (commands[i].msgid == msgid)
-			return commands + i;
-
-	return NULL;
-}
+/* state of the command being processed, reset once it has been answered */
+static struct pomp_decoder *decoder;
+static struct arena arena;
 
 static bool command_is_invalid(const struct command *cmd)
 {
@@ -47,6 +44,15 @@ static bool command_is_invalid(const struct command *cmd)
 			cmd->handler == NULL || cmd->synopsis == NULL;
 }
 
+static struct command *command_find(enum fwd_message msgid)
+{
+	if (msgid < FWD_COMMAND_FIRST || msgid > FWD_COMMAND_LAST ||
+			command_is_invalid(commands + msgid))
+		return NULL;
+
+	return commands + msgid;
+}
+
 static void command_dump(const struct command *cmd)
 {
 	ULOGD("\t%s: \"%s\"", fwd_message_str(cmd->msgid), cmd->help);
@@ -114,49 +120,137 @@ const char *command_get_help(enum fwd_message msg)
 	return command->help_msg;
 }
 
+bool command_is_read_only(enum fwd_message msgid)
+{
+	const struct command *command = command_find(msgid);
+
+	return command == NULL || command->read_only;
+}
+
+/* the conversions are those of FWD_FORMAT, "%s" reading a const char ** */
+static int read_arguments(const char *fmt, va_list args)
+{
+	int ret;
+	unsigned longs;
+
+	while (*fmt != '\0') {
+		if (*fmt++ != '%')
+			return -EINVAL;
+		for (longs = 0; *fmt == 'l'; fmt++)
+			longs++;
+		switch (*fmt++) {
+		case 'u':
+			if (longs == 0)
+				ret = pomp_decoder_read_u32(decoder,
+						va_arg(args, uint32_t *));
+			else
+				ret = pomp_decoder_read_u64(decoder,
+						va_arg(args, uint64_t *));
+			break;
+		case 'd':
+		case 'i':
+			ret = pomp_decoder_read_i32(decoder,
+					va_arg(args, int32_t *));
+			break;
+		case 's':
+			ret = pomp_decoder_read_cstr(decoder,
+					va_arg(args, const char **));
+			break;
+		default:
+			return -EINVAL;
+		}
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+int command_read(const struct pomp_msg *msg, const char *fmt, ...)
+{
+	int ret;
+	va_list args;
+
+	if (msg == NULL || fmt == NULL)
+		return -EINVAL;
+
+	/* created once, reused by all the commands */
+	if (decoder == NULL) {
+		decoder = pomp_decoder_new();
+		if (decoder == NULL)
+			return -ENOMEM;
+	}
+	ret = pomp_decoder_init(decoder, msg);
+	if (ret < 0)
+		return ret;
+
+	va_start(args, fmt);
+	ret = read_arguments(fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+int command_read_more(const char *fmt, ...)
+{
+	int ret;
+	va_list args;
+
+	if (decoder == NULL || fmt == NULL)
+		return -EINVAL;
+
+	va_start(args, fmt);
+	ret = read_arguments(fmt, args);
+	va_end(args);
+
+	return ret;
+}
+
+struct arena *command_arena(void)
+{
+	return &arena;
+}
+
 int command_invoke(struct pomp_conn *conn, const struct pomp_msg *msg)
 {
 	int ret;
 	uint32_t seqnum;
+	WATCHDOG_PROBE(fwd_message_str(pomp_msg_get_id(msg)), NULL);
 
-	ret = pomp_msg_read(msg, "%"PRIu32, &seqnum);
+	ret = command_read(msg, "%"PRIu32, &seqnum);
 	if (ret < 0) {
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
-		return ret;
+		ULOGE("command_read: %s", strerror(-ret));
+		goto out;
 	}
 	ret = command_process(conn, msg, seqnum);
 	if (ret < 0) {
 		ULOGE("command_process: %s", strerror(-ret));
-		return firmwared_answer(conn, FWD_ANSWER_ERROR,
-				FWD_FORMAT_ANSWER_ERROR, seqnum, -ret,
+		ret = firmwared_answer(conn, FWD_ANSWER_ERROR,
+				FWD_FORMAT(ANSWER_ERROR), seqnum, -ret,
 				strerror(-ret));
+		goto out;
 	}
 
-	return 0;
+	ret = 0;
+out:
+	/* the argument views and the temporaries die with the request */
+	if (decoder != NULL)
+		pomp_decoder_clear(decoder);
+	arena_reset(&arena);
+
+	return ret;
 }
 
 int command_register(const struct command *cmd)
 {
-	const struct command *needle;
-	int i;
-
-	if (command_is_invalid(cmd))
+	if (command_is_invalid(cmd) || cmd->msgid > FWD_COMMAND_LAST)
 		return -EINVAL;
 
 	/* command name must be unique */
-	needle = command_find(cmd->msgid);
-	if (needle != NULL)
+	if (command_find(cmd->msgid) != NULL)
 		return -EEXIST;
 
-	/* find first free slot */
-	for (i = 0; i < COMMANDS_MAX; i++)
-		if (command_is_invalid(commands + i))
-			break;
-
-	if (i >= COMMANDS_MAX)
-		return -ENOMEM;
-
-	commands[i] = *cmd;
+	commands[cmd->msgid] = *cmd;
 
 	return 0;
 }
@@ -164,16 +258,12 @@ int command_register(const struct command *cmd)
 int command_unregister(enum fwd_message msgid)
 {
 	struct command *needle;
-	struct command *max = commands + COMMANDS_MAX - 1;
 
 	needle = command_find(msgid);
 	if (needle == NULL)
 		return -ESRCH;
 	ut_string_free(&needle->help_msg);
-
-	for (; needle < max; needle++)
-		*needle = *(needle + 1);
-	memset(max - 1, 0, sizeof(*needle)); /* NULL guard */
+	memset(needle, 0, sizeof(*needle));
 
 	return 0;
 }
@@ -181,13 +271,14 @@ int command_unregister(enum fwd_message msgid)
 const char *command_list(void)
 {
 	int ret;
-	struct command *command = commands + COMMANDS_MAX;
+	struct command *command;
 
 	/* the result is cached */
 	if (list != NULL)
 		return list;
 
-	while (command-- > commands) {
+	for (command = commands; command < commands + COMMANDS_MAX;
+			command++) {
 		if (command_is_invalid(command))
 			continue;
 		ret = ut_string_append(&list, "%s ",
@@ -212,4 +303,8 @@ const char *command_list(void)
 static __attribute__((destructor)) void commands_cleanup(void)
 {
 	ut_string_free(&list);
+	if (decoder != NULL)
+		pomp_decoder_destroy(decoder);
+	decoder = NULL;
+	arena_clean(&arena);
 }
@@ -8,11 +8,13 @@
  */
 #ifndef COMMANDS_H_
 #define COMMANDS_H_
+#include <stdbool.h>
 
 #include <libpomp.h>
 
 #include <fwd.h>
 
+#include "arena.h"
 #include "firmwared.h"
 
 #define COMMAND_CONSTRUCTOR_PRIORITY (FIRMWARED_CONSTRUCTOR_PRIORITY + 1)
@@ -24,10 +26,27 @@ struct command {
 	const char *synopsis;
 	int (*handler)(struct pomp_conn *conn, const struct pomp_msg *msg,
 			uint32_t seqnum);
+	/*
+	 * modifies nothing but the state of the client's connection, thus can
+	 * be run by the clients of a read-only listener
+	 */
+	bool read_only;
 	char *help_msg;
 };
 
 const char *command_get_help(enum fwd_message msgid);
+/* unknown commands are read-only, they are answered with an error anyway */
+bool command_is_read_only(enum fwd_message msgid);
+/*
+ * reads the arguments of the command being processed, from the seqnum, with the
+ * conversions of FWD_FORMAT(), a "%s" giving a const char * pointing in the
+ * message, without copy, valid until the handler returns
+ */
+int command_read(const struct pomp_msg *msg, const char *fmt, ...);
+/* reads the arguments following those read so far, e.g. tuples */
+int command_read_more(const char *fmt, ...);
+/* for the temporaries of the command being processed, reset once answered */
+struct arena *command_arena(void);
 int command_invoke(struct pomp_conn *conn, const struct pomp_msg *msg);
 int command_register(const struct command *cmd);
 int command_unregister(enum fwd_message msgid);
@@ -0,0 +1,92 @@
+/**
+ * @file abort.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_abort
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_abort);
+
+#include "commands.h"
+#include "clients.h"
+#include "folders.h"
+
+static int abort_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	const char *folder;
+	const char *identification_string;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_ABORT), &seqnum,
+			&folder, &identification_string);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+
+	ret = folder_preparation_abort(folder, identification_string,
+			client_get_id(conn));
+	if (ret < 0)
+		return ret;
+
+	return firmwared_answer(conn, FWD_ANSWER_ABORTED,
+			FWD_FORMAT(ANSWER_ABORTED), seqnum, folder,
+			identification_string);
+}
+
+static const struct command abort_command = {
+		.msgid = FWD_COMMAND_ABORT,
+		.help = "Aborts a preparation, running or queued.",
+		.long_help = "Searches for the preparation of the folder "
+				"FOLDER whose identification string, without "
+				"its options, is IDENTIFICATION_STRING and "
+				"withdraws the PREPARE commands the client "
+				"has issued for it, which are answered with "
+				"an ERROR (ECANCELED). If no other client is "
+				"waiting for the preparation, it is aborted "
+				"and the last of them is answered once the "
+				"download, if any, has been interrupted and "
+				"the partial file removed. A client can only "
+				"abort its own "
+				"preparations, the preparations of instances "
+				"can't be aborted once started.\n"
+				"The preparations of a client are aborted "
+				"automatically when it disconnects, unless "
+				"the detached=yes option has been passed to "
+				"PREPARE.",
+		.synopsis = "FOLDER IDENTIFICATION_STRING",
+		.handler = abort_command_handler,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void abort_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&abort_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void abort_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(abort_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
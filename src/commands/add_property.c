@@ -14,8 +14,6 @@
 #include <string.h>
 #include <inttypes.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_add_property
@@ -29,16 +27,15 @@ static int add_property_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
-	char __attribute__((cleanup(ut_string_free))) *property_name = NULL;
+	const char *folder;
+	const char *property_name;
 	uint32_t msgid = pomp_msg_get_id(msg);
 	enum fwd_message ansid = fwd_message_command_answer(msgid);
 
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_ADD_PROPERTY_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_ADD_PROPERTY), &seqnum,
 			&folder, &property_name);
 	if (ret < 0) {
-		folder = property_name = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -49,8 +46,8 @@ static int add_property_command_handler(struct pomp_conn *conn,
 	}
 
 	/* coverity[bad_printf_format_string] */
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_PROPERTY_ADDED, seqnum,
-			folder, property_name);
+	return firmwared_answer(conn, ansid, FWD_FORMAT(ANSWER_PROPERTY_ADDED),
+			seqnum, folder, property_name);
 }
 
 static const struct command add_property_command = {
@@ -0,0 +1,132 @@
+/**
+ * @file changes_since.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_command_changes_since
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_changes_since);
+
+#include "commands.h"
+#include "journal.h"
+#include "answer.h"
+
+/* maximum number of changes per answer */
+#define CHANGES_SINCE_MAX_COUNT 1000
+
+static int changes_since_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	const char *epoch;
+	uint64_t generation;
+	uint64_t last;
+	uint32_t count = 0;
+	bool resync;
+	const struct journal_entry *entry;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_CHANGES_SINCE),
+			&seqnum, &epoch, &generation);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+
+	/* firmwared restarted or the client fell out of the journal */
+	resync = !ut_string_match(epoch, journal_get_epoch()) ||
+			generation > journal_get_generation();
+	last = generation;
+	if (!resync) {
+		while (count < CHANGES_SINCE_MAX_COUNT &&
+				(entry = journal_next(last)) != NULL) {
+			last = entry->generation;
+			count++;
+		}
+		resync = entry == NULL && errno == ERANGE;
+	}
+	if (resync) {
+		count = 0;
+		last = journal_get_generation();
+	}
+
+	ret = answer_init(&answer, FWD_ANSWER_CHANGES, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, journal_get_epoch());
+	answer_add_u64(&answer, last);
+	answer_add_u32(&answer, resync);
+	answer_add_u32(&answer, count);
+	for (; count > 0; count--) {
+		entry = journal_next(generation);
+		generation = entry->generation;
+		answer_add_u64(&answer, entry->generation);
+		answer_add_str(&answer, journal_event_str(entry->event));
+		answer_add_str(&answer, entry->folder);
+		answer_add_str(&answer, entry->entity);
+		answer_add_str(&answer, entry->name);
+		answer_add_str(&answer, entry->property);
+		answer_add_str(&answer, entry->value);
+	}
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command changes_since_command = {
+		.msgid = FWD_COMMAND_CHANGES_SINCE,
+		.help = "Retrieves the changes of the entities which occurred "
+				"after the generation GENERATION of the epoch "
+				"EPOCH.",
+		.long_help = "Each change is sent as a tuple of arguments, its "
+				"generation, its type, ADDED, CHANGED or "
+				"DROPPED, the folder, the sha1 and the name of "
+				"the entity, and for CHANGED, the property and "
+				"its new value. At most 1000 changes are sent, "
+				"the GENERATION sent back is the one to pass to "
+				"retrieve the following ones. If EPOCH doesn't "
+				"match the current one, i.e. firmwared has "
+				"been restarted, or if the changes following "
+				"GENERATION aren't in the journal anymore, "
+				"RESYNC is set to 1 and no change is sent, the "
+				"client must then list the entities again, "
+				"before asking for the changes following the "
+				"EPOCH and GENERATION sent back.",
+		.synopsis = "EPOCH GENERATION",
+		.handler = changes_since_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void changes_since_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&changes_since_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void changes_since_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(changes_since_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
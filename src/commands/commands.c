@@ -28,7 +28,7 @@ static int commands_command_handler(struct pomp_conn *conn,
 		return -errno;
 
 	return firmwared_answer(conn, FWD_ANSWER_COMMANDS,
-			FWD_FORMAT_ANSWER_COMMANDS, seqnum, list);
+			FWD_FORMAT(ANSWER_COMMANDS), seqnum, list);
 }
 
 static const struct command commands_command = {
@@ -36,6 +36,7 @@ static const struct command commands_command = {
 		.help = "List the different commands registered so far.",
 		.synopsis = "",
 		.handler = commands_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
@@ -33,7 +33,7 @@ static int config_keys_command_handler(struct pomp_conn *conn,
 	}
 
 	return firmwared_answer(conn, FWD_ANSWER_CONFIG_KEYS,
-			FWD_FORMAT_ANSWER_CONFIG_KEYS, seqnum, list);
+			FWD_FORMAT(ANSWER_CONFIG_KEYS), seqnum, list);
 }
 
 static const struct command config_keys_command = {
@@ -41,6 +41,7 @@ static const struct command config_keys_command = {
 		.help = "Lists all the config keys available.",
 		.synopsis = "",
 		.handler = config_keys_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
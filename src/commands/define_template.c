@@ -0,0 +1,151 @@
+/**
+ * @file define_template.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+#include <envz.h>
+
+#include <libpomp.h>
+
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_command_define_template
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_define_template);
+
+#include "commands.h"
+#include "folders.h"
+#include "templates.h"
+
+static void free_envz(char **envz)
+{
+	free(*envz);
+	*envz = NULL;
+}
+
+/* the property's name is checked without the index of an array access */
+static int check_property(const struct folder_snapshot *snapshot,
+		const char *name, const char *value)
+{
+	char *base;
+
+	if (ut_string_is_invalid(name) || ut_string_is_invalid(value) ||
+			strchr(name, '=') != NULL)
+		return -EINVAL;
+	base = arena_strndup(command_arena(), name, strcspn(name, "["));
+	if (base == NULL)
+		return -errno;
+	if (!folder_snapshot_has_property(snapshot, base)) {
+		ULOGE("unknown property %s", name);
+		return -ESRCH;
+	}
+
+	return 0;
+}
+
+static int define_template_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	char __attribute__((cleanup(free_envz))) *properties = NULL;
+	size_t properties_len = 0;
+	const char *folder;
+	const char *name;
+	const char *property;
+	const char *value;
+	uint32_t count;
+	uint32_t i;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_DEFINE_TEMPLATE), &seqnum,
+			&folder, &name, &count);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	if (count > TEMPLATES_MAX_PROPERTIES)
+		return -E2BIG;
+
+	snapshot = folder_get_snapshot(folder);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	for (i = 0; i < count; i++) {
+		ret = command_read_more("%s%s", &property, &value);
+		if (ret < 0)
+			return ret;
+		ret = check_property(snapshot, property, value);
+		if (ret < 0)
+			return ret;
+		ret = -envz_add(&properties, &properties_len, property, value);
+		if (ret < 0)
+			return ret;
+	}
+
+	ret = template_define(folder, name, properties, properties_len);
+	if (ret < 0) {
+		ULOGE("template_define: %s", strerror(-ret));
+		return ret;
+	}
+
+	/* coverity[bad_printf_format_string] */
+	return firmwared_answer(conn, FWD_ANSWER_TEMPLATE_DEFINED,
+			FWD_FORMAT(ANSWER_TEMPLATE_DEFINED), seqnum, folder,
+			name, count);
+}
+
+static const struct command define_template_command = {
+		.msgid = FWD_COMMAND_DEFINE_TEMPLATE,
+		.help = "Defines the template NAME of the folder FOLDER, "
+				"setting COUNT properties, each one designated "
+				"by a pair of arguments, a property name and "
+				"its value.",
+		.long_help = "The entities of FOLDER prepared with the "
+				"template=NAME option get the properties of the "
+				"template set, in order, before the PREPARED "
+				"notification is sent, array properties items "
+				"are accessed as with SET_PROPERTY. If setting "
+				"one of them fails, the entity is dropped and "
+				"the preparation fails. Defining an existing "
+				"template replaces it, a COUNT of 0 removes it. "
+				"Templates can also be defined in "
+				"FIRMWARED_TEMPLATES.",
+		.synopsis = "FOLDER NAME COUNT (PROPERTY_NAME PROPERTY_VALUE)...",
+		.handler = define_template_command_handler,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void define_template_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&define_template_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void define_template_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(define_template_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -21,6 +21,7 @@ ULOG_DECLARE_TAG(firmwared_command_drop);
 #include <fwd.h>
 
 #include "commands.h"
+#include "clients.h"
 #include "firmwares.h"
 #include "instances.h"
 #include "folders.h"
@@ -29,19 +30,18 @@ static int drop_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
+	const char *folder;
+	const char *identifier;
 	char __attribute__((cleanup(ut_string_free))) *name = NULL;
-	char __attribute__((cleanup(ut_string_free))) *sha1 = NULL;
+	char *sha1;
 	struct folder_entity *entity;
 	uint32_t msgid = pomp_msg_get_id(msg);
 	enum fwd_message ansid = fwd_message_command_answer(msgid);
 
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_DROP_READ, &seqnum, &folder,
-			&identifier);
+	ret = command_read(msg, FWD_FORMAT(COMMAND_DROP), &seqnum,
+			&folder, &identifier);
 	if (ret < 0) {
-		folder = identifier = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -51,7 +51,8 @@ static int drop_command_handler(struct pomp_conn *conn,
 	ret = folder_entity_get_property(entity, "name", &name);
 	if (ret < 0)
 		return ret;
-	sha1 = strdup(folder_entity_get_sha1(entity));
+	/* the entity doesn't survive the drop */
+	sha1 = arena_strdup(command_arena(), folder_entity_get_sha1(entity));
 	if (name == NULL || sha1 == NULL)
 		return -ENOMEM;
 
@@ -62,8 +63,13 @@ static int drop_command_handler(struct pomp_conn *conn,
 	}
 
 	/* coverity[bad_printf_format_string] */
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_DROPPED, seqnum,
-			folder, sha1, name);
+	return firmwared_notify(&(struct notification_scope) {
+				.origin = client_get_id(conn),
+				.folder = folder,
+				.entity = sha1,
+				.name = name,
+			}, ansid, FWD_FORMAT(ANSWER_DROPPED), seqnum, folder,
+			sha1, name);
 }
 
 static const struct command drop_command = {
@@ -29,7 +29,7 @@ static int folders_command_handler(struct pomp_conn *conn,
 		return -errno;
 
 	return firmwared_answer(conn, FWD_ANSWER_FOLDERS,
-			FWD_FORMAT_ANSWER_FOLDERS, seqnum, list);
+			FWD_FORMAT(ANSWER_FOLDERS), seqnum, list);
 }
 
 static const struct command folders_command = {
@@ -38,6 +38,7 @@ static const struct command folders_command = {
 				"folders.",
 		.synopsis = "",
 		.handler = folders_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
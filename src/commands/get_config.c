@@ -27,16 +27,15 @@ static int get_config_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *config_key = NULL;
+	const char *config_key;
 	char *prefixed_config_key = NULL;
 	enum config_key key;
 	size_t len;
 
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_GET_CONFIG_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_GET_CONFIG), &seqnum,
 			&config_key);
 	if (ret < 0) {
-		config_key = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 	len = UT_ARRAY_SIZE(CONFIG_KEYS_PREFIX) + strlen(config_key);
@@ -48,7 +47,7 @@ static int get_config_command_handler(struct pomp_conn *conn,
 
 	/* coverity[bad_printf_format_string] */
 	return firmwared_answer(conn, FWD_ANSWER_GET_CONFIG,
-			FWD_FORMAT_ANSWER_GET_CONFIG, seqnum, config_key,
+			FWD_FORMAT(ANSWER_GET_CONFIG), seqnum, config_key,
 			config_get(key));
 }
 
@@ -61,6 +60,7 @@ static const struct command get_config_command = {
 				"config keys to query.",
 		.synopsis = "CONFIG_KEY",
 		.handler = get_config_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
@@ -0,0 +1,173 @@
+/**
+ * @file get_properties.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <stdlib.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_command_get_properties
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_get_properties);
+
+#include "commands.h"
+#include "folders.h"
+#include "answer.h"
+
+#define GET_PROPERTIES_MAX_COUNT 0x10000
+
+struct property_query {
+	/* both point inside the command message */
+	const char *identifier;
+	const char *name;
+	/* positive errno, 0 on success */
+	int32_t error;
+	char *value;
+};
+
+static void free_values(struct property_query **queries)
+{
+	struct property_query *q = *queries;
+
+	if (q == NULL)
+		return;
+	/* the array is terminated by an element with a NULL identifier */
+	for (; q->identifier != NULL; q++)
+		ut_string_free(&q->value);
+}
+
+/* whole properties are read from the snapshot, indexed accesses aren't */
+static void query_property(const struct folder_snapshot *snapshot,
+		const char *folder, struct property_query *query)
+{
+	int ret;
+	const struct folder_entity_snapshot *es;
+	const char *cached_value;
+	struct folder_entity *entity;
+
+	es = folder_snapshot_find(snapshot, query->identifier);
+	if (es == NULL) {
+		query->error = errno;
+		return;
+	}
+	cached_value = folder_entity_snapshot_get_property(es, query->name);
+	if (cached_value != NULL) {
+		query->value = strdup(cached_value);
+		if (query->value == NULL)
+			query->error = errno;
+		return;
+	}
+
+	entity = folder_find_entity(folder, query->identifier);
+	if (entity == NULL) {
+		query->error = errno;
+		return;
+	}
+	ret = folder_entity_get_property(entity, query->name, &query->value);
+	if (ret < 0)
+		query->error = -ret;
+}
+
+static int get_properties_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	struct property_query __attribute__((cleanup(free_values)))
+			*queries = NULL;
+	const char *folder;
+	uint32_t count;
+	uint32_t i;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_GET_PROPERTIES), &seqnum,
+			&folder, &count);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	if (count > GET_PROPERTIES_MAX_COUNT)
+		return -E2BIG;
+	queries = arena_alloc(command_arena(), (count + 1) * sizeof(*queries));
+	if (queries == NULL)
+		return -errno;
+	for (i = 0; i < count; i++) {
+		ret = command_read_more("%s%s", &queries[i].identifier,
+				&queries[i].name);
+		if (ret < 0)
+			return ret;
+	}
+
+	snapshot = folder_get_snapshot(folder);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	for (i = 0; i < count; i++)
+		query_property(snapshot, folder, queries + i);
+
+	ret = answer_init(&answer, FWD_ANSWER_GET_PROPERTIES, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, folder);
+	answer_add_u32(&answer, count);
+	for (i = 0; i < count; i++) {
+		answer_add_str(&answer, queries[i].identifier);
+		answer_add_str(&answer, queries[i].name);
+		answer_add_i32(&answer, queries[i].error);
+		answer_add_str(&answer, queries[i].error == 0 ?
+				queries[i].value : "");
+	}
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command get_properties_command = {
+		.msgid = FWD_COMMAND_GET_PROPERTIES,
+		.help = "Retrieves the values of COUNT properties, each one "
+				"designated by a pair of arguments, the "
+				"identifier of an entity of the folder FOLDER "
+				"and a property name.",
+		.long_help = "The answer contains, for each pair, the entity "
+				"identifier, the property name, an errno, 0 on "
+				"success, and the value, empty on error. "
+				"Array properties items are accessed as with "
+				"GET_PROPERTY.",
+		.synopsis = "FOLDER COUNT (ENTITY_IDENTIFIER PROPERTY_NAME)...",
+		.handler = get_properties_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void get_properties_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&get_properties_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void get_properties_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(get_properties_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
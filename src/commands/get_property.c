@@ -34,22 +34,40 @@ static int get_property_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
-	char __attribute__((cleanup(ut_string_free))) *property_name = NULL;
+	const char *folder;
+	const char *identifier;
+	const char *property_name;
 	char __attribute__((cleanup(ut_string_free))) *value = NULL;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const struct folder_entity_snapshot *es;
+	const char *cached_value;
 	struct folder_entity *entity;
 	uint32_t msgid = pomp_msg_get_id(msg);
 	enum fwd_message ansid = fwd_message_command_answer(msgid);
 
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_GET_PROPERTY_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_GET_PROPERTY), &seqnum,
 			&folder, &identifier, &property_name);
 	if (ret < 0) {
-		folder = identifier = property_name = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
+	/* whole properties are read from the folder's snapshot */
+	snapshot = folder_get_snapshot(folder);
+	if (snapshot == NULL)
+		return -errno;
+	es = folder_snapshot_find(snapshot, identifier);
+	if (es == NULL)
+		return -errno;
+	cached_value = folder_entity_snapshot_get_property(es, property_name);
+	if (cached_value != NULL)
+		/* coverity[bad_printf_format_string] */
+		return firmwared_answer(conn, ansid,
+				FWD_FORMAT(ANSWER_GET_PROPERTY), seqnum, folder,
+				identifier, property_name, cached_value);
+
+	/* indexed accesses to array properties aren't */
 	entity = folder_find_entity(folder, identifier);
 	if (entity == NULL)
 		return -errno;
@@ -60,8 +78,8 @@ static int get_property_command_handler(struct pomp_conn *conn,
 	}
 
 	/* coverity[bad_printf_format_string] */
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_GET_PROPERTY, seqnum,
-			folder, identifier, property_name, value);
+	return firmwared_answer(conn, ansid, FWD_FORMAT(ANSWER_GET_PROPERTY),
+			seqnum, folder, identifier, property_name, value);
 }
 
 static const struct command get_property_command = {
@@ -77,6 +95,7 @@ static const struct command get_property_command = {
 				"name with [i] to retrieve the i-th value.",
 		.synopsis = "FOLDER ENTITY_IDENTIFIER PROPERTY_NAME",
 		.handler = get_property_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
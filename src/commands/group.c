@@ -0,0 +1,215 @@
+/**
+ * @file group.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+#include <fnmatch.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_group
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_group);
+
+#include "commands.h"
+#include "clients.h"
+#include "folders.h"
+#include "filter.h"
+#include "group.h"
+
+#define GROUP_MAX_PATTERNS 64
+
+/* the strings point inside the SELECTOR argument */
+struct group_patterns {
+	unsigned nb;
+	const char *patterns[GROUP_MAX_PATTERNS];
+};
+
+static bool selector_is_filter(const char *selector)
+{
+	return strpbrk(selector, "=~") != NULL;
+}
+
+static int parse_patterns(char *str, struct group_patterns *patterns)
+{
+	char *saveptr = NULL;
+	char *pattern;
+
+	patterns->nb = 0;
+	for (pattern = strtok_r(str, ",", &saveptr); pattern != NULL;
+			pattern = strtok_r(NULL, ",", &saveptr)) {
+		if (patterns->nb == GROUP_MAX_PATTERNS)
+			return -E2BIG;
+		patterns->patterns[patterns->nb++] = pattern;
+	}
+
+	return patterns->nb == 0 ? -EINVAL : 0;
+}
+
+/* an identifier which isn't a pattern must designate an existing entity */
+static int check_patterns(const struct folder_snapshot *snapshot,
+		const struct group_patterns *patterns)
+{
+	unsigned i;
+	const char *pattern;
+
+	for (i = 0; i < patterns->nb; i++) {
+		pattern = patterns->patterns[i];
+		if (strpbrk(pattern, "*?[") == NULL &&
+				folder_snapshot_find(snapshot, pattern) == NULL) {
+			ULOGE("no entity %s", pattern);
+			return -ENOENT;
+		}
+	}
+
+	return 0;
+}
+
+static bool patterns_match(const struct group_patterns *patterns,
+		const struct folder_entity_snapshot *es)
+{
+	unsigned i;
+
+	for (i = 0; i < patterns->nb; i++)
+		if (fnmatch(patterns->patterns[i], es->name, 0) == 0 ||
+				fnmatch(patterns->patterns[i], es->sha1, 0) == 0)
+			return true;
+
+	return false;
+}
+
+static int group_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const char *operation_str;
+	const char *folder_name;
+	const char *selector;
+	char *selector_copy;
+	struct folder_entity_snapshot * const *candidates;
+	const struct folder_entity_snapshot **members;
+	unsigned nb_candidates;
+	unsigned nb_members = 0;
+	unsigned i;
+	bool is_filter;
+	enum group_operation operation;
+	struct filter filter;
+	struct group_patterns patterns;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_GROUP), &seqnum,
+			&operation_str, &folder_name, &selector);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	operation = group_operation_from_str(operation_str);
+	if (operation == GROUP_OPERATION_INVALID) {
+		ULOGE("invalid operation %s", operation_str);
+		return -EINVAL;
+	}
+	/* an empty selector would too easily drop a whole folder */
+	if (selector[0] == '\0')
+		return -EINVAL;
+	/* parsing is done in place, the argument is a view on the message */
+	selector_copy = arena_strdup(command_arena(), selector);
+	if (selector_copy == NULL)
+		return -errno;
+	is_filter = selector_is_filter(selector);
+	if (is_filter)
+		ret = filter_parse(selector_copy, &filter);
+	else
+		ret = parse_patterns(selector_copy, &patterns);
+	if (ret < 0) {
+		ULOGE("invalid selector: %s", strerror(-ret));
+		return ret;
+	}
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	if (is_filter)
+		ret = filter_check(&filter, snapshot);
+	else
+		ret = check_patterns(snapshot, &patterns);
+	if (ret < 0)
+		return ret;
+
+	if (is_filter) {
+		filter_get_candidates(&filter, snapshot, &candidates,
+				&nb_candidates);
+	} else {
+		candidates = snapshot->entities;
+		nb_candidates = snapshot->nb_entities;
+	}
+	members = arena_alloc(command_arena(),
+			(nb_candidates + 1) * sizeof(*members));
+	if (members == NULL)
+		return -errno;
+	for (i = 0; i < nb_candidates; i++)
+		if (is_filter ? filter_match(&filter, candidates[i]) :
+				patterns_match(&patterns, candidates[i]))
+			members[nb_members++] = candidates[i];
+
+	return group_run(operation, folder_name, members, nb_members, seqnum,
+			client_get_id(conn));
+}
+
+static const struct command group_command = {
+		.msgid = FWD_COMMAND_GROUP,
+		.help = "Applies OPERATION to the items of the folder FOLDER "
+				"designated by SELECTOR.",
+		.long_help = "OPERATION is one of START, KILL or DROP, START "
+				"and KILL are only valid on the instances "
+				"folder. SELECTOR is either a filter, with the "
+				"syntax of the QUERY command, e.g. "
+				"\"state=READY\", or a comma-separated list of "
+				"sha1s, names or shell wildcard patterns "
+				"matching them, e.g. \"swarm_*\". Up to "
+				"FIRMWARED_GROUP_PARALLELISM instances are "
+				"started or killed concurrently. The answer is "
+				"sent once the operation is over for all the "
+				"items and contains the errno value of each of "
+				"them, 0 on success. The usual notifications "
+				"are sent for each item, with an invalid "
+				"sequence number.",
+		.synopsis = "OPERATION FOLDER SELECTOR",
+		.handler = group_command_handler,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void group_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&group_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void group_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(group_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -15,8 +15,6 @@
 
 #include <libpomp.h>
 
-#include <ut_string.h>
-
 #define ULOG_TAG firmwared_command_help
 #include <ulog.h>
 ULOG_DECLARE_TAG(firmwared_command_help);
@@ -28,20 +26,22 @@ static int help_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *command_name = NULL;
+	const char *name;
+	char *command_name;
 	enum fwd_message command_id;
 	const char *help;
 	char *p;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_HELP_READ, &seqnum,
-			&command_name);
+	ret = command_read(msg, FWD_FORMAT(COMMAND_HELP), &seqnum,
+			&name);
 	if (ret < 0) {
-		command_name = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
+	command_name = arena_strdup(command_arena(), name);
+	if (command_name == NULL)
+		return -errno;
 	for (p = command_name; *p != '\0'; p++)
 		*p = toupper(*p);
 	command_id = fwd_message_from_str(command_name);
@@ -52,7 +52,7 @@ static int help_command_handler(struct pomp_conn *conn,
 		return -EINVAL;
 	}
 
-	return firmwared_answer(conn, FWD_ANSWER_HELP, FWD_FORMAT_ANSWER_HELP,
+	return firmwared_answer(conn, FWD_ANSWER_HELP, FWD_FORMAT(ANSWER_HELP),
 			seqnum, command_name, help);
 }
 
@@ -61,6 +61,7 @@ static const struct command help_command = {
 		.help = "Sends back a little help on the command COMMAND.",
 		.synopsis = "COMMAND",
 		.handler = help_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
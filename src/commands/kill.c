@@ -10,8 +10,6 @@
 #include <string.h>
 #include <inttypes.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_kill
@@ -19,6 +17,7 @@
 ULOG_DECLARE_TAG(firmwared_command_kill);
 
 #include "commands.h"
+#include "clients.h"
 #include "firmwares.h"
 #include "instances.h"
 #include "folders.h"
@@ -27,16 +26,13 @@ static int kill_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
+	const char *identifier;
 	struct folder_entity *entity;
 	struct instance *instance;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_KILL_READ, &seqnum,
-			&identifier);
+	ret = command_read(msg, FWD_FORMAT(COMMAND_KILL), &seqnum, &identifier);
 	if (ret < 0) {
-		identifier = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -45,7 +41,7 @@ static int kill_command_handler(struct pomp_conn *conn,
 		return -errno;
 	instance = instance_from_entity(entity);
 
-	return instance_kill(instance, seqnum);
+	return instance_kill(instance, seqnum, client_get_id(conn));
 }
 
 static const struct command kill_command = {
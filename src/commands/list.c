@@ -14,8 +14,6 @@
 
 #include <libpomp.h>
 
-#include <ut_string.h>
-
 #define ULOG_TAG firmwared_command_list
 #include <ulog.h>
 ULOG_DECLARE_TAG(firmwared_command_list);
@@ -23,73 +21,31 @@ ULOG_DECLARE_TAG(firmwared_command_list);
 #include "commands.h"
 #include "folders.h"
 
-static int build_list(char **list, const struct folder *folder, unsigned *count)
-{
-	int ret;
-	struct folder_entity *e = NULL;
-	char *tmp = NULL;
-
-	if (list == NULL || folder == NULL || count == NULL)
-		return -EINVAL;
-
-	*count = 0;
-	*list = strdup("");
-	if (*list == NULL) {
-		ret = -errno;
-		ULOGE("strdup: %s", strerror(-ret));
-		return ret;
-	}
-
-	while ((e = folder_next(folder, e)) != NULL) {
-		ret = asprintf(&tmp, "%s[%s] %s", e->name,
-				folder_entity_get_sha1(e), *list);
-		if (ret < 0) {
-			ULOGC("asprintf error");
-			return -ENOMEM;
-		}
-		free(*list);
-		*list = tmp;
-		(*count)++;
-	}
-	if ((*list)[0] != '\0')
-		(*list)[strlen((*list)) - 1] = '\0';
-
-	return 0;
-}
-
+/* answered from the snapshot of the folder, the live entities aren't walked */
 static int list_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	struct folder *folder;
-	char __attribute__((cleanup(ut_string_free))) *cmd = NULL;
-	char __attribute__((cleanup(ut_string_free))) *folder_name = NULL;
-	unsigned count;
-	char __attribute__((cleanup(ut_string_free))) *list = NULL;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const char *folder_name;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_LIST_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_LIST), &seqnum,
 			&folder_name);
 	if (ret < 0) {
-		cmd = folder_name = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
-	folder = folder_find(folder_name);
-	if (folder == NULL) {
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
 		ret = -errno;
-		ULOGE("folder_find: %s", strerror(-ret));
-		return ret;
-	}
-
-	ret = build_list(&list, folder, &count);
-	if (ret < 0) {
-		ULOGE("build_list: %s", strerror(-ret));
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
 		return ret;
 	}
 
-	return firmwared_answer(conn, FWD_ANSWER_LIST, FWD_FORMAT_ANSWER_LIST,
-			seqnum, folder_name, count, list);
+	return firmwared_answer(conn, FWD_ANSWER_LIST, FWD_FORMAT(ANSWER_LIST),
+			seqnum, folder_name, snapshot->nb_entities,
+			snapshot->list);
 }
 
 static const struct command list_command = {
@@ -99,6 +55,7 @@ static const struct command list_command = {
 				"a FOLDERS command.",
 		.synopsis = "FOLDER",
 		.handler = list_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
@@ -0,0 +1,119 @@
+/**
+ * @file list_page.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_list_page
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_list_page);
+
+#include "commands.h"
+#include "folders.h"
+#include "answer.h"
+
+/* used when COUNT is 0 or greater */
+#define LIST_PAGE_MAX_COUNT 1000
+
+/*
+ * the entities are paginated in the order of their sha1s, thus, the cursor, the
+ * sha1 of the last entity of the previous page, stays valid whatever the
+ * entities added or removed between two pages
+ */
+static int list_page_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const struct folder_entity_snapshot *es;
+	const char *folder_name;
+	const char *cursor;
+	uint32_t count;
+	unsigned start;
+	unsigned end;
+	unsigned i;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_LIST_PAGE), &seqnum,
+			&folder_name, &cursor, &count);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	if (count == 0 || count > LIST_PAGE_MAX_COUNT)
+		count = LIST_PAGE_MAX_COUNT;
+	start = folder_snapshot_seek(snapshot, cursor, true);
+	end = start + count;
+	if (end > snapshot->nb_entities)
+		end = snapshot->nb_entities;
+
+	ret = answer_init(&answer, FWD_ANSWER_LIST_PAGE, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, folder_name);
+	/* an empty next cursor means the last page has been reached */
+	answer_add_str(&answer, end == snapshot->nb_entities ? "" :
+			snapshot->by_sha1[end - 1]->sha1);
+	answer_add_u32(&answer, end - start);
+	for (i = start; i < end; i++) {
+		es = snapshot->by_sha1[i];
+		answer_add_str(&answer, es->sha1);
+		answer_add_str(&answer, es->name);
+	}
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command list_page_command = {
+		.msgid = FWD_COMMAND_LIST_PAGE,
+		.help = "Lists at most COUNT items of the folder FOLDER, "
+				"starting after the item whose sha1 is CURSOR.",
+		.long_help = "The items are sorted by sha1 and each one is "
+				"sent as a pair of arguments, its sha1 and its "
+				"name. An empty CURSOR starts from the first "
+				"item, the next page is obtained with the "
+				"CURSOR sent back in the answer, which is empty "
+				"after the last page. A COUNT of 0 or greater "
+				"than 1000 is treated as 1000.",
+		.synopsis = "FOLDER CURSOR COUNT",
+		.handler = list_page_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void list_page_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&list_page_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void list_page_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(list_page_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -21,7 +21,7 @@ ULOG_DECLARE_TAG(firmwared_command_ping);
 static int ping_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
-	return firmwared_answer(conn, FWD_ANSWER_PONG, FWD_FORMAT_ANSWER_PONG,
+	return firmwared_answer(conn, FWD_ANSWER_PONG, FWD_FORMAT(ANSWER_PONG),
 			seqnum);
 }
 
@@ -31,6 +31,7 @@ static const struct command ping_command = {
 				"notification.",
 		.synopsis = "PING",
 		.handler = ping_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
@@ -15,8 +15,6 @@
 
 #include <openssl/sha.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_prepare
@@ -24,6 +22,7 @@
 ULOG_DECLARE_TAG(firmwared_command_prepare);
 
 #include "commands.h"
+#include "clients.h"
 #include "utils.h"
 #include "firmwares.h"
 #include "instances.h"
@@ -34,20 +33,18 @@ static int prepare_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
-	char __attribute__((cleanup(ut_string_free))) *identification_string =
-			NULL;
+	const char *folder;
+	const char *identification_string;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_PREPARE_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_PREPARE), &seqnum,
 			&folder, &identification_string);
 	if (ret < 0) {
-		folder = identification_string = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
-	return folder_prepare(folder, identification_string, seqnum);
+	return folder_prepare(folder, identification_string, seqnum,
+			client_get_id(conn));
 }
 
 static const struct command prepare_command = {
@@ -68,7 +65,23 @@ static const struct command prepare_command = {
 				"or a friendly name of a previously registered "
 				"firmware. "
 				"A new instance will then be created and "
-				"registered from this firmware.",
+				"registered from this firmware.\n"
+				"IDENTIFICATION_STRING can be followed by "
+				"space-separated KEY=VALUE options, priority, "
+				"which can be high, normal or low and "
+				"template, the name of a template defined for "
+				"FOLDER, see DEFINE_TEMPLATE and detached, yes "
+				"or no, the default, yes letting the "
+				"preparation go on if the client disconnects, "
+				"see ABORT. "
+				"The preparations exceeding the configured "
+				"limits are queued, by priority class, then by "
+				"arrival order.\n"
+				"A firmware preparation identical to one in "
+				"progress, same IDENTIFICATION_STRING and "
+				"template or same firmware UUID, is attached "
+				"to it and gets the same notifications, with "
+				"its own sequence number.",
 		.synopsis = "FOLDER IDENTIFICATION_STRING",
 		.handler = prepare_command_handler,
 };
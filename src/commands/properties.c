@@ -16,8 +16,6 @@
 #include <ulog.h>
 ULOG_DECLARE_TAG(firmwared_command_properties);
 
-#include <ut_string.h>
-
 #include "commands.h"
 #include "folders.h"
 
@@ -25,26 +23,24 @@ static int properties_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *list = NULL;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const char *folder;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_PROPERTIES_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_PROPERTIES), &seqnum,
 			&folder);
 	if (ret < 0) {
-		folder = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
-	list = folder_list_properties(folder);
-	if (list == NULL) {
-		list = NULL;
+	snapshot = folder_get_snapshot(folder);
+	if (snapshot == NULL)
 		return -errno;
-	}
 
 	return firmwared_answer(conn, FWD_ANSWER_PROPERTIES,
-			FWD_FORMAT_ANSWER_PROPERTIES, seqnum, folder, list);
+			FWD_FORMAT(ANSWER_PROPERTIES), seqnum, folder,
+			snapshot->properties);
 }
 
 static const struct command properties_command = {
@@ -53,6 +49,7 @@ static const struct command properties_command = {
 				"properties for the folder FOLDER.",
 		.synopsis = "FOLDER",
 		.handler = properties_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
@@ -0,0 +1,195 @@
+/**
+ * @file query.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_query
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_query);
+
+#include "commands.h"
+#include "folders.h"
+#include "filter.h"
+#include "answer.h"
+
+#define QUERY_MAX_COLUMNS 32
+#define QUERY_DEFAULT_COLUMNS "sha1,name"
+
+/* the strings point inside the COLUMNS argument */
+struct query_columns {
+	unsigned nb;
+	const char *names[QUERY_MAX_COLUMNS];
+};
+
+static int parse_columns(char *str, struct query_columns *columns)
+{
+	char *saveptr = NULL;
+	char *column;
+
+	columns->nb = 0;
+	for (column = strtok_r(str, ",", &saveptr); column != NULL;
+			column = strtok_r(NULL, ",", &saveptr)) {
+		if (columns->nb == QUERY_MAX_COLUMNS)
+			return -E2BIG;
+		columns->names[columns->nb++] = column;
+	}
+
+	return columns->nb == 0 ? -EINVAL : 0;
+}
+
+static int check_columns(const struct folder_snapshot *snapshot,
+		const struct query_columns *columns)
+{
+	unsigned i;
+
+	for (i = 0; i < columns->nb; i++)
+		if (!folder_snapshot_has_property(snapshot, columns->names[i])) {
+			ULOGE("unknown property %s", columns->names[i]);
+			return -ESRCH;
+		}
+
+	return 0;
+}
+
+static int query_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const char *folder_name;
+	const char *filter_str;
+	const char *columns_str;
+	char *filter_copy;
+	char *columns_copy;
+	char default_columns[] = QUERY_DEFAULT_COLUMNS;
+	struct folder_entity_snapshot * const *candidates;
+	const struct folder_entity_snapshot **rows;
+	unsigned nb_candidates;
+	unsigned nb_rows = 0;
+	unsigned i;
+	unsigned j;
+	struct filter filter;
+	struct query_columns columns;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_QUERY), &seqnum,
+			&folder_name, &filter_str, &columns_str);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	/* parsing is done in place, the arguments are views on the message */
+	filter_copy = arena_strdup(command_arena(), filter_str);
+	columns_copy = arena_strdup(command_arena(), columns_str);
+	if (filter_copy == NULL || columns_copy == NULL)
+		return -errno;
+	ret = filter_parse(filter_copy, &filter);
+	if (ret < 0) {
+		ULOGE("filter_parse: %s", strerror(-ret));
+		return ret;
+	}
+	ret = parse_columns(columns_str[0] == '\0' ? default_columns :
+			columns_copy, &columns);
+	if (ret < 0) {
+		ULOGE("parse_columns: %s", strerror(-ret));
+		return ret;
+	}
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	ret = filter_check(&filter, snapshot);
+	if (ret < 0)
+		return ret;
+	ret = check_columns(snapshot, &columns);
+	if (ret < 0)
+		return ret;
+
+	filter_get_candidates(&filter, snapshot, &candidates, &nb_candidates);
+	rows = arena_alloc(command_arena(),
+			(nb_candidates + 1) * sizeof(*rows));
+	if (rows == NULL)
+		return -errno;
+	for (i = 0; i < nb_candidates; i++)
+		if (filter_match(&filter, candidates[i]))
+			rows[nb_rows++] = candidates[i];
+
+	ret = answer_init(&answer, FWD_ANSWER_QUERY, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, folder_name);
+	answer_add_u32(&answer, columns.nb);
+	answer_add_u32(&answer, nb_rows);
+	for (j = 0; j < columns.nb; j++)
+		answer_add_str(&answer, columns.names[j]);
+	for (i = 0; i < nb_rows; i++)
+		for (j = 0; j < columns.nb; j++)
+			answer_add_str(&answer,
+					folder_entity_snapshot_get_property(
+							rows[i],
+							columns.names[j]) ?: "");
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command query_command = {
+		.msgid = FWD_COMMAND_QUERY,
+		.help = "Retrieves the COLUMNS properties of the items of the "
+				"folder FOLDER matching FILTER.",
+		.long_help = "FILTER is a list of terms separated by AND, each "
+				"term being one of PROPERTY=VALUE, "
+				"PROPERTY!=VALUE, PROPERTY~PATTERN or "
+				"PROPERTY!~PATTERN, PATTERN being a shell "
+				"wildcard pattern. An empty FILTER or \"*\" "
+				"matches all the items. COLUMNS is a "
+				"comma-separated list of property names, empty "
+				"for \"sha1,name\". The answer contains the "
+				"column names, followed by the values of each "
+				"matching item, in no particular order. The "
+				"equality terms on the properties listed in "
+				"FIRMWARED_INDEXED_PROPERTIES are resolved "
+				"without scanning the whole folder.",
+		.synopsis = "FOLDER FILTER COLUMNS",
+		.handler = query_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void query_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&query_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void query_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(query_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -17,6 +17,7 @@
 ULOG_DECLARE_TAG(firmwared_command_quit);
 
 #include "commands.h"
+#include "clients.h"
 
 static int quit_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
@@ -26,7 +27,9 @@ static int quit_command_handler(struct pomp_conn *conn,
 
 	firmwared_stop();
 
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_BYEBYE, seqnum);
+	return firmwared_notify(&(struct notification_scope) {
+				.origin = client_get_id(conn),
+			}, ansid, FWD_FORMAT(ANSWER_BYEBYE), seqnum);
 
 }
 
@@ -10,8 +10,6 @@
 #include <string.h>
 #include <inttypes.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_remount
@@ -19,22 +17,21 @@
 ULOG_DECLARE_TAG(firmwared_command_remount);
 
 #include "commands.h"
+#include "clients.h"
 #include "instances.h"
 
 static int remount_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
+	const char *identifier;
 	struct folder_entity *entity;
 	struct instance *instance;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_REMOUNT_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_REMOUNT), &seqnum,
 			&identifier);
 	if (ret < 0) {
-		identifier = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -43,14 +40,12 @@ static int remount_command_handler(struct pomp_conn *conn,
 		return -errno;
 	instance = instance_from_entity(entity);
 
-	ret = instance_remount(instance);
-	if (ret < 0) {
+	/* REMOUNTED is notified when the union file system is remounted */
+	ret = instance_remount(instance, seqnum, client_get_id(conn));
+	if (ret < 0)
 		ULOGE("instance_remount %s", strerror(-ret));
-		return ret;
-	}
 
-	return firmwared_answer(conn, FWD_ANSWER_REMOUNTED,
-			FWD_FORMAT_ANSWER_REMOUNTED, seqnum);
+	return ret;
 }
 
 static const struct command remount_command = {
@@ -0,0 +1,80 @@
+/**
+ * @file set_deadline.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_set_deadline
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_set_deadline);
+
+#include "commands.h"
+#include "clients.h"
+
+static int set_deadline_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	uint32_t deadline;
+	struct client *client;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SET_DEADLINE), &seqnum,
+			&deadline);
+	if (ret < 0) {
+		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		return ret;
+	}
+	client = client_find(conn);
+	if (client == NULL)
+		return -errno;
+
+	client->deadline = deadline;
+
+	return firmwared_answer(conn, FWD_ANSWER_DEADLINE_SET,
+			FWD_FORMAT(ANSWER_DEADLINE_SET), seqnum, deadline);
+}
+
+static const struct command set_deadline_command = {
+		.msgid = FWD_COMMAND_SET_DEADLINE,
+		.help = "Sets the maximum time, in milliseconds, the following "
+				"commands of this connection can wait before "
+				"being executed.",
+		.long_help = "A command which waited longer is not executed and "
+				"is answered with an ERROR (ETIMEDOUT). "
+				"A DEADLINE of 0 disables the deadline, which "
+				"is the default.",
+		.synopsis = "DEADLINE",
+		.handler = set_deadline_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void set_deadline_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&set_deadline_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void set_deadline_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(set_deadline_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -0,0 +1,243 @@
+/**
+ * @file set_properties.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#define _GNU_SOURCE
+#include <stdlib.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_command_set_properties
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_set_properties);
+
+#include "commands.h"
+#include "folders.h"
+#include "answer.h"
+
+#define SET_PROPERTIES_MAX_COUNT 0x10000
+
+struct property_update {
+	/* the three point inside the command message */
+	const char *identifier;
+	const char *name;
+	const char *value;
+	struct folder_entity *entity;
+	/* positive errno, 0 on success */
+	int32_t error;
+	/*
+	 * for atomic updates, value of the property before the update, the
+	 * whole array for an array access, so that it can be restored
+	 */
+	const char *saved_name;
+	char *saved_value;
+};
+
+static void free_saved_values(struct property_update **updates)
+{
+	struct property_update *u = *updates;
+
+	if (u == NULL)
+		return;
+	/* the array is terminated by an element with a NULL identifier */
+	for (; u->identifier != NULL; u++)
+		ut_string_free(&u->saved_value);
+}
+
+static int save_property(struct property_update *update)
+{
+	update->saved_name = arena_strndup(command_arena(), update->name,
+			strcspn(update->name, "["));
+	if (update->saved_name == NULL)
+		return -errno;
+
+	return folder_entity_get_property(update->entity, update->saved_name,
+			&update->saved_value);
+}
+
+static void restore_property(struct property_update *update)
+{
+	int ret;
+	char *first;
+
+	/* an empty array can't be set as a whole, it is truncated instead */
+	if (update->saved_value[0] == '\0') {
+		first = arena_printf(command_arena(), "%s[0]",
+				update->saved_name);
+		if (first == NULL) {
+			ULOGE("arena_printf: %m");
+			return;
+		}
+		ret = folder_entity_set_property(update->entity, first, "nil");
+	} else {
+		ret = folder_entity_set_property(update->entity,
+				update->saved_name, update->saved_value);
+	}
+	if (ret < 0)
+		ULOGE("restoring %s of %s failed: %s", update->saved_name,
+				update->identifier, strerror(-ret));
+}
+
+/*
+ * the previous values are retrieved before anything is modified, on error, the
+ * updates already applied are reverted in the reverse order, the others are
+ * marked as canceled
+ */
+static void update_properties_atomic(struct property_update *updates,
+		uint32_t count)
+{
+	int ret;
+	uint32_t i;
+	uint32_t failed = count;
+
+	for (i = 0; i < count; i++) {
+		if (updates[i].entity == NULL) {
+			failed = i;
+			break;
+		}
+		ret = save_property(updates + i);
+		if (ret < 0) {
+			updates[i].error = -ret;
+			failed = i;
+			break;
+		}
+	}
+	for (i = 0; failed == count && i < count; i++) {
+		ret = folder_entity_set_property(updates[i].entity,
+				updates[i].name, updates[i].value);
+		if (ret < 0) {
+			updates[i].error = -ret;
+			failed = i;
+			while (i-- > 0)
+				restore_property(updates + i);
+		}
+	}
+	if (failed == count)
+		return;
+
+	for (i = 0; i < count; i++)
+		if (i != failed)
+			updates[i].error = ECANCELED;
+}
+
+static int set_properties_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct property_update __attribute__((cleanup(free_saved_values)))
+			*updates = NULL;
+	struct property_update *update;
+	const char *folder;
+	uint32_t atomic;
+	uint32_t count;
+	uint32_t i;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SET_PROPERTIES), &seqnum,
+			&folder, &atomic, &count);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	if (count > SET_PROPERTIES_MAX_COUNT)
+		return -E2BIG;
+	updates = arena_alloc(command_arena(), (count + 1) * sizeof(*updates));
+	if (updates == NULL)
+		return -errno;
+	for (i = 0; i < count; i++) {
+		update = updates + i;
+		ret = command_read_more("%s%s%s", &update->identifier,
+				&update->name, &update->value);
+		if (ret < 0)
+			return ret;
+	}
+
+	for (i = 0; i < count; i++) {
+		update = updates + i;
+		update->entity = folder_find_entity(folder, update->identifier);
+		if (update->entity == NULL)
+			update->error = errno;
+	}
+	if (atomic) {
+		update_properties_atomic(updates, count);
+	} else {
+		for (i = 0; i < count; i++) {
+			update = updates + i;
+			if (update->entity == NULL)
+				continue;
+			ret = folder_entity_set_property(update->entity,
+					update->name, update->value);
+			if (ret < 0)
+				update->error = -ret;
+		}
+	}
+
+	ret = answer_init(&answer, FWD_ANSWER_PROPERTIES_SET, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, folder);
+	answer_add_u32(&answer, atomic);
+	answer_add_u32(&answer, count);
+	for (i = 0; i < count; i++) {
+		answer_add_str(&answer, updates[i].identifier);
+		answer_add_str(&answer, updates[i].name);
+		answer_add_i32(&answer, updates[i].error);
+	}
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command set_properties_command = {
+		.msgid = FWD_COMMAND_SET_PROPERTIES,
+		.help = "Sets the values of COUNT properties, each one "
+				"designated by a triplet of arguments, the "
+				"identifier of an entity of the folder FOLDER, "
+				"a property name and the value to set.",
+		.long_help = "The properties are set in order, array "
+				"properties items are accessed as with "
+				"SET_PROPERTY. If ATOMIC is not 0, either all "
+				"the properties are set, or none is, the "
+				"values set before a failure being restored. "
+				"The answer contains, for each triplet, the "
+				"entity identifier, the property name and an "
+				"errno, 0 on success, ECANCELED for the "
+				"properties not set or restored because of "
+				"the failure of another one.",
+		.synopsis = "FOLDER ATOMIC COUNT "
+				"(ENTITY_IDENTIFIER PROPERTY_NAME "
+				"PROPERTY_VALUE)...",
+		.handler = set_properties_command_handler,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void set_properties_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&set_properties_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void set_properties_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(set_properties_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -16,8 +16,6 @@
 
 #include <openssl/sha.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_set_property
@@ -34,20 +32,18 @@ static int set_property_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *folder = NULL;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
-	char __attribute__((cleanup(ut_string_free))) *name = NULL;
-	char __attribute__((cleanup(ut_string_free))) *value = NULL;
+	const char *folder;
+	const char *identifier;
+	const char *name;
+	const char *value;
 	struct folder_entity *entity;
 	uint32_t msgid = pomp_msg_get_id(msg);
 	enum fwd_message ansid = fwd_message_command_answer(msgid);
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_SET_PROPERTY_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SET_PROPERTY), &seqnum,
 			&folder, &identifier, &name, &value);
 	if (ret < 0) {
-		folder = identifier = name = value = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -60,8 +56,8 @@ static int set_property_command_handler(struct pomp_conn *conn,
 		return ret;
 	}
 
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_PROPERTY_SET, seqnum,
-			folder, identifier, name, value);
+	return firmwared_answer(conn, ansid, FWD_FORMAT(ANSWER_PROPERTY_SET),
+			seqnum, folder, identifier, name, value);
 }
 
 static const struct command set_property_command = {
@@ -14,8 +14,6 @@
 
 #include <libpomp.h>
 
-#include <ut_string.h>
-
 #define ULOG_TAG firmwared_command_show
 #include <ulog.h>
 ULOG_DECLARE_TAG(firmwared_command_show);
@@ -27,36 +25,34 @@ static int show_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	struct folder_entity *entity;
-	char __attribute__((cleanup(ut_string_free))) *folder_name = NULL;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
-	char __attribute__((cleanup(ut_string_free))) *info = NULL;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const struct folder_entity_snapshot *entity;
+	const char *folder_name;
+	const char *identifier;
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_SHOW_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SHOW), &seqnum,
 			&folder_name, &identifier);
 	if (ret < 0) {
-		folder_name = identifier = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
-	entity = folder_find_entity(folder_name, identifier);
-	if (entity == NULL) {
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
 		ret = -errno;
-		ULOGE("folder_find_entity: %s", strerror(-ret));
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
 		return ret;
 	}
-
-	info = folder_get_info(folder_name, identifier);
-	if (info == NULL) {
+	entity = folder_snapshot_find(snapshot, identifier);
+	if (entity == NULL) {
 		ret = -errno;
-		ULOGE("folder_find_entity: %m");
+		ULOGE("folder_snapshot_find: %s", strerror(-ret));
 		return ret;
 	}
 
-	return firmwared_answer(conn, FWD_ANSWER_SHOW, FWD_FORMAT_ANSWER_SHOW,
-			seqnum, folder_name, folder_entity_get_sha1(entity),
-			entity->name, info);
+	return firmwared_answer(conn, FWD_ANSWER_SHOW, FWD_FORMAT(ANSWER_SHOW),
+			seqnum, folder_name, entity->sha1, entity->name,
+			entity->info);
 }
 
 static const struct command show_command = {
@@ -65,6 +61,7 @@ static const struct command show_command = {
 				"folder.",
 		.synopsis = "FOLDER IDENTIFIER",
 		.handler = show_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
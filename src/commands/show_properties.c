@@ -0,0 +1,102 @@
+/**
+ * @file show_properties.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_show_properties
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_show_properties);
+
+#include "commands.h"
+#include "folders.h"
+#include "answer.h"
+
+static int show_properties_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	const struct folder_entity_snapshot *es;
+	const char *folder_name;
+	const char *identifier;
+	unsigned i;
+	struct answer answer;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SHOW_PROPERTIES),
+			&seqnum, &folder_name, &identifier);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	snapshot = folder_get_snapshot(folder_name);
+	if (snapshot == NULL) {
+		ret = -errno;
+		ULOGE("folder_get_snapshot: %s", strerror(-ret));
+		return ret;
+	}
+	es = folder_snapshot_find(snapshot, identifier);
+	if (es == NULL) {
+		ret = -errno;
+		ULOGE("folder_snapshot_find: %s", strerror(-ret));
+		return ret;
+	}
+
+	ret = answer_init(&answer, FWD_ANSWER_SHOW_PROPERTIES, seqnum);
+	if (ret < 0)
+		return ret;
+	answer_add_str(&answer, folder_name);
+	answer_add_str(&answer, es->sha1);
+	answer_add_str(&answer, es->name);
+	answer_add_u32(&answer, es->nb_properties);
+	for (i = 0; i < es->nb_properties; i++) {
+		answer_add_str(&answer, es->properties[i].name);
+		answer_add_str(&answer, es->properties[i].value);
+	}
+
+	return answer_send(&answer, conn);
+}
+
+static const struct command show_properties_command = {
+		.msgid = FWD_COMMAND_SHOW_PROPERTIES,
+		.help = "Asks for all the properties of a given entity of a "
+				"folder, as separate arguments.",
+		.long_help = "Same as SHOW, but each property is sent as a "
+				"pair of arguments, its name and its value, "
+				"instead of being formatted in one string.",
+		.synopsis = "FOLDER IDENTIFIER",
+		.handler = show_properties_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void show_properties_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&show_properties_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void show_properties_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(show_properties_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
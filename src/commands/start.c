@@ -10,8 +10,6 @@
 #include <string.h>
 #include <inttypes.h>
 
-#include <ut_string.h>
-
 #include <libpomp.h>
 
 #define ULOG_TAG firmwared_command_start
@@ -19,6 +17,7 @@
 ULOG_DECLARE_TAG(firmwared_command_start);
 
 #include "commands.h"
+#include "clients.h"
 #include "firmwares.h"
 #include "instances.h"
 #include "folders.h"
@@ -27,18 +26,14 @@ static int start_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
 	int ret;
-	char __attribute__((cleanup(ut_string_free))) *identifier = NULL;
+	const char *identifier;
 	struct folder_entity *entity;
 	struct instance *instance;
-	uint32_t msgid = pomp_msg_get_id(msg);
-	enum fwd_message ansid = fwd_message_command_answer(msgid);
 
-	/* coverity[bad_printf_format_string] */
-	ret = pomp_msg_read(msg, FWD_FORMAT_COMMAND_START_READ, &seqnum,
+	ret = command_read(msg, FWD_FORMAT(COMMAND_START), &seqnum,
 			&identifier);
 	if (ret < 0) {
-		identifier = NULL;
-		ULOGE("pomp_msg_read: %s", strerror(-ret));
+		ULOGE("command_read: %s", strerror(-ret));
 		return ret;
 	}
 
@@ -46,13 +41,9 @@ static int start_command_handler(struct pomp_conn *conn,
 	if (entity == NULL)
 		return -errno;
 	instance = instance_from_entity(entity);
-	ret = instance_start(instance);
-	if (ret < 0)
-		return ret;
 
-	return firmwared_notify(ansid, FWD_FORMAT_ANSWER_STARTED, seqnum,
-			instance_get_sha1(instance),
-			instance_get_name(instance));
+	/* STARTED is notified when the instance's start sequence is over */
+	return instance_start(instance, seqnum, client_get_id(conn));
 }
 
 static const struct command start_command = {
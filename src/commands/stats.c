@@ -0,0 +1,92 @@
+/**
+ * @file stats.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_command_stats
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_stats);
+
+#include "commands.h"
+#include "clients.h"
+#include "watchdog.h"
+
+static int stats_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *stats = NULL;
+	char __attribute__((cleanup(ut_string_free))) *clients_stats = NULL;
+
+	stats = watchdog_get_stats();
+	if (stats == NULL) {
+		ret = -errno;
+		ULOGE("watchdog_get_stats: %m");
+		return ret;
+	}
+	clients_stats = clients_get_stats();
+	if (clients_stats == NULL) {
+		ret = -errno;
+		ULOGE("clients_get_stats: %m");
+		return ret;
+	}
+	ret = ut_string_append(&stats, "%s", clients_stats);
+	if (ret < 0) {
+		ULOGE("ut_string_append: %s", strerror(-ret));
+		return ret;
+	}
+
+	return firmwared_answer(conn, FWD_ANSWER_STATS,
+			FWD_FORMAT(ANSWER_STATS), seqnum, stats);
+}
+
+static const struct command stats_command = {
+		.msgid = FWD_COMMAND_STATS,
+		.help = "Sends back statistics on the responsiveness of "
+				"firmwared.",
+		.long_help = "The loop lag histogram counts the main loop "
+				"iterations by the time spent in callbacks, "
+				"during which no other event could be "
+				"processed. "
+				"The output counters report the messages "
+				"coalesced or dropped and the clients "
+				"disconnected because they were too slow to "
+				"read their messages.",
+		.synopsis = "",
+		.handler = stats_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void stats_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&stats_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void stats_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(stats_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
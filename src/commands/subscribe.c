@@ -0,0 +1,94 @@
+/**
+ * @file subscribe.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_subscribe
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_subscribe);
+
+#include "commands.h"
+#include "clients.h"
+
+static int subscribe_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	const char *folders;
+	const char *entities;
+	const char *notifications;
+	struct client *client;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_SUBSCRIBE), &seqnum,
+			&folders, &entities, &notifications);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	client = client_find(conn);
+	if (client == NULL)
+		return -errno;
+
+	ret = client_subscribe(client, folders, entities, notifications);
+	if (ret < 0) {
+		ULOGE("client_subscribe: %s", strerror(-ret));
+		return ret;
+	}
+
+	return firmwared_answer(conn, FWD_ANSWER_SUBSCRIBED,
+			FWD_FORMAT(ANSWER_SUBSCRIBED), seqnum, folders,
+			entities, notifications);
+}
+
+static const struct command subscribe_command = {
+		.msgid = FWD_COMMAND_SUBSCRIBE,
+		.help = "Restricts the notifications sent to this connection "
+				"to those concerning the folders FOLDERS, the "
+				"entities ENTITIES and of types NOTIFICATIONS.",
+		.long_help = "Each parameter is a comma-separated list, or * "
+				"to match anything, ENTITIES contains sha1s or "
+				"names and NOTIFICATIONS, answer names, e.g. "
+				"DEAD,STARTED. "
+				"Subscribing to BATCH groups the DEAD, DROPPED "
+				"and PREPARED notifications emitted at once. "
+				"The notifications resulting from the commands "
+				"sent on this connection are always received. "
+				"Until it sends a SUBSCRIBE command, a "
+				"connection receives all the notifications, "
+				"each SUBSCRIBE replaces the previous one.",
+		.synopsis = "FOLDERS ENTITIES NOTIFICATIONS",
+		.handler = subscribe_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void subscribe_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&subscribe_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void subscribe_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(subscribe_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -0,0 +1,84 @@
+/**
+ * @file unwatch.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_unwatch
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_unwatch);
+
+#include "commands.h"
+#include "clients.h"
+
+static int unwatch_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	const char *folder;
+	const char *entity;
+	const char *property;
+	struct client *client;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_UNWATCH), &seqnum,
+			&folder, &entity, &property);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	client = client_find(conn);
+	if (client == NULL)
+		return -errno;
+
+	ret = client_unwatch(client, folder, entity, property);
+	if (ret < 0) {
+		ULOGE("client_unwatch: %s", strerror(-ret));
+		return ret;
+	}
+
+	return firmwared_answer(conn, FWD_ANSWER_UNWATCHED,
+			FWD_FORMAT(ANSWER_UNWATCHED), seqnum, folder, entity,
+			property);
+}
+
+static const struct command unwatch_command = {
+		.msgid = FWD_COMMAND_UNWATCH,
+		.help = "Stops watching the property PROPERTY of the entity "
+				"ENTITY of the folder FOLDER.",
+		.long_help = "The parameters must be the same as those of the "
+				"corresponding WATCH command.",
+		.synopsis = "FOLDER ENTITY PROPERTY",
+		.handler = unwatch_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void unwatch_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&unwatch_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void unwatch_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(unwatch_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -16,8 +16,6 @@
 
 #include <libpomp.h>
 
-#include <ut_string.h>
-
 #include <firmwared-revision.h>
 
 #define ULOG_TAG firmwared_command_version
@@ -29,19 +27,12 @@ ULOG_DECLARE_TAG(firmwared_command_version);
 static int version_command_handler(struct pomp_conn *conn,
 		const struct pomp_msg *msg, uint32_t seqnum)
 {
-	int ret;
-	char __attribute__((cleanup(ut_string_free))) *version = NULL;
-
-	ret = asprintf(&version, "Compilation time: "__DATE__" - "__TIME__"\n"
-			"Version: "ALCHEMY_REVISION_FIRMWARED"\n");
-	if (ret < 0) {
-		version = NULL;
-		ULOGE("asprintf error");
-		return -ENOMEM;
-	}
+	static const char version[] = "Compilation time: "__DATE__" - "
+			__TIME__"\n"
+			"Version: "ALCHEMY_REVISION_FIRMWARED"\n";
 
 	return firmwared_answer(conn, FWD_ANSWER_VERSION,
-			FWD_FORMAT_ANSWER_VERSION, seqnum, version);
+			FWD_FORMAT(ANSWER_VERSION), seqnum, version);
 }
 
 static const struct command version_command = {
@@ -50,6 +41,7 @@ static const struct command version_command = {
 				"program's version.",
 		.synopsis = "",
 		.handler = version_command_handler,
+		.read_only = true,
 };
 
 static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
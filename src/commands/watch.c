@@ -0,0 +1,101 @@
+/**
+ * @file watch.c
+ * @brief
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <errno.h>
+#include <string.h>
+#include <inttypes.h>
+
+#include <libpomp.h>
+
+#define ULOG_TAG firmwared_command_watch
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_command_watch);
+
+#include "commands.h"
+#include "clients.h"
+#include "folders.h"
+
+static int watch_command_handler(struct pomp_conn *conn,
+		const struct pomp_msg *msg, uint32_t seqnum)
+{
+	int ret;
+	const char *folder;
+	const char *entity;
+	const char *property;
+	struct folder_snapshot __attribute__((cleanup(folder_snapshot_unref)))
+			*snapshot = NULL;
+	struct client *client;
+
+	ret = command_read(msg, FWD_FORMAT(COMMAND_WATCH), &seqnum,
+			&folder, &entity, &property);
+	if (ret < 0) {
+		ULOGE("command_read: %s", strerror(-ret));
+		return ret;
+	}
+	client = client_find(conn);
+	if (client == NULL)
+		return -errno;
+
+	ret = client_watch(client, folder, entity, property);
+	if (ret < 0) {
+		ULOGE("client_watch: %s", strerror(-ret));
+		return ret;
+	}
+	/*
+	 * builds the snapshots of the folder's entities, the values the next
+	 * changes will be compared to
+	 */
+	snapshot = folder_get_snapshot(folder);
+	if (snapshot == NULL)
+		ULOGW("folder_get_snapshot: %m");
+
+	return firmwared_answer(conn, FWD_ANSWER_WATCHED,
+			FWD_FORMAT(ANSWER_WATCHED), seqnum, folder, entity,
+			property);
+}
+
+static const struct command watch_command = {
+		.msgid = FWD_COMMAND_WATCH,
+		.help = "Asks to be sent a PROPERTY_CHANGED notification each "
+				"time the property PROPERTY of the entity "
+				"ENTITY of the folder FOLDER changes.",
+		.long_help = "ENTITY is a sha1 or a name, ENTITY and PROPERTY "
+				"can be * to match anything. The changes are "
+				"notified whatever their origin, e.g. a "
+				"SET_PROPERTY command or an instance changing "
+				"state, and whatever the SUBSCRIBE filters. "
+				"A connection can watch at most 128 "
+				"properties, the watches are dropped with the "
+				"connection or by UNWATCH.",
+		.synopsis = "FOLDER ENTITY PROPERTY",
+		.handler = watch_command_handler,
+		.read_only = true,
+};
+
+static __attribute__((constructor(COMMAND_CONSTRUCTOR_PRIORITY)))
+		void watch_init(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_register(&watch_command);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
+
+static __attribute__((destructor)) void watch_cleanup(void)
+{
+	int ret;
+
+	ULOGD("%s", __func__);
+
+	ret = command_unregister(watch_command.msgid);
+	if (ret < 0)
+		ULOGE("command_register: %s", strerror(-ret));
+}
@@ -16,6 +16,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <limits.h>
 
 #include <regex.h>
 
@@ -105,6 +106,82 @@ ULOG_DECLARE_TAG(firmwared_config);
 #define VERBOSE_HOOK_SCRIPTS "n"
 #endif /* VERBOSE_HOOK_SCRIPTS */
 
+#ifndef TEMPLATES
+#define TEMPLATES ""
+#endif /* TEMPLATES */
+
+#ifndef WORKERS
+#define WORKERS "4"
+#endif /* WORKERS */
+
+#ifndef GROUP_PARALLELISM
+#define GROUP_PARALLELISM "8"
+#endif /* GROUP_PARALLELISM */
+
+#ifndef INDEXED_PROPERTIES
+#define INDEXED_PROPERTIES ""
+#endif /* INDEXED_PROPERTIES */
+
+#ifndef JOURNAL_SIZE
+#define JOURNAL_SIZE "1000"
+#endif /* JOURNAL_SIZE */
+
+#ifndef LAG_THRESHOLD
+#define LAG_THRESHOLD "100"
+#endif /* LAG_THRESHOLD */
+
+#ifndef LISTEN
+#define LISTEN ""
+#endif /* LISTEN */
+
+#ifndef MAX_FIRMWARE_PREPARATIONS
+#define MAX_FIRMWARE_PREPARATIONS "2"
+#endif /* MAX_FIRMWARE_PREPARATIONS */
+
+#ifndef MAX_INSTANCE_PREPARATIONS
+#define MAX_INSTANCE_PREPARATIONS "4"
+#endif /* MAX_INSTANCE_PREPARATIONS */
+
+#ifndef MAX_PREPARATIONS
+#define MAX_PREPARATIONS "4"
+#endif /* MAX_PREPARATIONS */
+
+#ifndef MAX_OUTPUT_BYTES
+#define MAX_OUTPUT_BYTES "1048576"
+#endif /* MAX_OUTPUT_BYTES */
+
+#ifndef MAX_OUTPUT_MESSAGES
+#define MAX_OUTPUT_MESSAGES "1024"
+#endif /* MAX_OUTPUT_MESSAGES */
+
+#ifndef ACK_POLICY
+#define ACK_POLICY "disconnect"
+#endif /* ACK_POLICY */
+
+#ifndef NOTIFICATION_POLICY
+#define NOTIFICATION_POLICY "drop_oldest"
+#endif /* NOTIFICATION_POLICY */
+
+#ifndef STATUS_PATH
+#define STATUS_PATH "/dev/shm/firmwared.status"
+#endif /* STATUS_PATH */
+
+#ifndef STATUS_SLOTS
+#define STATUS_SLOTS "256"
+#endif /* STATUS_SLOTS */
+
+#ifndef PROGRESS_INTERVAL
+#define PROGRESS_INTERVAL "2000"
+#endif /* PROGRESS_INTERVAL */
+
+#ifndef PROGRESS_STEP
+#define PROGRESS_STEP "10"
+#endif /* PROGRESS_STEP */
+
+#ifndef PROGRESS_POLICY
+#define PROGRESS_POLICY "coalesce"
+#endif /* PROGRESS_POLICY */
+
 typedef bool (*validate_cb_t)(const char *value);
 
 struct config {
@@ -184,6 +261,42 @@ static bool valid_yes_no(const char *value)
 	return valid;
 }
 
+static bool valid_strictly_positive_int(const char *value)
+{
+	long l;
+	char *endptr;
+	bool valid;
+
+	if (value == NULL)
+		return false;
+
+	errno = 0;
+	l = strtol(value, &endptr, 0);
+	valid = errno == 0 && *value != '\0' && *endptr == '\0' && l > 0 &&
+			l <= INT_MAX;
+	if (!valid)
+		ULOGE("%s isn't a strictly positive integer", value);
+
+	return valid;
+}
+
+static bool valid_output_policy(const char *value)
+{
+	bool valid;
+
+	if (value == NULL)
+		return false;
+
+	valid = ut_string_match("coalesce", value) ||
+			ut_string_match("drop_oldest", value) ||
+			ut_string_match("disconnect", value);
+	if (!valid)
+		ULOGE("%s is neither \"coalesce\", \"drop_oldest\" nor "
+				"\"disconnect\"", value);
+
+	return valid;
+}
+
 static bool valid_interface(const char *value)
 {
 	bool valid;
@@ -264,6 +377,11 @@ static bool valid_net_first_two_bytes(const char *value)
 }
 
 static struct config configs[CONFIG_NB] = {
+		[CONFIG_ACK_POLICY] = {
+				.env = CONFIG_KEYS_PREFIX"ACK_POLICY",
+				.default_value = ACK_POLICY,
+				.valid = valid_output_policy,
+		},
 		[CONFIG_APPARMOR_PROFILE] = {
 				.env = CONFIG_KEYS_PREFIX"APPARMOR_PROFILE",
 				.default_value = APPARMOR_PROFILE_DEFAULT,
@@ -289,12 +407,62 @@ static struct config configs[CONFIG_NB] = {
 				.default_value = DUMP_PROFILE,
 				.valid = valid_yes_no,
 		},
+		[CONFIG_GROUP_PARALLELISM] = {
+				.env = CONFIG_KEYS_PREFIX"GROUP_PARALLELISM",
+				.default_value = GROUP_PARALLELISM,
+				.valid = valid_strictly_positive_int,
+		},
 		[CONFIG_HOST_INTERFACE_PREFIX] = {
 				.env = CONFIG_KEYS_PREFIX
 					"HOST_INTERFACE_PREFIX",
 				.default_value = HOST_INTERFACE_PREFIX,
 				.valid = valid_interface_prefix,
 		},
+		[CONFIG_INDEXED_PROPERTIES] = {
+				.env = CONFIG_KEYS_PREFIX"INDEXED_PROPERTIES",
+				.default_value = INDEXED_PROPERTIES,
+		},
+		[CONFIG_JOURNAL_SIZE] = {
+				.env = CONFIG_KEYS_PREFIX"JOURNAL_SIZE",
+				.default_value = JOURNAL_SIZE,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_LAG_THRESHOLD] = {
+				.env = CONFIG_KEYS_PREFIX"LAG_THRESHOLD",
+				.default_value = LAG_THRESHOLD,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_LISTEN] = {
+				.env = CONFIG_KEYS_PREFIX"LISTEN",
+				.default_value = LISTEN,
+		},
+		[CONFIG_MAX_FIRMWARE_PREPARATIONS] = {
+				.env = CONFIG_KEYS_PREFIX
+					"MAX_FIRMWARE_PREPARATIONS",
+				.default_value = MAX_FIRMWARE_PREPARATIONS,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_MAX_INSTANCE_PREPARATIONS] = {
+				.env = CONFIG_KEYS_PREFIX
+					"MAX_INSTANCE_PREPARATIONS",
+				.default_value = MAX_INSTANCE_PREPARATIONS,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_MAX_OUTPUT_BYTES] = {
+				.env = CONFIG_KEYS_PREFIX"MAX_OUTPUT_BYTES",
+				.default_value = MAX_OUTPUT_BYTES,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_MAX_OUTPUT_MESSAGES] = {
+				.env = CONFIG_KEYS_PREFIX"MAX_OUTPUT_MESSAGES",
+				.default_value = MAX_OUTPUT_MESSAGES,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_MAX_PREPARATIONS] = {
+				.env = CONFIG_KEYS_PREFIX"MAX_PREPARATIONS",
+				.default_value = MAX_PREPARATIONS,
+				.valid = valid_strictly_positive_int,
+		},
 		[CONFIG_MOUNT_HOOK] = {
 				.env = CONFIG_KEYS_PREFIX"MOUNT_HOOK",
 				.default_value = MOUNT_HOOK_DEFAULT,
@@ -315,6 +483,11 @@ static struct config configs[CONFIG_NB] = {
 				.default_value = NET_HOOK_DEFAULT,
 				.valid = valid_executable,
 		},
+		[CONFIG_NOTIFICATION_POLICY] = {
+				.env = CONFIG_KEYS_PREFIX"NOTIFICATION_POLICY",
+				.default_value = NOTIFICATION_POLICY,
+				.valid = valid_output_policy,
+		},
 		[CONFIG_POST_PREPARE_INSTANCE_HOOK] = {
 				.env = CONFIG_KEYS_PREFIX
 					"POST_PREPARE_INSTANCE_HOOK",
@@ -327,6 +500,21 @@ static struct config configs[CONFIG_NB] = {
 				.default_value = PREVENT_REMOVAL,
 				.valid = valid_yes_no,
 		},
+		[CONFIG_PROGRESS_INTERVAL] = {
+				.env = CONFIG_KEYS_PREFIX"PROGRESS_INTERVAL",
+				.default_value = PROGRESS_INTERVAL,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_PROGRESS_POLICY] = {
+				.env = CONFIG_KEYS_PREFIX"PROGRESS_POLICY",
+				.default_value = PROGRESS_POLICY,
+				.valid = valid_output_policy,
+		},
+		[CONFIG_PROGRESS_STEP] = {
+				.env = CONFIG_KEYS_PREFIX"PROGRESS_STEP",
+				.default_value = PROGRESS_STEP,
+				.valid = valid_strictly_positive_int,
+		},
 		[CONFIG_RESOURCES_DIR] = {
 				.env = CONFIG_KEYS_PREFIX"RESOURCES_DIR",
 				.default_value = FOLDERS_RESOURCES_DIR_DEFAULT,
@@ -342,6 +530,24 @@ static struct config configs[CONFIG_NB] = {
 				.default_value = SOCKET_PATH_DEFAULT,
 				.valid = valid_accessible,
 		},
+		[CONFIG_STATUS_PATH] = {
+				.env = CONFIG_KEYS_PREFIX"STATUS_PATH",
+				.default_value = STATUS_PATH,
+		},
+		[CONFIG_STATUS_SLOTS] = {
+				.env = CONFIG_KEYS_PREFIX"STATUS_SLOTS",
+				.default_value = STATUS_SLOTS,
+				.valid = valid_strictly_positive_int,
+		},
+		[CONFIG_TEMPLATES] = {
+				.env = CONFIG_KEYS_PREFIX"TEMPLATES",
+				.default_value = TEMPLATES,
+		},
+		[CONFIG_WORKERS] = {
+				.env = CONFIG_KEYS_PREFIX"WORKERS",
+				.default_value = WORKERS,
+				.valid = valid_strictly_positive_int,
+		},
 		[CONFIG_X11_PATH] = {
 				.env = CONFIG_KEYS_PREFIX"X11_PATH",
 				.default_value = X11_PATH_DEFAULT,
@@ -517,6 +723,12 @@ bool config_get_bool(enum config_key key)
 	return value == NULL ? false : is_yes(value);
 }
 
+/* only valid for the keys validated as integers */
+int config_get_int(enum config_key key)
+{
+	return strtol(config_get(key), NULL, 0);
+}
+
 char *config_list_keys(void)
 {
 	int ret;
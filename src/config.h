@@ -17,21 +17,40 @@
 enum config_key {
 	CONFIG_FIRST,
 
-	CONFIG_APPARMOR_PROFILE = CONFIG_FIRST,
+	CONFIG_ACK_POLICY = CONFIG_FIRST,
+	CONFIG_APPARMOR_PROFILE,
 	CONFIG_CONTAINER_INTERFACE,
 	CONFIG_CURL_HOOK,
 	CONFIG_DISABLE_APPARMOR,
 	CONFIG_DUMP_PROFILE,
+	CONFIG_GROUP_PARALLELISM,
 	CONFIG_HOST_INTERFACE_PREFIX,
+	CONFIG_INDEXED_PROPERTIES,
+	CONFIG_JOURNAL_SIZE,
+	CONFIG_LAG_THRESHOLD,
+	CONFIG_LISTEN,
+	CONFIG_MAX_FIRMWARE_PREPARATIONS,
+	CONFIG_MAX_INSTANCE_PREPARATIONS,
+	CONFIG_MAX_OUTPUT_BYTES,
+	CONFIG_MAX_OUTPUT_MESSAGES,
+	CONFIG_MAX_PREPARATIONS,
 	CONFIG_MOUNT_HOOK,
 	CONFIG_MOUNT_PATH,
 	CONFIG_NET_FIRST_TWO_BYTES,
 	CONFIG_NET_HOOK,
+	CONFIG_NOTIFICATION_POLICY,
 	CONFIG_POST_PREPARE_INSTANCE_HOOK,
 	CONFIG_PREVENT_REMOVAL,
+	CONFIG_PROGRESS_INTERVAL,
+	CONFIG_PROGRESS_POLICY,
+	CONFIG_PROGRESS_STEP,
 	CONFIG_RESOURCES_DIR,
 	CONFIG_REPOSITORY_PATH,
 	CONFIG_SOCKET_PATH,
+	CONFIG_STATUS_PATH,
+	CONFIG_STATUS_SLOTS,
+	CONFIG_TEMPLATES,
+	CONFIG_WORKERS,
 	CONFIG_X11_PATH,
 	CONFIG_NVIDIA_PATH,
 	CONFIG_VERBOSE_HOOK_SCRIPTS,
@@ -43,6 +62,7 @@ int config_init(const char *path);
 enum config_key config_key_from_string(const char *key);
 const char *config_get(enum config_key);
 bool config_get_bool(enum config_key);
+int config_get_int(enum config_key);
 char *config_list_keys(void);
 void config_cleanup(void);
 
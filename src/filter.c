@@ -0,0 +1,143 @@
+/**
+ * @file filter.c
+ * @brief predicates on the properties of the entities of a folder snapshot
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <string.h>
+#include <errno.h>
+#include <fnmatch.h>
+
+#define ULOG_TAG firmwared_filter
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_filter);
+
+#include <ut_string.h>
+
+#include "filter.h"
+
+/* the property name is terminated in place, on the operator */
+static int parse_term(char *str, struct filter_term *term)
+{
+	char *op;
+
+	op = strpbrk(str, "!=~");
+	if (op == NULL || op == str)
+		return -EINVAL;
+
+	term->property = str;
+	term->negated = *op == '!';
+	if (term->negated) {
+		op[0] = '\0';
+		op++;
+		if (*op != '=' && *op != '~')
+			return -EINVAL;
+	}
+	term->glob = *op == '~';
+	op[0] = '\0';
+	term->value = op + 1;
+
+	return 0;
+}
+
+int filter_parse(char *str, struct filter *filter)
+{
+	int ret;
+	char *saveptr = NULL;
+	char *word;
+	bool expect_term = true;
+
+	if (str == NULL || filter == NULL)
+		return -EINVAL;
+
+	filter->nb_terms = 0;
+	if (ut_string_match(str, "*"))
+		return 0;
+
+	for (word = strtok_r(str, " \t", &saveptr); word != NULL;
+			word = strtok_r(NULL, " \t", &saveptr)) {
+		if (!expect_term) {
+			if (!ut_string_match(word, "AND"))
+				return -EINVAL;
+			expect_term = true;
+			continue;
+		}
+		if (filter->nb_terms == FILTER_MAX_TERMS)
+			return -E2BIG;
+		ret = parse_term(word, filter->terms + filter->nb_terms);
+		if (ret < 0)
+			return ret;
+		filter->nb_terms++;
+		expect_term = false;
+	}
+
+	/* a trailing AND */
+	return expect_term && filter->nb_terms != 0 ? -EINVAL : 0;
+}
+
+int filter_check(const struct filter *filter,
+		const struct folder_snapshot *snapshot)
+{
+	unsigned i;
+
+	for (i = 0; i < filter->nb_terms; i++)
+		if (!folder_snapshot_has_property(snapshot,
+				filter->terms[i].property)) {
+			ULOGE("unknown property %s", filter->terms[i].property);
+			return -ESRCH;
+		}
+
+	return 0;
+}
+
+static bool term_match(const struct filter_term *term,
+		const struct folder_entity_snapshot *es)
+{
+	const char *value;
+	bool match;
+
+	value = folder_entity_snapshot_get_property(es, term->property);
+	if (value == NULL)
+		return false;
+	if (term->glob)
+		match = fnmatch(term->value, value, 0) == 0;
+	else
+		match = ut_string_match(value, term->value);
+
+	return match != term->negated;
+}
+
+bool filter_match(const struct filter *filter,
+		const struct folder_entity_snapshot *es)
+{
+	unsigned i;
+
+	for (i = 0; i < filter->nb_terms; i++)
+		if (!term_match(filter->terms + i, es))
+			return false;
+
+	return true;
+}
+
+void filter_get_candidates(const struct filter *filter,
+		const struct folder_snapshot *snapshot,
+		struct folder_entity_snapshot * const **candidates,
+		unsigned *count)
+{
+	unsigned i;
+	const struct filter_term *term;
+
+	for (i = 0; i < filter->nb_terms; i++) {
+		term = filter->terms + i;
+		if (term->negated || term->glob)
+			continue;
+		if (folder_snapshot_lookup(snapshot, term->property,
+				term->value, candidates, count) == 0)
+			return;
+	}
+
+	*candidates = snapshot->entities;
+	*count = snapshot->nb_entities;
+}
@@ -0,0 +1,53 @@
+/**
+ * @file filter.h
+ * @brief predicates on the properties of the entities of a folder snapshot,
+ * e.g. "state=STARTED AND firmware_path~*anafi*"
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef FILTER_H_
+#define FILTER_H_
+#include <stdbool.h>
+
+#include "folders.h"
+
+#define FILTER_MAX_TERMS 16
+
+/* property=value, property!=value, property~pattern or property!~pattern */
+struct filter_term {
+	const char *property;
+	const char *value;
+	bool negated;
+	/* value is an fnmatch(3) pattern */
+	bool glob;
+};
+
+/* the strings point inside the string parsed */
+struct filter {
+	unsigned nb_terms;
+	struct filter_term terms[FILTER_MAX_TERMS];
+};
+
+/*
+ * terms separated by the AND word, an empty string or "*" match everything, str
+ * is modified in place and must outlive the filter
+ */
+int filter_parse(char *str, struct filter *filter);
+/* returns -ESRCH if a term concerns a property the snapshot's folder hasn't */
+int filter_check(const struct filter *filter,
+		const struct folder_snapshot *snapshot);
+bool filter_match(const struct filter *filter,
+		const struct folder_entity_snapshot *es);
+/*
+ * retrieves the entities which can match the filter, using the index of the
+ * first equality term on an indexed property if any, all the entities of the
+ * folder otherwise
+ */
+void filter_get_candidates(const struct filter *filter,
+		const struct folder_snapshot *snapshot,
+		struct folder_entity_snapshot * const **candidates,
+		unsigned *count);
+
+#endif /* FILTER_H_ */
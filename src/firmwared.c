@@ -11,6 +11,7 @@
 #include <sys/un.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <netdb.h>
 #include <grp.h>
 #include <unistd.h>
 
@@ -32,6 +33,8 @@ ULOG_DECLARE_TAG(firmwared);
 #include <ut_module.h>
 
 #include "commands.h"
+#include "clients.h"
+#include "watchdog.h"
 #include "folders.h"
 #include "instances.h"
 #include "firmwares.h"
@@ -45,11 +48,27 @@ static const struct ut_module ulogger_module = {
 		.name = "ulogger",
 };
 
+/* separators of the addresses listed in FIRMWARED_LISTEN */
+#define LISTEN_SEPARATORS ", \t\n"
+
+/* additional listener, configured with FIRMWARED_LISTEN */
+struct listener {
+	struct pomp_ctx *pomp;
+	struct io_src src;
+	bool monitored;
+	/* the clients connected through it can only run read-only commands */
+	bool read_only;
+	/* of the socket, removed on cleanup, NULL for a TCP listener */
+	char *path;
+};
+
 struct firmwared {
 	struct io_mon mon;
 	struct io_src pomp_src;
 	struct pomp_ctx *pomp;
 	struct io_src_sig sig_src;
+	struct listener *listeners;
+	unsigned nb_listeners;
 	bool loop;
 	bool initialized;
 };
@@ -69,26 +88,36 @@ static size_t setup_address(struct sockaddr_storage *addr_storage)
 	return sizeof(*addr_un);
 }
 
+/* userdata is the listener the client connected through, NULL for the socket */
 static void event_cb(struct pomp_ctx *pomp, enum pomp_event event,
 		struct pomp_conn *conn, const struct pomp_msg *msg,
 		void *userdata)
 {
 	int ret;
+	const struct listener *listener = userdata;
 
 	ULOGD("%s : event=%d(%s) conn=%p msg=%p", __func__,
 			event, pomp_event_str(event), conn, msg);
 
 	switch (event) {
 	case POMP_EVENT_CONNECTED:
+		ret = clients_add(conn, listener != NULL &&
+				listener->read_only);
+		if (ret < 0)
+			ULOGE("clients_add: %s", strerror(-ret));
 		break;
 
 	case POMP_EVENT_DISCONNECTED:
+		/* nobody will wait for the result of its preparations anymore */
+		folders_abort_preparations(client_get_id(conn));
+		clients_remove(conn);
 		break;
 
 	case POMP_EVENT_MSG:
-		ret = command_invoke(conn, msg);
+		/* executed later, see clients_process_commands() */
+		ret = client_enqueue_command(conn, msg);
 		if (ret < 0) {
-			ULOGE("command_invoke: %s", strerror(-ret));
+			ULOGE("client_enqueue_command: %s", strerror(-ret));
 			return;
 		}
 		break;
@@ -99,11 +128,10 @@ static void event_cb(struct pomp_ctx *pomp, enum pomp_event event,
 	}
 }
 
-static void change_sock_group_mode()
+static void change_sock_group_mode(const char *socket_path)
 {
 	int ret;
 	struct group *g;
-	const char *socket_path = config_get(CONFIG_SOCKET_PATH);
 
 	g = getgrnam(FIRMWARED_GROUP);
 	if (g == NULL) {
@@ -130,6 +158,7 @@ static void pomp_src_cb(struct io_src *src)
 	struct firmwared *f = ut_container_of(src, typeof(*f), pomp_src);
 	struct pomp_ctx *pomp = f->pomp;
 	int ret;
+	WATCHDOG_PROBE("pomp", NULL);
 
 	ret = pomp_ctx_process_fd(pomp);
 	if (ret < 0) {
@@ -139,6 +168,202 @@ static void pomp_src_cb(struct io_src *src)
 	}
 }
 
+static void listener_src_cb(struct io_src *src)
+{
+	struct listener *listener = ut_container_of(src, typeof(*listener),
+			src);
+	int ret;
+	WATCHDOG_PROBE("pomp", NULL);
+
+	ret = pomp_ctx_process_fd(listener->pomp);
+	if (ret < 0)
+		ULOGE("pomp_ctx_process_fd: %s", strerror(-ret));
+}
+
+/* address is HOST:PORT, an IPv6 HOST being enclosed in brackets */
+static int parse_tcp_address(char *address, struct sockaddr_storage *addr,
+		size_t *len)
+{
+	int ret;
+	char *port;
+	size_t host_len;
+	struct addrinfo *res;
+	struct addrinfo hints = {
+		.ai_family = AF_UNSPEC,
+		.ai_socktype = SOCK_STREAM,
+		.ai_flags = AI_PASSIVE | AI_NUMERICSERV,
+	};
+
+	port = strrchr(address, ':');
+	if (port == NULL || port[1] == '\0')
+		return -EINVAL;
+	*port++ = '\0';
+	host_len = strlen(address);
+	if (host_len >= 2 && address[0] == '[' &&
+			address[host_len - 1] == ']') {
+		address[host_len - 1] = '\0';
+		address++;
+	}
+
+	/* an empty host means any address */
+	ret = getaddrinfo(*address == '\0' ? NULL : address, port, &hints,
+			&res);
+	if (ret != 0) {
+		ULOGE("getaddrinfo(%s, %s): %s", address, port,
+				gai_strerror(ret));
+		return -EINVAL;
+	}
+	memcpy(addr, res->ai_addr, res->ai_addrlen);
+	*len = res->ai_addrlen;
+	freeaddrinfo(res);
+
+	return 0;
+}
+
+/* spec is tcp:HOST:PORT[:MODE] or unix:PATH[:MODE], MODE being ro or rw */
+static int parse_listener(const char *spec, struct sockaddr_storage *addr,
+		size_t *len, bool *read_only)
+{
+	char __attribute__((cleanup(ut_string_free))) *s = NULL;
+	char *mode;
+	struct sockaddr_un *addr_un = (struct sockaddr_un *)addr;
+
+	s = strdup(spec);
+	if (s == NULL)
+		return -errno;
+
+	/* the listeners are read-only unless told otherwise */
+	*read_only = true;
+	mode = strrchr(s, ':');
+	if (mode != NULL && (ut_string_match(mode, ":ro") ||
+			ut_string_match(mode, ":rw"))) {
+		*read_only = mode[2] == 'o';
+		*mode = '\0';
+	}
+
+	memset(addr, 0, sizeof(*addr));
+	if (strncmp(s, "tcp:", 4) == 0)
+		return parse_tcp_address(s + 4, addr, len);
+	if (strncmp(s, "unix:", 5) != 0 || s[5] == '\0')
+		return -EINVAL;
+	if (strlen(s + 5) >= sizeof(addr_un->sun_path))
+		return -ENAMETOOLONG;
+	addr_un->sun_family = AF_UNIX;
+	strcpy(addr_un->sun_path, s + 5);
+	*len = sizeof(*addr_un);
+
+	return 0;
+}
+
+static int listener_init(struct listener *listener, const char *spec)
+{
+	int ret;
+	struct sockaddr_storage addr_storage;
+	size_t len;
+
+	ret = parse_listener(spec, &addr_storage, &len, &listener->read_only);
+	if (ret < 0) {
+		ULOGE("invalid listener %s: %s", spec, strerror(-ret));
+		return ret;
+	}
+	if (addr_storage.ss_family == AF_UNIX) {
+		listener->path = strdup(
+				((struct sockaddr_un *)&addr_storage)->sun_path);
+		if (listener->path == NULL)
+			return -errno;
+	}
+	listener->pomp = pomp_ctx_new(&event_cb, listener);
+	if (listener->pomp == NULL) {
+		ULOGE("pomp_ctx_new failed");
+		return -ENOMEM;
+	}
+	ret = pomp_ctx_listen(listener->pomp, (struct sockaddr *)&addr_storage,
+			len);
+	if (ret < 0) {
+		ULOGE("pomp_ctx_listen(%s): %s", spec, strerror(-ret));
+		return ret;
+	}
+	/* same permissions as the main socket, not left to the umask */
+	if (listener->path != NULL)
+		change_sock_group_mode(listener->path);
+	ret = io_src_init(&listener->src, pomp_ctx_get_fd(listener->pomp),
+			IO_IN, listener_src_cb);
+	if (ret < 0) {
+		ULOGE("io_src_init: %s", strerror(-ret));
+		return ret;
+	}
+	ret = io_mon_add_source(&ctx.mon, &listener->src);
+	if (ret < 0) {
+		ULOGE("io_mon_add_source: %s", strerror(-ret));
+		return ret;
+	}
+	listener->monitored = true;
+	ULOGI("listening on %s, %s", spec,
+			listener->read_only ? "read-only" : "read-write");
+
+	return 0;
+}
+
+static void listener_clean(struct listener *listener)
+{
+	if (listener->monitored)
+		io_mon_remove_source(&ctx.mon, &listener->src);
+	io_src_clean(&listener->src);
+	if (listener->pomp != NULL) {
+		pomp_ctx_stop(listener->pomp);
+		pomp_ctx_destroy(listener->pomp);
+	}
+	if (listener->path != NULL)
+		unlink(listener->path);
+	ut_string_free(&listener->path);
+	memset(listener, 0, sizeof(*listener));
+}
+
+static int listeners_init(void)
+{
+	int ret;
+	const char *config = config_get(CONFIG_LISTEN);
+	char __attribute__((cleanup(ut_string_free))) *specs = NULL;
+	char *spec;
+	char *saveptr;
+	const char *p;
+	unsigned max = 1;
+
+	if (ut_string_is_invalid(config))
+		return 0;
+
+	specs = strdup(config);
+	if (specs == NULL)
+		return -errno;
+	for (p = config; *p != '\0'; p++)
+		if (strchr(LISTEN_SEPARATORS, *p) != NULL)
+			max++;
+	ctx.listeners = calloc(max, sizeof(*ctx.listeners));
+	if (ctx.listeners == NULL)
+		return -errno;
+
+	for (spec = strtok_r(specs, LISTEN_SEPARATORS, &saveptr); spec != NULL;
+			spec = strtok_r(NULL, LISTEN_SEPARATORS, &saveptr)) {
+		/* counted first, so that it's cleaned even if partly inited */
+		ret = listener_init(ctx.listeners + ctx.nb_listeners++, spec);
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+static void listeners_clean(void)
+{
+	unsigned i;
+
+	for (i = 0; i < ctx.nb_listeners; i++)
+		listener_clean(ctx.listeners + i);
+	free(ctx.listeners);
+	ctx.listeners = NULL;
+	ctx.nb_listeners = 0;
+}
+
 static void sig_src_cb(struct io_src_sig *sig, struct signalfd_siginfo *si)
 {
 	struct firmwared *f = ut_container_of(sig, typeof(*f), sig_src);
@@ -158,6 +383,11 @@ int firmwared_init(void)
 		return 0;
 
 	ctx.loop = true;
+	ret = clients_init();
+	if (ret < 0) {
+		ULOGE("clients_init: %s", strerror(-ret));
+		return ret;
+	}
 	ctx.pomp = pomp_ctx_new(&event_cb, NULL);
 	if (ctx.pomp == NULL) {
 		ret = -errno;
@@ -171,7 +401,7 @@ int firmwared_init(void)
 		ULOGE("pomp_ctx_listen : err=%d(%s)", ret, strerror(-ret));
 		goto err;
 	}
-	change_sock_group_mode();
+	change_sock_group_mode(config_get(CONFIG_SOCKET_PATH));
 
 	ret = io_mon_init(&ctx.mon);
 	if (ret < 0) {
@@ -208,6 +438,11 @@ int firmwared_init(void)
 		ULOGE("io_mon_add_sources: %s", strerror(-ret));
 		goto err;
 	}
+	ret = listeners_init();
+	if (ret < 0) {
+		ULOGE("listeners_init: %s", strerror(-ret));
+		goto err;
+	}
 
 	unlink(MOUNT_PATH_SYMLINK);
 	ret = symlink(config_get(CONFIG_MOUNT_PATH), MOUNT_PATH_SYMLINK);
@@ -225,17 +460,32 @@ err:
 	return ret;
 }
 
+static int poll_timeout(void)
+{
+	/* don't wait for an event while commands are still queued */
+	if (clients_have_commands())
+		return 0;
+	/* nor for too long while clients have output pending */
+	if (clients_have_output())
+		return CLIENTS_FLUSH_PERIOD;
+
+	return -1;
+}
+
 void firmwared_run(void)
 {
 	int ret;
 
 	while (ctx.loop) {
-		ret = io_mon_poll(&ctx.mon, -1);
+		ret = io_mon_poll(&ctx.mon, poll_timeout());
 		if (ret < 0) {
 			ULOGE("io_mon_poll: %s", strerror(-ret));
 			return;
 		}
+		clients_process_commands();
 		folders_reap_preparations();
+		clients_flush_output();
+		watchdog_loop_iteration_end();
 	}
 }
 
@@ -244,17 +494,55 @@ void firmwared_stop(void)
 	ctx.loop = false;
 }
 
-int firmwared_notify(uint32_t msgid, const char *fmt, ...)
+int firmwared_notify(const struct notification_scope *scope, uint32_t msgid,
+		const char *fmt, ...)
+{
+	int ret;
+	va_list args;
+	struct pomp_msg *msg;
+
+	if (scope == NULL || ut_string_is_invalid(fmt))
+		return -EINVAL;
+
+	/* the message is encoded once, whatever the number of recipients */
+	msg = pomp_msg_new();
+	if (msg == NULL)
+		return -errno;
+	va_start(args, fmt);
+	ret = pomp_msg_writev(msg, msgid, fmt, args);
+	va_end(args);
+	if (ret < 0)
+		goto out;
+
+	clients_notify(scope, msg);
+out:
+	pomp_msg_destroy(msg);
+
+	return ret;
+}
+
+int firmwared_answer(struct pomp_conn *conn, uint32_t msgid,
+		const char *fmt, ...)
 {
 	int ret;
 	va_list args;
+	struct pomp_msg *msg;
 
-	if (ut_string_is_invalid(fmt))
+	if (conn == NULL || ut_string_is_invalid(fmt))
 		return -EINVAL;
 
+	msg = pomp_msg_new();
+	if (msg == NULL)
+		return -errno;
 	va_start(args, fmt);
-	ret = pomp_ctx_sendv(ctx.pomp, msgid, fmt, args);
+	ret = pomp_msg_writev(msg, msgid, fmt, args);
 	va_end(args);
+	if (ret < 0)
+		goto out;
+
+	ret = client_answer(conn, msg);
+out:
+	pomp_msg_destroy(msg);
 
 	return ret;
 }
@@ -267,6 +555,7 @@ struct io_mon *firmwared_get_mon(void)
 void firmwared_clean(void)
 {
 	unlink(MOUNT_PATH_SYMLINK);
+	listeners_clean();
 	io_mon_remove_sources(&ctx.mon, io_src_sig_get_source(&ctx.sig_src),
 			&ctx.pomp_src, NULL /* guard */);
 	io_src_sig_clean(&ctx.sig_src);
@@ -276,6 +565,7 @@ void firmwared_clean(void)
 		pomp_ctx_destroy(ctx.pomp);
 		ctx.pomp = NULL;
 	}
+	clients_cleanup();
 	memset(&ctx, 0, sizeof(ctx));
 
 	unlink(config_get(CONFIG_SOCKET_PATH));
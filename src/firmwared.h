@@ -10,6 +10,7 @@
 #define FIRMWARED_H_
 
 #include <stdbool.h>
+#include <stdint.h>
 
 #include <libpomp.h>
 
@@ -23,12 +24,40 @@
 
 #define FIRMWARED_CONSTRUCTOR_PRIORITY 200
 
+/* entities and client concerned by a notification */
+struct notification_scope {
+	/* id of the client which issued the command, 0 if none */
+	uint32_t origin;
+	/* sent to the client origin only, not to the subscribers */
+	bool origin_only;
+	/* NULL if the notification doesn't concern a folder */
+	const char *folder;
+	/* sha1 and name of the entity, NULL if not known */
+	const char *entity;
+	const char *name;
+	/* property concerned by a PROPERTY_CHANGED notification, NULL if none */
+	const char *property;
+	/*
+	 * subject of the notification, two queued notifications of the same
+	 * type and key can be coalesced, NULL if they can't
+	 */
+	const char *key;
+};
+
 int firmwared_init(void);
 void firmwared_run(void);
 void firmwared_stop(void);
-__attribute__ ((format (printf, 2, 3)))
-int firmwared_notify(uint32_t msgid, const char *fmt, ...);
-#define firmwared_answer pomp_conn_send
+/*
+ * sends an answer to the client which issued the command and a notification to
+ * all the clients which subscribed to it
+ */
+__attribute__ ((format (printf, 3, 4)))
+int firmwared_notify(const struct notification_scope *scope, uint32_t msgid,
+		const char *fmt, ...);
+/* sends an ack to the client which issued the command */
+__attribute__ ((format (printf, 3, 4)))
+int firmwared_answer(struct pomp_conn *conn, uint32_t msgid,
+		const char *fmt, ...);
 struct io_mon *firmwared_get_mon(void);
 
 void firmwared_clean(void);
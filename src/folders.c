@@ -12,6 +12,7 @@
 #include <sys/time.h>
 
 #include <time.h>
+#include <stdlib.h>
 #include <errno.h>
 #include <string.h>
 #include <stdbool.h>
@@ -31,6 +32,10 @@
 #include "properties/custom_property.h"
 #include "folders.h"
 #include "config.h"
+#include "clients.h"
+#include "journal.h"
+#include "status.h"
+#include "templates.h"
 
 #define ULOG_TAG firmwared_folders
 #include <ulog.h>
@@ -43,6 +48,13 @@ ULOG_DECLARE_TAG(firmwared_folders);
 
 static struct folder folders[FOLDERS_MAX];
 
+/* preparations waiting for a slot, one queue per priority class */
+static struct rs_dll pending_preparations[PREPARATION_PRIORITY_NB];
+/* preparations ended, waiting to be destroyed */
+static struct rs_dll ended_preparations;
+/* global limit, in addition to the per-folder ones */
+static unsigned max_preparations;
+
 static char *list;
 
 static struct rs_dll folders_names;
@@ -239,6 +251,16 @@ static bool folder_property_is_invalid(struct folder_property *property)
 			(property->seti != NULL && property->geti == NULL);
 }
 
+static int folder_property_match_str_name(struct rs_node *node,
+		const void *data)
+{
+	const char *name = (const char *)data;
+	struct folder_property *property = to_property(node);
+
+	return name != NULL && property->name != NULL &&
+			ut_string_match(property->name, name);
+}
+
 static int folder_property_match_str_array_name(struct rs_node *node,
 		const void *data)
 {
@@ -315,6 +337,374 @@ static const struct folder_property base_workspace_property = {
 		.get = get_base_workspace,
 };
 
+static int property_get(struct folder_property *property,
+		struct folder_entity *entity, char **value);
+
+static void entity_snapshot_unref(struct folder_entity_snapshot **snapshot)
+{
+	struct folder_entity_snapshot *s;
+	unsigned i;
+
+	if (snapshot == NULL || *snapshot == NULL)
+		return;
+	s = *snapshot;
+	*snapshot = NULL;
+
+	if (--s->refcount != 0)
+		return;
+
+	for (i = 0; i < s->nb_properties; i++) {
+		ut_string_free(&s->properties[i].name);
+		ut_string_free(&s->properties[i].value);
+	}
+	free(s->properties);
+	ut_string_free(&s->sha1);
+	ut_string_free(&s->name);
+	ut_string_free(&s->info);
+	free(s);
+}
+
+static struct folder_entity_snapshot *entity_snapshot_ref(
+		struct folder_entity_snapshot *snapshot)
+{
+	snapshot->refcount++;
+
+	return snapshot;
+}
+
+static struct folder_entity_snapshot *entity_snapshot_new(
+		struct folder_entity *entity)
+{
+	int ret;
+	struct folder_entity_snapshot *snapshot;
+	struct folder_snapshot_property *sp;
+	struct folder *folder = entity->folder;
+	struct rs_node *node = NULL;
+	struct folder_property *property;
+	FILE *info = NULL;
+	size_t info_size;
+
+	snapshot = calloc(1, sizeof(*snapshot));
+	if (snapshot == NULL)
+		return NULL;
+	snapshot->refcount = 1;
+	info = open_memstream(&snapshot->info, &info_size);
+	if (info == NULL) {
+		ret = -errno;
+		goto err;
+	}
+	snapshot->properties = calloc(rs_dll_get_count(&folder->properties),
+			sizeof(*snapshot->properties));
+	if (snapshot->properties == NULL) {
+		ret = -errno;
+		goto err;
+	}
+	snapshot->sha1 = strdup(folder_entity_get_sha1(entity));
+	snapshot->name = strdup(entity->name);
+	if (snapshot->sha1 == NULL || snapshot->name == NULL) {
+		ret = -errno;
+		goto err;
+	}
+
+	while ((node = rs_dll_next_from(&folder->properties, node)) != NULL) {
+		property = to_property(node);
+		sp = snapshot->properties + snapshot->nb_properties;
+		ret = property_get(property, entity, &sp->value);
+		if (ret < 0) {
+			ULOGE("property_get: %s", strerror(-ret));
+			goto err;
+		}
+		sp->name = strdup(property->name);
+		if (sp->name == NULL) {
+			ret = -errno;
+			ut_string_free(&sp->value);
+			goto err;
+		}
+		snapshot->nb_properties++;
+		fprintf(info, "%s: %s\n", sp->name, sp->value);
+	}
+	ret = fclose(info);
+	info = NULL;
+	if (ret != 0) {
+		ret = -errno;
+		goto err;
+	}
+
+	return snapshot;
+err:
+	if (info != NULL)
+		fclose(info);
+	entity_snapshot_unref(&snapshot);
+	errno = -ret;
+
+	return NULL;
+}
+
+/* builds the snapshot of the entity if it changed since the last one */
+static struct folder_entity_snapshot *get_entity_snapshot(
+		struct folder_entity *entity)
+{
+	if (entity->snapshot == NULL)
+		entity->snapshot = entity_snapshot_new(entity);
+
+	return entity->snapshot;
+}
+
+static void folder_snapshot_destroy(struct folder_snapshot *snapshot)
+{
+	unsigned i;
+
+	for (i = 0; i < snapshot->nb_indexes; i++) {
+		ut_string_free(&snapshot->indexes[i].property);
+		free(snapshot->indexes[i].entities);
+	}
+	free(snapshot->indexes);
+
+	for (i = 0; i < snapshot->nb_entities; i++)
+		entity_snapshot_unref(snapshot->entities + i);
+	free(snapshot->entities);
+	free(snapshot->by_sha1);
+	ut_string_free(&snapshot->list);
+	ut_string_free(&snapshot->properties);
+	free(snapshot);
+}
+
+static int entity_snapshot_compare(const void *a, const void *b)
+{
+	const struct folder_entity_snapshot * const *esa = a;
+	const struct folder_entity_snapshot * const *esb = b;
+
+	return strcmp((*esa)->sha1, (*esb)->sha1);
+}
+
+static int entity_snapshot_compare_property(const void *a, const void *b,
+		void *property)
+{
+	const struct folder_entity_snapshot * const *esa = a;
+	const struct folder_entity_snapshot * const *esb = b;
+
+	return strcmp(folder_entity_snapshot_get_property(*esa, property),
+			folder_entity_snapshot_get_property(*esb, property));
+}
+
+static int build_index(const struct folder_snapshot *snapshot,
+		const char *property, struct folder_snapshot_index *index)
+{
+	index->property = strdup(property);
+	index->entities = calloc(snapshot->nb_entities + 1,
+			sizeof(*index->entities));
+	if (index->property == NULL || index->entities == NULL)
+		return -errno;
+	memcpy(index->entities, snapshot->entities,
+			snapshot->nb_entities * sizeof(*index->entities));
+	qsort_r(index->entities, snapshot->nb_entities,
+			sizeof(*index->entities),
+			entity_snapshot_compare_property, index->property);
+
+	return 0;
+}
+
+/* the indexed properties the folder doesn't have are ignored */
+static int build_indexes(struct folder *folder,
+		struct folder_snapshot *snapshot)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *argz = NULL;
+	size_t argz_len;
+	const char *property = NULL;
+	struct folder_snapshot_index *index;
+
+	ret = -argz_create_sep(config_get(CONFIG_INDEXED_PROPERTIES), ',',
+			&argz, &argz_len);
+	if (ret < 0)
+		return ret;
+	snapshot->indexes = calloc(argz_count(argz, argz_len) + 1,
+			sizeof(*snapshot->indexes));
+	if (snapshot->indexes == NULL)
+		return -errno;
+
+	while ((property = argz_next(argz, argz_len, property)) != NULL) {
+		if (rs_dll_find_match(&folder->properties,
+				folder_property_match_str_name,
+				property) == NULL)
+			continue;
+		index = snapshot->indexes + snapshot->nb_indexes;
+		ret = build_index(snapshot, property, index);
+		/* counted anyway, for it to be freed */
+		snapshot->nb_indexes++;
+		if (ret < 0)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* one pass, the entities are listed from the most recent to the oldest */
+static char *build_list(const struct folder_snapshot *snapshot)
+{
+	int ret;
+	unsigned i;
+	FILE *stream;
+	char *list = NULL;
+	size_t size;
+	const struct folder_entity_snapshot *es;
+
+	stream = open_memstream(&list, &size);
+	if (stream == NULL)
+		return NULL;
+	for (i = snapshot->nb_entities; i > 0; i--) {
+		es = snapshot->entities[i - 1];
+		fprintf(stream, "%s%s[%s]", i == snapshot->nb_entities ? "" :
+				" ", es->name, es->sha1);
+	}
+	ret = fclose(stream);
+	if (ret != 0) {
+		free(list);
+		return NULL;
+	}
+
+	return list;
+}
+
+static struct folder_snapshot *folder_snapshot_new(struct folder *folder)
+{
+	int ret;
+	struct folder_snapshot *snapshot;
+	struct folder_entity_snapshot *es;
+	struct folder_entity *entity = NULL;
+	unsigned count = rs_dll_get_count(&folder->entities);
+
+	snapshot = calloc(1, sizeof(*snapshot));
+	if (snapshot == NULL)
+		return NULL;
+	snapshot->refcount = 1;
+	snapshot->generation = folder->generation;
+	snapshot->entities = calloc(count + 1, sizeof(*snapshot->entities));
+	snapshot->by_sha1 = calloc(count + 1, sizeof(*snapshot->by_sha1));
+	if (snapshot->entities == NULL || snapshot->by_sha1 == NULL) {
+		ret = -errno;
+		goto err;
+	}
+
+	/* the unchanged entities' snapshots are shared with the previous one */
+	while ((entity = folder_next(folder, entity)) != NULL) {
+		es = get_entity_snapshot(entity);
+		if (es == NULL) {
+			ret = -errno;
+			goto err;
+		}
+		snapshot->by_sha1[snapshot->nb_entities] = es;
+		snapshot->entities[snapshot->nb_entities++] =
+				entity_snapshot_ref(es);
+	}
+	qsort(snapshot->by_sha1, snapshot->nb_entities,
+			sizeof(*snapshot->by_sha1), entity_snapshot_compare);
+
+	snapshot->list = build_list(snapshot);
+	if (snapshot->list == NULL) {
+		ret = -errno;
+		goto err;
+	}
+	ret = build_indexes(folder, snapshot);
+	if (ret < 0)
+		goto err;
+
+	snapshot->properties = folder_list_properties(folder->name);
+	if (snapshot->properties == NULL) {
+		ret = -errno;
+		goto err;
+	}
+
+	return snapshot;
+err:
+	folder_snapshot_destroy(snapshot);
+	errno = -ret;
+
+	return NULL;
+}
+
+/* publishes a new version of the snapshot, the readers keep the old one */
+static void folder_invalidate_snapshot(struct folder *folder)
+{
+	folder->generation++;
+	folder_snapshot_unref(&folder->snapshot);
+}
+
+static void entity_invalidate_snapshot(struct folder_entity *entity)
+{
+	entity_snapshot_unref(&entity->snapshot);
+	if (entity->folder != NULL)
+		folder_invalidate_snapshot(entity->folder);
+}
+
+/* the key allows to coalesce the pending changes of the same property */
+static void notify_property_changed(struct folder_entity *entity,
+		const struct folder_entity_snapshot *es,
+		const struct folder_snapshot_property *sp)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *key = NULL;
+
+	ret = asprintf(&key, "%s %s", es->sha1, sp->name);
+	if (ret < 0) {
+		key = NULL;
+		ULOGE("asprintf error");
+		return;
+	}
+	ret = firmwared_notify(&(struct notification_scope) {
+				.folder = entity->folder->name,
+				.entity = es->sha1,
+				.name = es->name,
+				.property = sp->name,
+				.key = key,
+			}, FWD_ANSWER_PROPERTY_CHANGED,
+			FWD_FORMAT(ANSWER_PROPERTY_CHANGED), UINT32_MAX,
+			entity->folder->name, es->sha1, es->name, sp->name,
+			sp->value);
+	if (ret < 0)
+		ULOGE("firmwared_notify: %s", strerror(-ret));
+}
+
+/*
+ * the entity's snapshot is rebuilt right away and compared to the previous one,
+ * so that the changes are journaled, published in the status table and
+ * notified to the watchers whatever their origin, a client setting a property
+ * or an internal change, e.g. the state of an instance
+ */
+static void entity_changed(struct folder_entity *entity)
+{
+	unsigned i;
+	const char *old_value;
+	const struct folder_entity_snapshot *es;
+	const struct folder_snapshot_property *sp;
+	struct folder_entity_snapshot __attribute__((
+			cleanup(entity_snapshot_unref))) *old = NULL;
+
+	if (entity->snapshot != NULL)
+		old = entity_snapshot_ref(entity->snapshot);
+	entity_invalidate_snapshot(entity);
+
+	es = get_entity_snapshot(entity);
+	if (es == NULL) {
+		ULOGE("get_entity_snapshot: %m");
+		return;
+	}
+	status_update(entity->folder->name, es);
+	/* nothing to compare to, but the next change will be */
+	if (old == NULL)
+		return;
+	for (i = 0; i < es->nb_properties; i++) {
+		sp = es->properties + i;
+		old_value = folder_entity_snapshot_get_property(old, sp->name);
+		if (ut_string_match(old_value, sp->value))
+			continue;
+		journal_record(JOURNAL_EVENT_CHANGED, entity->folder->name,
+				es->sha1, es->name, sp->name, sp->value);
+		if (clients_have_watches())
+			notify_property_changed(entity, es, sp);
+	}
+}
+
 static void print_folder_entities(struct rs_node *node)
 {
 	struct folder_entity *e = ut_container_of(node, typeof(*e), node);
@@ -327,6 +717,7 @@ static void print_folder_entities(struct rs_node *node)
 static int do_drop(struct folder_entity *entity, bool only_unregister)
 {
 	custom_property_cleanup_values(entity);
+	entity_invalidate_snapshot(entity);
 
 	return entity->folder->ops.drop(entity, only_unregister);
 }
@@ -353,11 +744,41 @@ static const struct rs_dll_vtable folder_vtable = {
 	.remove = destroy_folder_entities,
 };
 
+/* an entity whose template failed to apply is dropped */
+static int apply_template(struct preparation *preparation,
+		struct folder_entity *entity)
+{
+	int ret;
+	int err;
+	const char *template;
+
+	template = preparation_get_option(preparation, "template");
+	if (template == NULL)
+		return 0;
+
+	ret = template_apply(template, entity);
+	if (ret == 0)
+		return 0;
+
+	ULOGE("template_apply(%s): %s", template, strerror(-ret));
+	err = folder_drop(preparation->folder, entity);
+	if (err < 0)
+		ULOGE("folder_drop: %s", strerror(-err));
+
+	return ret;
+}
+
+/*
+ * the request is answered here, with a PREPARED or an ERROR, unless entity is
+ * NULL, the preparation having then notified its failure, so 0 is returned, for
+ * a synchronous completion not to be answered twice
+ */
 static int entity_completion(struct preparation *preparation,
 			struct folder_entity *entity)
 {
 	struct folder *folder;
 	int ret = 0;
+	int err;
 
 	if (entity == NULL) {
 		ULOGW("%*s creation failed for identification string %s",
@@ -379,42 +800,46 @@ static int entity_completion(struct preparation *preparation,
 		ULOGE("folder_store: %s", strerror(-ret));
 		goto out;
 	}
+	/*
+	 * the custom properties need the entity's name, given by folder_store,
+	 * but no command can be processed before the PREPARED notification
+	 */
+	ret = apply_template(preparation, entity);
+	if (ret < 0)
+		goto out;
 
 	ret = 0;
 out:
+	if (ret < 0 && entity != NULL) {
+		err = preparation_notify(preparation,
+				PREPARATION_SCOPE(preparation),
+				FWD_ANSWER_ERROR, FWD_FORMAT(ANSWER_ERROR),
+				preparation->seqnum, -ret, strerror(-ret));
+		if (err < 0)
+			ULOGE("preparation_notify: %s", strerror(-err));
+	}
 	if (ret >= 0)
-		firmwared_notify(FWD_ANSWER_PREPARED,
-				FWD_FORMAT_ANSWER_PREPARED,
+		preparation_notify(preparation, &(struct notification_scope) {
+					.origin = preparation->origin,
+					.folder = preparation->folder,
+					.entity = folder_entity_get_sha1(entity),
+					.name = entity->name,
+				}, FWD_ANSWER_PREPARED,
+				FWD_FORMAT(ANSWER_PREPARED),
 				preparation->seqnum, preparation->folder,
 				folder_entity_get_sha1(entity), entity->name);
 
 	preparation->has_ended = true;
-
-	return ret;
-}
-
-static RS_NODE_MATCH_MEMBER(preparation, has_ended, node);
-
-static int folder_reap_preparations_of_folder(struct folder *folder)
-{
-	struct rs_node *node = NULL;
-	struct preparation *preparation;
-	const bool has_ended = true;
-
-	node = rs_dll_remove_match(&folder->preparations,
-			preparation_match_has_ended, &has_ended);
-	if (node == NULL)
-		return 0;
-
-	preparation = to_preparation(node);
-
-	preparation_clean(preparation);
-
-	folder->ops.destroy_preparation(&preparation);
+	folder = folder_find(preparation->folder);
+	rs_dll_remove(&folder->preparations, &preparation->node);
+	rs_dll_enqueue(&ended_preparations, &preparation->node);
 
 	return 0;
 }
 
+/* preparation_match_str_folder */
+static RS_NODE_MATCH_STR_MEMBER(preparation, folder, node);
+
 static int folder_register_property(const char *folder_name,
 		struct folder_property *property)
 {
@@ -440,6 +865,7 @@ static int preparation_destroy(struct rs_node *node)
 		return -ENOENT;
 
 	/* TODO unregister sources from the monitor */
+	preparation_clean(preparation);
 	folder->ops.destroy_preparation(&preparation);
 
 	return 0;
@@ -466,11 +892,17 @@ static const struct rs_dll_vtable properties_vtable = {
 int folders_init(void)
 {
 	int ret;
+	int i;
 	const char *resources_dir = config_get(CONFIG_RESOURCES_DIR);
 	const char *list_name;
 
 	ULOGD("%s", __func__);
 
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++)
+		rs_dll_init(pending_preparations + i, &preparations_vtable);
+	rs_dll_init(&ended_preparations, &preparations_vtable);
+	max_preparations = config_get_int(CONFIG_MAX_PREPARATIONS);
+
 	list_name = "names";
 	ret = load_words(resources_dir, list_name, &folders_names);
 	if (ret < 0) {
@@ -572,12 +1004,242 @@ unsigned folder_get_count(const char *folder_name)
 	return rs_dll_get_count(&folder->entities);
 }
 
+static unsigned count_running_preparations(void)
+{
+	unsigned count = 0;
+	int i;
+
+	for (i = 0; i < FOLDERS_MAX && folders[i].name != NULL; i++)
+		count += rs_dll_get_count(&folders[i].preparations);
+
+	return count;
+}
+
+static bool folder_has_pending_preparations(const char *folder_name)
+{
+	int i;
+
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++)
+		if (rs_dll_find_match(pending_preparations + i,
+				preparation_match_str_folder,
+				folder_name) != NULL)
+			return true;
+
+	return false;
+}
+
+static bool can_start_preparation(struct folder *folder)
+{
+	return count_running_preparations() < max_preparations &&
+			rs_dll_get_count(&folder->preparations) <
+			folder->max_preparations;
+}
+
+/*
+ * the preparation is registered as running before being started, because its
+ * completion can be called synchronously, if the entity already exists, for
+ * example, in which case, it has already been moved to the ended preparations
+ * on return
+ */
+static int start_preparation(struct folder *folder,
+		struct preparation *preparation)
+{
+	int ret;
+
+	preparation->queue_position = 0;
+	rs_dll_push(&folder->preparations, &preparation->node);
+	ret = preparation->start(preparation);
+	if (ret < 0 && !preparation->has_ended)
+		rs_dll_remove(&folder->preparations, &preparation->node);
+
+	return ret;
+}
+
+static void notify_queue_position(struct preparation *preparation,
+		unsigned position)
+{
+	int ret;
+	char progress[0x20];
+
+	if (preparation->queue_position == position)
+		return;
+	preparation->queue_position = position;
+
+	snprintf(progress, sizeof(progress), "queued %u", position);
+	ret = preparation_notify(preparation, PREPARATION_SCOPE(preparation),
+			FWD_ANSWER_PREPARE_PROGRESS,
+			FWD_FORMAT(ANSWER_PREPARE_PROGRESS),
+			preparation->seqnum, preparation->folder,
+			preparation->identification_string, progress);
+	if (ret < 0)
+		ULOGE("preparation_notify: %s", strerror(-ret));
+}
+
+/* positions are given in the order the preparations will be started */
+static void notify_queue_positions(void)
+{
+	int i;
+	unsigned position = 1;
+	struct rs_node *node;
+
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++) {
+		node = NULL;
+		while ((node = rs_dll_next_from(pending_preparations + i, node))
+				!= NULL)
+			notify_queue_position(to_preparation(node), position++);
+	}
+}
+
+static void preparation_failed(struct preparation *preparation, int err)
+{
+	int ret;
+
+	ret = preparation_notify(preparation, PREPARATION_SCOPE(preparation),
+			FWD_ANSWER_ERROR, FWD_FORMAT(ANSWER_ERROR),
+			preparation->seqnum, -err, strerror(-err));
+	if (ret < 0)
+		ULOGE("preparation_notify: %s", strerror(-ret));
+	preparation_destroy(&preparation->node);
+}
+
+/*
+ * starts the queued preparations, by priority class, then by arrival order, a
+ * preparation blocked by the limit of it's folder doesn't block those of the
+ * other folders
+ */
+static void schedule_preparations(void)
+{
+	int ret;
+	int i;
+	struct rs_node *node;
+	struct rs_node *next;
+	struct preparation *preparation;
+	struct folder *folder;
+	bool started = false;
+
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++) {
+		for (node = rs_dll_get_head(pending_preparations + i);
+				node != NULL; node = next) {
+			if (count_running_preparations() >= max_preparations)
+				goto out;
+			next = rs_dll_next_from(pending_preparations + i, node);
+			preparation = to_preparation(node);
+			folder = folder_find(preparation->folder);
+			if (!can_start_preparation(folder))
+				continue;
+
+			rs_dll_remove(pending_preparations + i, node);
+			started = true;
+			ret = start_preparation(folder, preparation);
+			if (ret < 0 && !preparation->has_ended)
+				preparation_failed(preparation, ret);
+		}
+	}
+out:
+	if (started)
+		notify_queue_positions();
+}
+
+static bool preparations_are_identical(const struct preparation *a,
+		const struct preparation *b)
+{
+	return !a->has_ended && ut_string_match(a->folder, b->folder) &&
+			ut_string_match(a->identification_string,
+					b->identification_string) &&
+			preparation_options_match(a, b);
+}
+
+/* returns the preparation, running or queued, preparation would duplicate */
+static struct preparation *find_identical_preparation(struct folder *folder,
+		struct preparation *preparation, bool *queued)
+{
+	int i;
+	struct rs_node *node = NULL;
+
+	*queued = false;
+	while ((node = rs_dll_next_from(&folder->preparations, node)) != NULL)
+		if (preparations_are_identical(to_preparation(node),
+				preparation))
+			return to_preparation(node);
+
+	*queued = true;
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++) {
+		node = NULL;
+		while ((node = rs_dll_next_from(pending_preparations + i, node))
+				!= NULL)
+			if (preparations_are_identical(to_preparation(node),
+					preparation))
+				return to_preparation(node);
+	}
+
+	return NULL;
+}
+
+/* the request gets the notifications of the preparation from now on */
+static int share_preparation(struct preparation *shared,
+		struct preparation *request, bool queued)
+{
+	int ret;
+
+	ret = preparation_attach(shared, request);
+	if (ret < 0)
+		return ret;
+	ULOGI("[%s] preparation of '%s' already in progress, %u requests",
+			shared->folder, shared->identification_string,
+			shared->nb_attached + 1);
+	if (!queued)
+		return 0;
+
+	/* the most urgent request gives its priority */
+	if (request->priority < shared->priority) {
+		rs_dll_remove(pending_preparations + shared->priority,
+				&shared->node);
+		shared->priority = request->priority;
+		rs_dll_enqueue(pending_preparations + shared->priority,
+				&shared->node);
+	}
+	/* so that the new request is told its position too */
+	shared->queue_position = 0;
+	notify_queue_positions();
+
+	return 0;
+}
+
+int folder_preparation_merge(struct preparation *preparation,
+		struct preparation *into)
+{
+	int ret;
+	struct folder *folder;
+
+	if (preparation == NULL || into == NULL || preparation == into)
+		return -EINVAL;
+	folder = folder_find(preparation->folder);
+	if (folder == NULL)
+		return -ENOENT;
+
+	ret = preparation_attach(into, preparation);
+	if (ret < 0)
+		return ret;
+	ULOGI("[%s] preparation of '%s' merged into the one of '%s'",
+			preparation->folder, preparation->identification_string,
+			into->identification_string);
+
+	/* ends without notification, the requests are those of into now */
+	preparation->has_ended = true;
+	rs_dll_remove(&folder->preparations, &preparation->node);
+	rs_dll_enqueue(&ended_preparations, &preparation->node);
+
+	return 0;
+}
+
 int folder_prepare(const char *folder_name, const char *identification_string,
-		uint32_t seqnum)
+		uint32_t seqnum, uint32_t origin)
 {
 	int ret;
 	struct folder *folder;
 	struct preparation *preparation;
+	struct preparation *shared;
+	bool queued;
 
 	folder = folder_find(folder_name);
 	if (folder == NULL)
@@ -587,17 +1249,40 @@ int folder_prepare(const char *folder_name, const char *identification_string,
 	if (preparation == NULL)
 		return -errno;
 	ret = preparation_init(preparation, identification_string, seqnum,
-			entity_completion);
-	if (ret < 0)
-		goto err;
-	ret = preparation->start(preparation);
+			origin, entity_completion);
 	if (ret < 0)
 		goto err;
 
-	rs_dll_push(&folder->preparations, &preparation->node);
+	if (preparation->shareable) {
+		shared = find_identical_preparation(folder, preparation,
+				&queued);
+		if (shared != NULL) {
+			/* only the request is kept, attached to shared */
+			ret = share_preparation(shared, preparation, queued);
+			preparation_clean(preparation);
+			folder->ops.destroy_preparation(&preparation);
+
+			return ret;
+		}
+	}
+
+	/* don't overtake the preparations already waiting */
+	if (can_start_preparation(folder) &&
+			!folder_has_pending_preparations(folder->name)) {
+		ret = start_preparation(folder, preparation);
+		if (ret < 0 && !preparation->has_ended)
+			goto err;
+
+		return ret;
+	}
+
+	rs_dll_enqueue(pending_preparations + preparation->priority,
+			&preparation->node);
+	notify_queue_positions();
 
 	return 0;
 err:
+	preparation_clean(preparation);
 	folder->ops.destroy_preparation(&preparation);
 
 	return ret;
@@ -605,31 +1290,74 @@ err:
 
 int folders_reap_preparations(void)
 {
-	int ret;
-	struct folder *folder;
+	/*
+	 * a preparation started by schedule_preparations() can end
+	 * synchronously, so loop until no slot is released anymore
+	 */
+	while (rs_dll_get_count(&ended_preparations) != 0) {
+		rs_dll_remove_all(&ended_preparations);
+		schedule_preparations();
+	}
+
+	return 0;
+}
+
+/* queue is set to the one of the preparation found */
+static struct preparation *find_pending_preparation(const char *folder_name,
+		const char *identification_string, struct rs_dll **queue)
+{
 	int i;
+	struct rs_node *node;
+	struct preparation *preparation;
 
-	for (i = 0; i < FOLDERS_MAX; i++) {
-		folder = folders + i;
-		if (folder->name == NULL)
-			continue;
-		if (rs_dll_get_count(&folder->preparations) == 0)
-			continue;
-		ret = folder_reap_preparations_of_folder(folder);
-		if (ret < 0)
-			ULOGW("folder_reap_preparations_of_folder: %s",
-					strerror(-ret));
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++) {
+		node = NULL;
+		while ((node = rs_dll_next_from(pending_preparations + i, node))
+				!= NULL) {
+			preparation = to_preparation(node);
+			if (!ut_string_match(preparation->folder, folder_name))
+				continue;
+			if (!ut_string_match(preparation->identification_string,
+					identification_string))
+				continue;
+			*queue = pending_preparations + i;
+
+			return preparation;
+		}
 	}
 
-	return 0;
+	errno = ENOENT;
+
+	return NULL;
+}
+
+static void request_cancelled(struct preparation *preparation,
+		const struct preparation_request *request)
+{
+	int ret;
+
+	/* coverity[bad_printf_format_string] */
+	ret = firmwared_notify(&(struct notification_scope) {
+				.origin = request->origin,
+				.origin_only = true,
+				.folder = preparation->folder,
+				.key = preparation->identification_string,
+			}, FWD_ANSWER_ERROR, FWD_FORMAT(ANSWER_ERROR),
+			request->seqnum, ECANCELED, strerror(ECANCELED));
+	if (ret < 0)
+		ULOGE("firmwared_notify: %s", strerror(-ret));
 }
 
 int folder_preparation_abort(const char *folder_name,
-		const char *identification_string)
+		const char *identification_string, uint32_t origin)
 {
+	int ret;
+	int i;
 	struct folder *folder;
 	struct rs_node *node;
+	struct rs_dll *queue = NULL;
 	struct preparation *preparation;
+	struct preparation_request *withdrawn;
 
 	folder = folder_find(folder_name);
 	if (folder == NULL)
@@ -638,15 +1366,94 @@ int folder_preparation_abort(const char *folder_name,
 	node = rs_dll_find_match(&folder->preparations,
 			preparation_match_str_identification_string,
 			identification_string);
-	if (node == NULL)
-		return -ENOENT;
+	if (node != NULL) {
+		preparation = to_preparation(node);
+		/* preparations of instances are short, they run to the end */
+		if (preparation->abort == NULL)
+			return -EBUSY;
+	} else {
+		preparation = find_pending_preparation(folder->name,
+				identification_string, &queue);
+		if (preparation == NULL)
+			return -errno;
+	}
 
-	preparation = to_preparation(node);
-	preparation->abort(preparation);
+	/* a shared preparation goes on for the requests of the other clients */
+	ret = preparation_withdraw(preparation, origin, &withdrawn);
+	if (ret < 0)
+		return ret;
+	for (i = 0; i < ret; i++)
+		request_cancelled(preparation, withdrawn + i);
+	free(withdrawn);
+	if (preparation->origin != origin)
+		return ret == 0 ? -EPERM : 0;
+
+	if (queue == NULL) {
+		preparation->abort(preparation);
+		return 0;
+	}
+
+	/* a queued preparation hasn't started anything, just forget it */
+	rs_dll_remove(queue, &preparation->node);
+	preparation_failed(preparation, -ECANCELED);
+	notify_queue_positions();
 
 	return 0;
 }
 
+void folders_abort_preparations(uint32_t origin)
+{
+	int i;
+	struct rs_node *node;
+	struct rs_node *next;
+	struct preparation *preparation;
+	bool removed = false;
+
+	if (origin == 0)
+		return;
+
+	for (i = 0; i < FOLDERS_MAX && folders[i].name != NULL; i++) {
+		for (node = rs_dll_get_head(&folders[i].preparations);
+				node != NULL; node = next) {
+			next = rs_dll_next_from(&folders[i].preparations, node);
+			preparation = to_preparation(node);
+			/* a shared preparation goes on for the other clients */
+			if (!preparation_release(preparation, origin) ||
+					preparation->abort == NULL)
+				continue;
+			ULOGI("[%s] client %"PRIu32" gone, aborting '%s'",
+					preparation->folder, origin,
+					preparation->identification_string);
+			preparation->abort(preparation);
+		}
+	}
+
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++) {
+		for (node = rs_dll_get_head(pending_preparations + i);
+				node != NULL; node = next) {
+			next = rs_dll_next_from(pending_preparations + i, node);
+			preparation = to_preparation(node);
+			if (!preparation_release(preparation, origin))
+				continue;
+			rs_dll_remove(pending_preparations + i, node);
+			preparation_destroy(node);
+			removed = true;
+		}
+	}
+	if (removed)
+		notify_queue_positions();
+}
+
+static void remove_preparations_of_folder(struct rs_dll *preparations,
+		const char *folder_name)
+{
+	struct rs_node *node;
+
+	while ((node = rs_dll_remove_match(preparations,
+			preparation_match_str_folder, folder_name)) != NULL)
+		preparation_destroy(node);
+}
+
 int folder_drop(const char *folder_name, struct folder_entity *entity)
 {
 	int ret;
@@ -674,6 +1481,9 @@ int folder_drop(const char *folder_name, struct folder_entity *entity)
 	entity = to_entity(node);
 	name = entity->name;
 
+	journal_record(JOURNAL_EVENT_DROPPED, folder->name,
+			folder_entity_get_sha1(entity), name, NULL, NULL);
+	status_remove(folder->name, folder_entity_get_sha1(entity));
 	ret = do_drop(entity, false);
 
 	/* we have to free name after calling drop() in case it needs it */
@@ -708,6 +1518,9 @@ int folder_store(const char *folder_name, struct folder_entity *entity)
 	entity->name = folder_request_friendly_name(folder);
 	if (entity->name == NULL)
 		return -errno;
+	journal_record(JOURNAL_EVENT_ADDED, folder->name,
+			folder_entity_get_sha1(entity), entity->name, NULL, NULL);
+	entity_changed(entity);
 
 	return 0;
 }
@@ -755,8 +1568,9 @@ char *folder_get_info(const char *folder_name,
 		const char *entity_identifier)
 {
 	int ret;
+	FILE *stream;
 	char *info = NULL;
-	char *old_info = NULL;
+	size_t size;
 	char *value = NULL;
 	const struct folder *folder;
 	struct folder_entity *entity;
@@ -780,29 +1594,29 @@ char *folder_get_info(const char *folder_name,
 	if (entity == NULL)
 		return NULL;
 
+	stream = open_memstream(&info, &size);
+	if (stream == NULL)
+		return NULL;
 	while ((node = rs_dll_next_from(&folder->properties, node)) != NULL) {
 		property = to_property(node);
 		ret = property_get(property, entity, &value);
 		if (ret < 0) {
+			fclose(stream);
 			ut_string_free(&info);
 			ULOGE("property_get: %s", strerror(-ret));
 			errno = -ret;
 			return NULL;
 		}
-		old_info = info;
-		ret = asprintf(&info, "%s%s: %s\n", info ? info : "",
-				property->name, value);
+		fprintf(stream, "%s: %s\n", property->name, value);
 		ut_string_free(&value);
-		ut_string_free(&old_info);
-		if (ret < 0) {
-			info = NULL;
-			ULOGE("asprintf error");
-			errno = -ENOMEM;
-			return NULL;
-		}
+	}
+	ret = fclose(stream);
+	if (ret != 0) {
+		ut_string_free(&info);
+		return NULL;
 	}
 
-	return info == NULL ? strdup("") : info;
+	return info;
 }
 
 struct folder_entity *folder_find_entity(const char *folder_name,
@@ -1101,6 +1915,7 @@ int folder_entity_set_property(struct folder_entity *entity, const char *name,
 			}
 		}
 	}
+	entity_changed(entity);
 
 	return 0;
 }
@@ -1108,6 +1923,7 @@ int folder_entity_set_property(struct folder_entity *entity, const char *name,
 int folder_add_property(const char *folder_name, const char *name)
 {
 	int ret;
+	struct folder_entity *entity = NULL;
 	struct rs_node *node;
 	struct folder_property *property;
 	struct folder *folder;
@@ -1130,11 +1946,199 @@ int folder_add_property(const char *folder_name, const char *name)
 		return ret;
 	}
 
-	return folder_register_property(folder->name, property);
+	ret = folder_register_property(folder->name, property);
+	if (ret < 0)
+		return ret;
+
+	/* all the entities have a new property */
+	while ((entity = folder_next(folder, entity)) != NULL)
+		entity_changed(entity);
+	folder_invalidate_snapshot(folder);
+
+	return 0;
+}
+
+void folder_entity_changed(struct folder_entity *entity)
+{
+	if (entity == NULL)
+		return;
+
+	entity_changed(entity);
+}
+
+struct folder_snapshot *folder_get_snapshot(const char *folder_name)
+{
+	struct folder *folder;
+
+	folder = folder_find(folder_name);
+	if (folder == NULL)
+		return NULL;
+
+	if (folder->snapshot == NULL ||
+			folder->snapshot->generation != folder->generation) {
+		folder_snapshot_unref(&folder->snapshot);
+		folder->snapshot = folder_snapshot_new(folder);
+		if (folder->snapshot == NULL)
+			return NULL;
+	}
+
+	folder->snapshot->refcount++;
+
+	return folder->snapshot;
+}
+
+void folder_snapshot_unref(struct folder_snapshot **snapshot)
+{
+	struct folder_snapshot *s;
+
+	if (snapshot == NULL || *snapshot == NULL)
+		return;
+	s = *snapshot;
+	*snapshot = NULL;
+
+	if (--s->refcount == 0)
+		folder_snapshot_destroy(s);
+}
+
+const struct folder_entity_snapshot *folder_snapshot_find(
+		const struct folder_snapshot *snapshot,
+		const char *entity_identifier)
+{
+	unsigned i;
+	const struct folder_entity_snapshot *es;
+
+	errno = EINVAL;
+	if (snapshot == NULL || ut_string_is_invalid(entity_identifier))
+		return NULL;
+
+	i = folder_snapshot_seek(snapshot, entity_identifier, false);
+	if (i < snapshot->nb_entities && ut_string_match(entity_identifier,
+			snapshot->by_sha1[i]->sha1))
+		return snapshot->by_sha1[i];
+	for (i = 0; i < snapshot->nb_entities; i++) {
+		es = snapshot->entities[i];
+		if (ut_string_match(entity_identifier, es->name))
+			return es;
+	}
+	errno = ENOENT;
+
+	return NULL;
+}
+
+unsigned folder_snapshot_seek(const struct folder_snapshot *snapshot,
+		const char *sha1, bool after)
+{
+	unsigned low = 0;
+	unsigned high = snapshot->nb_entities;
+	unsigned middle;
+	int cmp;
+
+	/* index of the first entity whose sha1 is >= (or > if after) sha1 */
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		cmp = strcmp(snapshot->by_sha1[middle]->sha1, sha1);
+		if (cmp < 0 || (after && cmp == 0))
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+int folder_snapshot_lookup(const struct folder_snapshot *snapshot,
+		const char *property, const char *value,
+		struct folder_entity_snapshot * const **entities,
+		unsigned *count)
+{
+	unsigned i;
+	unsigned low;
+	unsigned high;
+	unsigned middle;
+	unsigned first;
+	const struct folder_snapshot_index *index = NULL;
+
+	if (snapshot == NULL || ut_string_is_invalid(property) ||
+			value == NULL || entities == NULL || count == NULL)
+		return -EINVAL;
+
+	for (i = 0; i < snapshot->nb_indexes; i++)
+		if (ut_string_match(snapshot->indexes[i].property, property))
+			index = snapshot->indexes + i;
+	if (index == NULL)
+		return -ENOENT;
+
+	/* lower bound of value, then upper bound */
+	low = 0;
+	high = snapshot->nb_entities;
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (strcmp(folder_entity_snapshot_get_property(
+				index->entities[middle], property), value) < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	first = low;
+	high = snapshot->nb_entities;
+	while (low < high) {
+		middle = low + (high - low) / 2;
+		if (strcmp(folder_entity_snapshot_get_property(
+				index->entities[middle], property), value) <= 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+	*entities = index->entities + first;
+	*count = low - first;
+
+	return 0;
+}
+
+bool folder_snapshot_has_property(const struct folder_snapshot *snapshot,
+		const char *name)
+{
+	const char *p;
+	size_t len;
+
+	if (snapshot == NULL || ut_string_is_invalid(name))
+		return false;
+
+	/* space-separated, with a "[]" suffix for the array properties */
+	p = snapshot->properties;
+	len = strlen(name);
+	while ((p = strstr(p, name)) != NULL) {
+		if ((p == snapshot->properties || p[-1] == ' ') &&
+				(p[len] == '\0' || p[len] == ' ' ||
+				(p[len] == '[' && p[len + 1] == ']')))
+			return true;
+		p += len;
+	}
+
+	return false;
+}
+
+const char *folder_entity_snapshot_get_property(
+		const struct folder_entity_snapshot *snapshot,
+		const char *name)
+{
+	unsigned i;
+
+	errno = EINVAL;
+	if (snapshot == NULL || ut_string_is_invalid(name))
+		return NULL;
+
+	for (i = 0; i < snapshot->nb_properties; i++)
+		if (ut_string_match(name, snapshot->properties[i].name))
+			return snapshot->properties[i].value;
+	errno = ESRCH;
+
+	return NULL;
 }
 
 int folder_unregister(const char *folder_name)
 {
+	int i;
 	struct folder *folder;
 	struct folder *max = folders + FOLDERS_MAX - 1;
 
@@ -1143,8 +2147,13 @@ int folder_unregister(const char *folder_name)
 		return -ENOENT;
 
 	rs_dll_remove_all(&folder->preparations);
+	remove_preparations_of_folder(&ended_preparations, folder->name);
+	for (i = 0; i < PREPARATION_PRIORITY_NB; i++)
+		remove_preparations_of_folder(pending_preparations + i,
+				folder->name);
 	rs_dll_remove_all(&folder->entities);
 	rs_dll_remove_all(&folder->properties);
+	folder_snapshot_unref(&folder->snapshot);
 
 	for (; folder < max; folder++)
 		*folder = *(folder + 1);
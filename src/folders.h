@@ -28,6 +28,52 @@ struct folder_entity {
 	 * for exemple, contains union, ro... for an instance
 	 */
 	char *base_workspace;
+	/* last published snapshot, NULL if the entity changed since */
+	struct folder_entity_snapshot *snapshot;
+};
+
+/*
+ * snapshots are immutable once published and reference counted, thus a reader
+ * can keep using one while newer versions get published, the read commands are
+ * answered from them, without calling the property getters again
+ */
+struct folder_snapshot_property {
+	char *name;
+	char *value;
+};
+
+struct folder_entity_snapshot {
+	int refcount;
+	char *sha1;
+	char *name;
+	/* same format as the one returned by folder_get_info() */
+	char *info;
+	unsigned nb_properties;
+	struct folder_snapshot_property *properties;
+};
+
+/* entities sorted by the value of one of their properties */
+struct folder_snapshot_index {
+	char *property;
+	struct folder_entity_snapshot **entities;
+};
+
+struct folder_snapshot {
+	int refcount;
+	/* generation of the folder at the time the snapshot was taken */
+	uint32_t generation;
+	/* answer to a LIST command */
+	char *list;
+	/* answer to a PROPERTIES command */
+	char *properties;
+	unsigned nb_entities;
+	/* in the order of the folder's entities list */
+	struct folder_entity_snapshot **entities;
+	/* same entities sorted by sha1, for lookups and pagination */
+	struct folder_entity_snapshot **by_sha1;
+	/* one per property listed in FIRMWARED_INDEXED_PROPERTIES */
+	unsigned nb_indexes;
+	struct folder_snapshot_index *indexes;
 };
 
 struct folder;
@@ -71,7 +117,13 @@ struct folder {
 	struct folder_property name_property;
 	struct folder_property sha1_property;
 	struct folder_property base_workspace_property;
+	/* running preparations */
 	struct rs_dll preparations;
+	/* maximum number of preparations running at the same time */
+	unsigned max_preparations;
+	/* incremented each time an entity is stored, dropped or modified */
+	uint32_t generation;
+	struct folder_snapshot *snapshot;
 };
 
 int folders_init(void);
@@ -80,11 +132,37 @@ struct folder *folder_find(const char *folder_name);
 struct folder_entity *folder_next(const struct folder *folder,
 		struct folder_entity *entity);
 unsigned folder_get_count(const char *folder);
+/*
+ * origin is the id of the client issuing the command, if an identical
+ * preparation of a folder whose preparations are shareable is in progress, the
+ * command is attached to it
+ */
 int folder_prepare(const char *folder, const char *identification_string,
-		uint32_t seqnum);
+		uint32_t seqnum, uint32_t origin);
+/*
+ * destroys the ended preparations and starts the queued ones which can be, must
+ * be called at each loop iteration
+ */
 int folders_reap_preparations(void);
+/*
+ * the requests of the client origin for the preparation are answered with an
+ * ERROR (ECANCELED), the preparation is aborted if no other client's request
+ * remains, returns -EPERM if origin has no request for it, -EBUSY if it has
+ * started and can't be aborted
+ */
 int folder_preparation_abort(const char *folder,
-		const char *identification_string);
+		const char *identification_string, uint32_t origin);
+/*
+ * attaches the requests of the running preparation to into, which prepares the
+ * same entity, preparation then ends without notification
+ */
+int folder_preparation_merge(struct preparation *preparation,
+		struct preparation *into);
+/*
+ * aborts the preparations issued by the client origin, except those prepared
+ * with the detached=yes option, called when the client disconnects
+ */
+void folders_abort_preparations(uint32_t origin);
 int folder_drop(const char *folder, struct folder_entity *entity);
 /*
  * a folder_store call, transfers the ownership to the folder, except in case
@@ -107,6 +185,37 @@ int folder_entity_get_property(struct folder_entity *entity, const char *name,
 int folder_entity_set_property(struct folder_entity *entity, const char *name,
 		const char *value);
 int folder_add_property(const char *folder_name, const char *name);
+/*
+ * must be called each time an entity is modified without going through
+ * folder_entity_set_property(), so that the snapshots get updated
+ */
+void folder_entity_changed(struct folder_entity *entity);
+/* the snapshot returned must be released with folder_snapshot_unref() */
+struct folder_snapshot *folder_get_snapshot(const char *folder_name);
+void folder_snapshot_unref(struct folder_snapshot **snapshot);
+const struct folder_entity_snapshot *folder_snapshot_find(
+		const struct folder_snapshot *snapshot,
+		const char *entity_identifier);
+/*
+ * returns the index in by_sha1 of the first entity whose sha1 is greater or
+ * equal to sha1, or strictly greater if after is true, nb_entities if none
+ */
+unsigned folder_snapshot_seek(const struct folder_snapshot *snapshot,
+		const char *sha1, bool after);
+/*
+ * retrieves the entities whose property equals value, using the property's
+ * index, returns -ENOENT if the property isn't indexed
+ */
+int folder_snapshot_lookup(const struct folder_snapshot *snapshot,
+		const char *property, const char *value,
+		struct folder_entity_snapshot * const **entities,
+		unsigned *count);
+/* name is a property name, without the "[]" suffix of the array properties */
+bool folder_snapshot_has_property(const struct folder_snapshot *snapshot,
+		const char *name);
+const char *folder_entity_snapshot_get_property(
+		const struct folder_entity_snapshot *snapshot,
+		const char *name);
 int folder_unregister(const char *folder);
 void folders_cleanup(void);
 
@@ -11,12 +11,18 @@
 #include <openssl/sha.h>
 
 #include "../folders.h"
+#include "../process.h"
 
 struct firmware {
 	struct folder_entity entity;
 	char *path;
 	char *uuid;
 	char sha1[2 * SHA_DIGEST_LENGTH + 1];
+
+	/* for the asynchronous (u)mount */
+	struct hook hook;
+	/* set while the firmware is being prepared, NULL afterwards */
+	struct preparation *preparation;
 };
 
 #define to_firmware(p) ut_container_of(p, struct firmware, entity)
@@ -44,6 +44,8 @@ ULOG_DECLARE_TAG(firmwared_firmwares);
 #include "utils.h"
 #include "config.h"
 #include "process.h"
+#include "workers.h"
+#include "watchdog.h"
 #include "firmwares-private.h"
 #include "properties/firmware_properties.h"
 
@@ -59,6 +61,8 @@ ULOG_DECLARE_TAG(firmwared_firmwares);
 #define PREPARATION_TIMEOUT 10000
 #endif /* PREPARATION_TIMEOUT */
 
+#define PREPARATION_TIMEOUT_REARM_PERIOD (PREPARATION_TIMEOUT / 10)
+
 #ifndef PREPARATION_TIMEOUT_SIGNAL
 #define PREPARATION_TIMEOUT_SIGNAL SIGKILL
 #endif /* PREPARATION_TIMEOUT_SIGNAL */
@@ -69,6 +73,18 @@ struct firmware_preparation {
 	struct preparation preparation;
 	struct io_process process;
 	char *destination_file;
+	/* for the blocking steps, run in a worker */
+	struct worker_job job;
+	/* output of the curl hook's uuid action, i.e. "uuid=..." */
+	char uuid_output[BUF_SIZE];
+	/* firmware being indexed, before being mounted */
+	struct firmware *firmware;
+	/* true while the curl hook's fetch action is running */
+	bool fetching;
+	/* set on abort, checked at the end of each step, the mount included */
+	bool aborted;
+	/* last time the preparation timeout was rearmed */
+	struct timespec rearm_time;
 };
 
 static struct folder firmware_folder;
@@ -134,21 +150,15 @@ static const char *firmware_sha1(struct folder_entity *entity)
 	return compute_sha1(firmware);
 }
 
-static void unmount_firmware(struct firmware *firmware)
+/* if cb is NULL, umount is waited for */
+static int unmount_firmware(struct firmware *firmware, hook_cb cb)
 {
-	int ret;
-	struct io_process process;
 	const char *mount_dir =
 			folder_entity_get_base_workspace(&firmware->entity);
 
-	ret = io_process_init_prepare_launch_and_wait(&process,
-			&process_default_parameters, NULL, "/bin/umount",
+	return hook_launch(&firmware->hook, "umount",
+			&process_default_parameters, cb, "/bin/umount",
 			mount_dir, NULL);
-	if (ret < 0)
-		ULOGE("umount %s failed: %m", mount_dir);
-	else if (process.status != 0)
-		ULOGE("umount %s exited with status %d", mount_dir,
-				process.status);
 }
 
 static void firmware_delete(struct firmware **firmware)
@@ -159,13 +169,23 @@ static void firmware_delete(struct firmware **firmware)
 		return;
 	f = *firmware;
 
-	unmount_firmware(f);
 	ut_string_free(&f->path);
 	ut_string_free(&f->uuid);
 	free(f);
 	*firmware = NULL;
 }
 
+static void unmount_firmware_cb(struct hook *hook, int status)
+{
+	struct firmware *firmware = ut_container_of(hook, typeof(*firmware),
+			hook);
+
+	if (status != 0)
+		ULOGE("umount of %s failed: %s", firmware->path,
+				strerror(-status));
+	firmware_delete(&firmware);
+}
+
 static bool firmware_can_drop(struct folder_entity *entity)
 {
 	return true;
@@ -173,13 +193,25 @@ static bool firmware_can_drop(struct folder_entity *entity)
 
 static int firmware_drop(struct folder_entity *entity, bool only_unregister)
 {
+	int ret;
 	struct firmware *firmware = to_firmware(entity);
 
 	ULOGD("%s", __func__);
 
-	if (!only_unregister)
-		unlink(firmware->path);
-	firmware_delete(&firmware);
+	/* at exit, the main loop isn't running anymore */
+	if (only_unregister) {
+		ret = unmount_firmware(firmware, NULL);
+		if (ret < 0)
+			ULOGE("umount of %s failed: %s", firmware->path,
+					strerror(-ret));
+		firmware_delete(&firmware);
+		return 0;
+	}
+
+	unlink(firmware->path);
+	ret = unmount_firmware(firmware, unmount_firmware_cb);
+	if (ret < 0)
+		unmount_firmware_cb(&firmware->hook, ret);
 
 	return 0;
 }
@@ -244,6 +276,7 @@ static void preparation_progress_sep_cb(struct io_src_sep *sep, char *chunk,
 	firmware_preparation = ut_container_of(process,
 			struct firmware_preparation, process);
 	preparation = &firmware_preparation->preparation;
+	WATCHDOG_PROBE("curl hook output", preparation->identification_string);
 
 	chunk[len] = '\0';
 	ut_string_rstrip(chunk);
@@ -252,13 +285,18 @@ static void preparation_progress_sep_cb(struct io_src_sep *sep, char *chunk,
 
 	/*
 	 * rearm the "watch dog", we don't want to abort a working dl because it
-	 * took too long
+	 * took too long, no need to do it for each line of output though
 	 */
-	ret = io_process_set_timeout(process, PREPARATION_TIMEOUT,
-			PREPARATION_TIMEOUT_SIGNAL);
-	if (ret < 0)
-		ULOGW("resetting firmware preparation timeout failed: %s",
-				strerror(-ret));
+	if (time_elapsed_ms(&firmware_preparation->rearm_time) >=
+			PREPARATION_TIMEOUT_REARM_PERIOD) {
+		ret = io_process_set_timeout(process, PREPARATION_TIMEOUT,
+				PREPARATION_TIMEOUT_SIGNAL);
+		if (ret < 0)
+			ULOGW("resetting firmware preparation timeout failed: "
+					"%s", strerror(-ret));
+		clock_gettime(CLOCK_MONOTONIC,
+				&firmware_preparation->rearm_time);
+	}
 
 	if (ut_string_match_prefix(chunk, "destination_file=")) {
 		firmware_preparation->destination_file = strdup(chunk + 17);
@@ -268,60 +306,175 @@ static void preparation_progress_sep_cb(struct io_src_sep *sep, char *chunk,
 		 */
 		io_process_signal(process, SIGUSR1);
 	} else {
-		ret = firmwared_notify(FWD_ANSWER_PREPARE_PROGRESS,
-				FWD_FORMAT_ANSWER_PREPARE_PROGRESS,
-				preparation->seqnum, preparation->folder,
-				preparation->identification_string, chunk);
+		ret = preparation_notify_progress(preparation, chunk);
 		if (ret < 0)
-			ULOGE("firmwared_notify: %s", strerror(-ret));
+			ULOGE("preparation_notify_progress: %s",
+					strerror(-ret));
 	}
 }
 
-/* mounts the firmware so that the client can retrieve informations if needed */
-static int mount_firmware(struct firmware *firmware)
+static void firmware_preparation_failed(
+		struct firmware_preparation *firmware_preparation, int err)
+{
+	struct preparation *preparation = &firmware_preparation->preparation;
+
+	preparation_notify(preparation, PREPARATION_SCOPE(preparation),
+			FWD_ANSWER_ERROR, FWD_FORMAT(ANSWER_ERROR),
+			preparation->seqnum, -err, strerror(-err));
+
+	preparation->completion(preparation, NULL);
+}
+
+/* a partial download is removed by the curl hook itself */
+static void remove_destination_file(
+		struct firmware_preparation *firmware_preparation)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *path = NULL;
+
+	if (firmware_preparation->destination_file == NULL)
+		return;
+
+	ret = asprintf(&path, "%s/%s", config_get(CONFIG_REPOSITORY_PATH),
+			firmware_preparation->destination_file);
+	if (ret == -1) {
+		path = NULL;
+		ULOGE("asprintf error");
+		return;
+	}
+	ULOGI("removing %s", path);
+	ret = unlink(path);
+	if (ret == -1 && errno != ENOENT)
+		ULOGW("unlink %s: %m", path);
+}
+
+static void firmware_mounted(struct firmware *firmware, int status)
+{
+	int ret;
+	struct preparation *preparation = firmware->preparation;
+	struct firmware_preparation *firmware_preparation;
+
+	firmware_preparation = ut_container_of(preparation,
+			struct firmware_preparation, preparation);
+	if (status < 0)
+		ULOGW("mounting %s failed: %s", firmware->path,
+				strerror(-status));
+
+	firmware->preparation = NULL;
+	/* aborted while the mount hooks were running */
+	if (firmware_preparation->aborted) {
+		remove_destination_file(firmware_preparation);
+		ret = unmount_firmware(firmware, unmount_firmware_cb);
+		if (ret < 0)
+			unmount_firmware_cb(&firmware->hook, ret);
+		firmware_preparation_failed(firmware_preparation, -ECANCELED);
+		return;
+	}
+	preparation->completion(preparation, &firmware->entity);
+}
+
+static void firmware_mount_cb(struct hook *hook, int status)
+{
+	struct firmware *firmware = ut_container_of(hook, typeof(*firmware),
+			hook);
+
+	firmware_mounted(firmware, status);
+}
+
+/* if cb is NULL, mount is waited for */
+static int remount_firmware_read_only(struct firmware *firmware, hook_cb cb)
+{
+	const char *mount_dir =
+			folder_entity_get_base_workspace(&firmware->entity);
+
+	/*
+	 * The remount is necessary to make this bind mount read-only.
+	 * Trying to pass the ro option directly to the previous command
+	 * won't work, according to the man page, the mount options of
+	 * the bind mount will be the same as those of the original
+	 * mount.
+	 */
+	return hook_launch(&firmware->hook, "mount",
+			&process_default_parameters, cb, "/bin/mount",
+			"-o", "ro,remount,bind", firmware->path, mount_dir,
+			NULL);
+}
+
+static void firmware_bind_mount_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct firmware *firmware = ut_container_of(hook, typeof(*firmware),
+			hook);
+
+	if (status < 0) {
+		firmware_mounted(firmware, status);
+		return;
+	}
+
+	ret = remount_firmware_read_only(firmware, firmware_mount_cb);
+	if (ret < 0)
+		firmware_mounted(firmware, ret);
+}
+
+/*
+ * mounts the firmware so that the client can retrieve informations if needed
+ * when async is true, firmware_mounted() is called when the mount is done,
+ * otherwise, the mount is waited for
+ */
+static int mount_firmware(struct firmware *firmware, bool async)
 {
 	int ret;
-	int ret2;
-	struct io_process process;
 	const char *mount_dir =
 			folder_entity_get_base_workspace(&firmware->entity);
 
 	ret = mkdir(mount_dir, 0755);
 	if (ret == -1 && errno != EEXIST)
 		ULOGW("mkdir: %m");
-	if (ut_file_is_dir(firmware->path)) {
-		ret = io_process_init_prepare_launch_and_wait(&process,
-				&process_default_parameters, NULL, "/bin/mount",
-				"--bind", firmware->path, mount_dir,
-				NULL);
-		/*
-		 * The remount is necessary to make this bind mount read-only.
-		 * Trying to pass the ro option directly to the previous command
-		 * won't work, according to the man page, the mount options of
-		 * the bind mount will be the same as those of the original
-		 * mount.
-		 */
-		ret2 = io_process_init_prepare_launch_and_wait(&process,
-				&process_default_parameters, NULL, "/bin/mount",
-				"-o", "ro,remount,bind", firmware->path,
+	if (!ut_file_is_dir(firmware->path))
+		return hook_launch(&firmware->hook, "mount",
+				&process_default_parameters,
+				async ? firmware_mount_cb : NULL,
+				"/bin/mount", "-o", "ro,loop", firmware->path,
 				mount_dir, NULL);
-		if (ret2 < 0)
-			ULOGW("remounting %s read-only failed: %s", mount_dir,
-					strerror(-ret2));
-	} else {
-		ret = io_process_init_prepare_launch_and_wait(&process,
-				&process_default_parameters, NULL, "/bin/mount",
-				"-o", "ro,loop", firmware->path, mount_dir,
-				NULL);
-	}
 
-	return ret;
+	ret = hook_launch(&firmware->hook, "mount",
+			&process_default_parameters,
+			async ? firmware_bind_mount_cb : NULL,
+			"/bin/mount", "--bind", firmware->path, mount_dir,
+			NULL);
+	if (async || ret < 0)
+		return ret;
+
+	ret = remount_firmware_read_only(firmware, NULL);
+	if (ret < 0)
+		ULOGW("remounting %s read-only failed: %s", mount_dir,
+				strerror(-ret));
+
+	return 0;
+}
+
+/*
+ * computes the values of the firmware which are cached, this can take a long
+ * time for big firmwares, so it must be done either in a worker or before the
+ * main loop is started
+ */
+static int compute_firmware_data(struct firmware *firmware)
+{
+	if (compute_sha1(firmware) == NULL)
+		return -errno;
+	if (firmware_get_uuid(firmware) == NULL)
+		return -errno;
+
+	return 0;
 }
 
+/*
+ * the firmware's data aren't computed, nor is it mounted, it's up to the caller
+ * to do so
+ */
 static struct firmware *firmware_new(const char *path)
 {
 	int ret;
-	const char *sha1;
 	struct firmware *firmware;
 	const char *firmware_repository_path =
 			config_get(CONFIG_REPOSITORY_PATH);
@@ -331,6 +484,7 @@ static struct firmware *firmware_new(const char *path)
 	firmware = calloc(1, sizeof(*firmware));
 	if (firmware == NULL)
 		return NULL;
+	firmware->hook.owner = firmware->sha1;
 
 	firmware->entity.folder = folder_find(FIRMWARES_FOLDER_NAME);
 	if (ut_file_is_dir(path)) {
@@ -352,17 +506,6 @@ static struct firmware *firmware_new(const char *path)
 		}
 	}
 
-	/* force sha1 computation while in parallel section */
-	sha1 = compute_sha1(firmware);
-	if (sha1 == NULL)
-		goto err;
-
-	ret = mount_firmware(firmware);
-	if (ret < 0)
-		ULOGW("read_firmware_info failed: %s\n", strerror(-ret));
-
-	ULOGD("indexing firmware %s done", path);
-
 	return firmware;
 err:
 	firmware_delete(&firmware);
@@ -370,20 +513,89 @@ err:
 	return NULL;
 }
 
+static int index_firmware_work(struct worker_job *job)
+{
+	struct firmware_preparation *firmware_preparation;
+
+	firmware_preparation = ut_container_of(job,
+			struct firmware_preparation, job);
+
+	return compute_firmware_data(firmware_preparation->firmware);
+}
+
+static void index_firmware_done(struct worker_job *job, int status)
+{
+	int ret;
+	struct firmware_preparation *firmware_preparation;
+	struct firmware *firmware;
+
+	firmware_preparation = ut_container_of(job,
+			struct firmware_preparation, job);
+	firmware = firmware_preparation->firmware;
+	firmware_preparation->firmware = NULL;
+	if (status >= 0 && firmware_preparation->aborted) {
+		remove_destination_file(firmware_preparation);
+		status = -ECANCELED;
+	}
+	if (status < 0) {
+		ULOGE("indexing firmware %s failed: %s", firmware->path,
+				strerror(-status));
+		firmware_delete(&firmware);
+		firmware_preparation_failed(firmware_preparation, status);
+		return;
+	}
+	ULOGD("indexing firmware %s done", firmware->path);
+
+	/* the preparation is completed when the mount is done */
+	firmware->preparation = &firmware_preparation->preparation;
+	ret = mount_firmware(firmware, true);
+	if (ret < 0)
+		firmware_mounted(firmware, ret);
+}
+
+/* indexes, then mounts the firmware, in the background */
+static int index_and_mount_firmware(
+		struct firmware_preparation *firmware_preparation,
+		const char *path)
+{
+	int ret;
+
+	firmware_preparation->firmware = firmware_new(path);
+	if (firmware_preparation->firmware == NULL) {
+		ret = -errno;
+		ULOGE("firmware_new: %m");
+		return ret;
+	}
+
+	ret = workers_submit(&firmware_preparation->job, index_firmware_work,
+			index_firmware_done);
+	if (ret < 0) {
+		ULOGE("workers_submit: %s", strerror(-ret));
+		firmware_delete(&firmware_preparation->firmware);
+	}
+
+	return ret;
+}
+
 static void firmware_preparation_termination(struct io_process *process,
 		pid_t pid, int status)
 {
 	int ret;
 	struct firmware_preparation *firmware_preparation;
-	struct preparation *preparation;
-	struct firmware *firmware;
 
 	firmware_preparation = ut_container_of(process,
 			struct firmware_preparation, process);
+	WATCHDOG_PROBE("curl hook",
+			firmware_preparation->preparation.identification_string);
 	io_mon_remove_source(firmwared_get_mon(),
 		io_process_get_src(&firmware_preparation->process));
+	firmware_preparation->fetching = false;
 
-	preparation = &firmware_preparation->preparation;
+	if (firmware_preparation->aborted) {
+		remove_destination_file(firmware_preparation);
+		ret = -ECANCELED;
+		goto err;
+	}
 
 	if (status != 0) {
 		if (WIFSIGNALED(status)) {
@@ -398,46 +610,30 @@ static void firmware_preparation_termination(struct io_process *process,
 		}
 	}
 
-	/* TODO the following may block a long time */
-	firmware = firmware_new(firmware_preparation->destination_file);
-
-	preparation->completion(preparation, &firmware->entity);
+	ret = index_and_mount_firmware(firmware_preparation,
+			firmware_preparation->destination_file);
+	if (ret < 0)
+		goto err;
 
 	return;
 err:
-	firmwared_notify(FWD_ANSWER_ERROR, FWD_FORMAT_ANSWER_ERROR,
-			preparation->seqnum, -ret, strerror(-ret));
-
-	preparation->completion(preparation, NULL);
+	firmware_preparation_failed(firmware_preparation, ret);
 }
 
-static int firmware_preparation_start(struct preparation *preparation)
+static int retrieve_uuid_work(struct worker_job *job)
 {
 	int ret;
 	struct firmware_preparation *firmware_preparation;
-	struct firmware *firmware = NULL;
-	char buf[0x200] = {0};
-	char *pbuf = &buf[0];
-	const char *uuid = buf + 5;
-	const char *id = preparation->identification_string;
-
-	if (ut_file_is_dir(id)) {
-		ret = get_from_path(&firmware, id);
-		if (ret < 0)
-			return ret;
-		if (firmware == NULL)
-			firmware = firmware_new(id);
-		return preparation->completion(preparation, &firmware->entity);
-	}
-
-	firmware_preparation = ut_container_of(preparation,
-			struct firmware_preparation, preparation);
+	char *pbuf;
 
-	ret = ut_process_read_from_output(&pbuf, 0x200, "\"%s\" \"%s\" "
+	firmware_preparation = ut_container_of(job,
+			struct firmware_preparation, job);
+	pbuf = firmware_preparation->uuid_output;
+	ret = ut_process_read_from_output(&pbuf, BUF_SIZE, "\"%s\" \"%s\" "
 			"\"%s\" \"%s\" \"%s\" \"%s\"",
 			config_get(CONFIG_CURL_HOOK),
 			"uuid",
-			id,
+			firmware_preparation->preparation.identification_string,
 			config_get(CONFIG_REPOSITORY_PATH),
 			"", /* we don't know uuid yet, of course */
 			config_get(CONFIG_VERBOSE_HOOK_SCRIPTS));
@@ -445,15 +641,75 @@ static int firmware_preparation_start(struct preparation *preparation)
 		ULOGE("uuid retrieval failed");
 		return ret;
 	}
-
 	ut_string_rstrip(pbuf);
+
+	return 0;
+}
+
+/* e.g. the same firmware, requested from a mirror */
+static struct firmware_preparation *find_fetching_preparation(
+		struct firmware_preparation *firmware_preparation,
+		const char *uuid)
+{
+	struct rs_node *node = NULL;
+	struct firmware_preparation *other;
+	struct folder *folder = folder_find(FIRMWARES_FOLDER_NAME);
+
+	while ((node = rs_dll_next_from(&folder->preparations, node)) != NULL) {
+		other = ut_container_of(to_preparation(node),
+				struct firmware_preparation, preparation);
+		if (other == firmware_preparation || !other->fetching ||
+				other->aborted)
+			continue;
+		if (ut_string_match(other->uuid_output + 5, uuid) &&
+				preparation_options_match(&other->preparation,
+					&firmware_preparation->preparation))
+			return other;
+	}
+
+	return NULL;
+}
+
+static void retrieve_uuid_done(struct worker_job *job, int status)
+{
+	int ret;
+	struct firmware_preparation *firmware_preparation;
+	struct preparation *preparation;
+	struct firmware *firmware;
+	struct firmware_preparation *fetching;
+	const char *uuid;
+
+	firmware_preparation = ut_container_of(job,
+			struct firmware_preparation, job);
+	preparation = &firmware_preparation->preparation;
+	if (status < 0) {
+		ret = status;
+		goto err;
+	}
+	if (firmware_preparation->aborted) {
+		ret = -ECANCELED;
+		goto err;
+	}
+	uuid = firmware_preparation->uuid_output + 5;
+
 	/*
 	 * the uuid corresponds to an already registered firmware, nothing to
 	 * do and we consider it a success
 	 */
 	if (uuid_already_registered(uuid)) {
 		firmware = get_from_uuid(uuid);
-		return preparation->completion(preparation, &firmware->entity);
+		preparation->completion(preparation, &firmware->entity);
+		return;
+	}
+
+	/* don't download the same firmware twice at the same time */
+	fetching = find_fetching_preparation(firmware_preparation, uuid);
+	if (fetching != NULL) {
+		ret = folder_preparation_merge(preparation,
+				&fetching->preparation);
+		if (ret < 0)
+			goto err;
+		return;
 	}
 
 	ret = io_process_init_prepare_and_launch(&firmware_preparation->process,
@@ -470,16 +726,52 @@ static int firmware_preparation_start(struct preparation *preparation)
 			firmware_preparation_termination,
 			config_get(CONFIG_CURL_HOOK),
 			"fetch",
-			id,
+			preparation->identification_string,
 			config_get(CONFIG_REPOSITORY_PATH),
 			uuid,
 			config_get(CONFIG_VERBOSE_HOOK_SCRIPTS),
 			NULL);
 	if (ret < 0)
-		return ret;
+		goto err;
 
-	return io_mon_add_source(firmwared_get_mon(),
+	ret = io_mon_add_source(firmwared_get_mon(),
 			io_process_get_src(&firmware_preparation->process));
+	if (ret < 0)
+		goto err;
+	firmware_preparation->fetching = true;
+
+	return;
+err:
+	firmware_preparation_failed(firmware_preparation, ret);
+}
+
+/*
+ * the uuid retrieval, the indexing and the mount are done in the background,
+ * the download is done by the curl hook, launched asynchronously too
+ */
+static int firmware_preparation_start(struct preparation *preparation)
+{
+	int ret;
+	struct firmware_preparation *firmware_preparation;
+	struct firmware *firmware = NULL;
+	const char *id = preparation->identification_string;
+
+	firmware_preparation = ut_container_of(preparation,
+			struct firmware_preparation, preparation);
+
+	if (ut_file_is_dir(id)) {
+		ret = get_from_path(&firmware, id);
+		if (ret < 0)
+			return ret;
+		if (firmware != NULL)
+			return preparation->completion(preparation,
+					&firmware->entity);
+
+		return index_and_mount_firmware(firmware_preparation, id);
+	}
+
+	return workers_submit(&firmware_preparation->job, retrieve_uuid_work,
+			retrieve_uuid_done);
 }
 
 static void firmware_preparation_abort(struct preparation *preparation)
@@ -491,10 +783,18 @@ static void firmware_preparation_abort(struct preparation *preparation)
 			struct firmware_preparation, preparation);
 	process = &firmware_preparation->process;
 
-	ULOGE("[%s] abort preparation of '%s'", preparation->folder,
+	ULOGI("[%s] abort preparation of '%s'", preparation->folder,
 			preparation->identification_string);
 
-	io_process_signal(process, SIGUSR1);
+	/*
+	 * the steps run in workers can't be interrupted, they're short, the
+	 * preparation fails when they're done. SIGUSR1 would tell the curl
+	 * hook the download is complete, SIGTERM makes it kill curl and pv and
+	 * remove the partial file
+	 */
+	firmware_preparation->aborted = true;
+	if (firmware_preparation->fetching)
+		io_process_signal(process, SIGTERM);
 }
 
 static struct preparation *firmware_get_preparation(void)
@@ -508,6 +808,7 @@ static struct preparation *firmware_get_preparation(void)
 	firmware_preparation->preparation.start = firmware_preparation_start;
 	firmware_preparation->preparation.abort = firmware_preparation_abort;
 	firmware_preparation->preparation.folder = FIRMWARES_FOLDER_NAME;
+	firmware_preparation->preparation.shareable = true;
 
 	return &firmware_preparation->preparation;
 }
@@ -554,6 +855,32 @@ static void free_firmwares(struct firmware ***firmwares)
 	*firmwares = NULL;
 }
 
+/* the main loop isn't running yet, the mount can be waited for */
+static struct firmware *index_firmware(const char *path)
+{
+	int ret;
+	struct firmware *firmware;
+
+	firmware = firmware_new(path);
+	if (firmware == NULL)
+		return NULL;
+
+	/* force the data computation while in parallel section */
+	ret = compute_firmware_data(firmware);
+	if (ret < 0) {
+		ULOGE("indexing firmware %s failed: %s", path, strerror(-ret));
+		firmware_delete(&firmware);
+		return NULL;
+	}
+	ULOGD("indexing firmware %s done", path);
+
+	ret = mount_firmware(firmware, false);
+	if (ret < 0)
+		ULOGW("read_firmware_info failed: %s\n", strerror(-ret));
+
+	return firmware;
+}
+
 static int index_firmwares(void)
 {
 	int i;
@@ -580,7 +907,7 @@ static int index_firmwares(void)
 	{
 #pragma omp parallel for
 		for (i = 0; i < n; i++) {
-			firmwares[i] = firmware_new(namelist[i]->d_name);
+			firmwares[i] = index_firmware(namelist[i]->d_name);
 			free(namelist[i]);
 		}
 	}
@@ -621,6 +948,8 @@ int firmwares_init(void)
 
 	firmware_folder.name = FIRMWARES_FOLDER_NAME;
 	memcpy(&firmware_folder.ops, &firmware_ops, sizeof(firmware_ops));
+	firmware_folder.max_preparations = config_get_int(
+			CONFIG_MAX_FIRMWARE_PREPARATIONS);
 	ret = folder_register(&firmware_folder);
 	if (ret < 0) {
 		ULOGE("folder_register: %s", strerror(-ret));
@@ -22,6 +22,8 @@
 #include <ptspair.h>
 
 #include "../folders.h"
+#include "../process.h"
+#include "../workers.h"
 
 enum instance_state {
 	INSTANCE_READY,
@@ -37,6 +39,26 @@ struct instance {
 	char sha1[2 * SHA_DIGEST_LENGTH + 1];
 	char *info;
 	uint32_t killer_seqnum;
+	/* id of the client which issued the KILL command */
+	uint32_t killer_origin;
+
+	/*
+	 * the hooks of an instance are run asynchronously, one at a time, an
+	 * operation (start, remount...) is running as long as the hook is
+	 */
+	struct hook hook;
+	/* seqnum of the command which triggered the running operation */
+	uint32_t operation_seqnum;
+	uint32_t operation_origin;
+	/* set while the instance is being prepared, NULL afterwards */
+	struct preparation *preparation;
+	/* the monitor died during an operation, handled when it ends */
+	bool death_pending;
+	/* called once the running start or kill is over, NULL if none */
+	instance_done_cb done_cb;
+	void *done_data;
+	/* for the blocking file system operations */
+	struct worker_job job;
 
 	/* synchronization between monitor and pid 1 */
 	struct ut_process_sync sync;
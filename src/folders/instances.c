@@ -69,6 +69,8 @@ ULOG_DECLARE_TAG(firmwared_instances);
 #include "config.h"
 #include "firmwared.h"
 #include "apparmor.h"
+#include "workers.h"
+#include "watchdog.h"
 #include "instances-private.h"
 #include "properties/instance_properties.h"
 
@@ -82,6 +84,14 @@ ULOG_DECLARE_TAG(firmwared_instances);
  */
 #define NET_BITS "24"
 
+/* scope of the notifications concerning an instance */
+#define INSTANCE_SCOPE(i, o) (&(struct notification_scope) { \
+	.origin = (o), \
+	.folder = INSTANCES_FOLDER_NAME, \
+	.entity = instance_get_sha1(i), \
+	.name = instance_get_name(i), \
+})
+
 static ut_bit_field indices;
 
 static struct folder instances_folder;
@@ -141,15 +151,13 @@ static void clean_paths(struct instance *instance)
 	ut_string_free(&instance->nvidia_path);
 }
 
+/* if cb is NULL, the hook is waited for */
 static int invoke_mount_helper(struct instance *instance, const char *action,
-		bool only_unregister)
+		bool only_unregister, hook_cb cb)
 {
-	int ret;
-	struct io_process process;
-
-	ret = io_process_init_prepare_launch_and_wait(&process,
+	return hook_launch(&instance->hook, "mount",
 			&process_default_parameters,
-			NULL,
+			cb,
 			config_get(CONFIG_MOUNT_HOOK),
 			action,
 			folder_entity_get_base_workspace(&instance->entity),
@@ -166,24 +174,20 @@ static int invoke_mount_helper(struct instance *instance, const char *action,
 			config_get(CONFIG_PREVENT_REMOVAL),
 			config_get(CONFIG_VERBOSE_HOOK_SCRIPTS),
 			NULL /* NULL guard */);
-	if (ret < 0)
-		return ret;
-
-	return process.status == 0 ? 0 : -ECANCELED;
 }
 
-static int invoke_net_helper(struct instance *i, const char *action)
+/* if cb is NULL, the hook is waited for */
+static int invoke_net_helper(struct instance *i, const char *action,
+		hook_cb cb)
 {
 	char pid[10]; /* max is 1 << 22 -> 7 digits in base 10 */
 	char id[10]; /* max is 255 */
-	int ret;
-	struct io_process process;
 
 	snprintf(pid, 10, "%jd", (intmax_t)i->pid);
 	snprintf(id, 10, "%"PRIu8, i->id);
-	ret = io_process_init_prepare_launch_and_wait(&process,
-			&process_default_parameters,
-			NULL,
+
+	return hook_launch(&i->hook, "net", &process_default_parameters,
+			cb,
 			config_get(CONFIG_NET_HOOK),
 			action,
 			i->interface,
@@ -196,43 +200,23 @@ static int invoke_net_helper(struct instance *i, const char *action)
 			pid,
 			config_get(CONFIG_VERBOSE_HOOK_SCRIPTS),
 			NULL /* NULL guard */);
-	if (ret < 0)
-		return ret;
-
-	return process.status == 0 ? 0 : -ECANCELED;
 }
 
-static int invoke_post_prepare_instance_helper(struct instance *instance)
+static int invoke_post_prepare_instance_helper(struct instance *instance,
+		hook_cb cb)
 {
-	int ret;
-	struct io_process process;
 	struct io_process_parameters parameters = process_default_parameters;
 
 	parameters.timeout = POST_PREPARATION_TIMEOUT;
 
-	/* TODO this blocks too much time */
-	ret = io_process_init_prepare_launch_and_wait(&process,
+	return hook_launch(&instance->hook, "post_prepare_instance",
 			&parameters,
-			NULL,
+			cb,
 			config_get(CONFIG_POST_PREPARE_INSTANCE_HOOK),
 			instance->union_mount_point,
 			instance->firmware_path,
 			config_get(CONFIG_VERBOSE_HOOK_SCRIPTS),
 			NULL /* NULL guard */);
-	if (ret < 0)
-		return ret;
-
-	return process.status == 0 ? 0 : -ECANCELED;
-}
-
-static void clean_mount_points(struct instance *instance, bool only_unregister)
-{
-	int ret;
-
-	ret = invoke_mount_helper(instance, "clean", only_unregister);
-	if (ret != 0)
-		ULOGE("invoke_mount_helper clean returned %d", ret);
-	clean_paths(instance);
 }
 
 static void clean_command_line(struct instance *instance)
@@ -246,11 +230,10 @@ static void clean_command_line(struct instance *instance)
 	instance->command_line_len = 0;
 }
 
-static void clean_instance(struct instance *i, bool only_unregister)
+/* releases what doesn't need a hook to be cleaned */
+static void clean_instance(struct instance *i)
 {
 	clean_command_line(i);
-	if (!config_get_bool(CONFIG_DISABLE_APPARMOR))
-		apparmor_remove_profile(instance_get_sha1(i));
 	ut_process_sync_clean(&i->sync);
 	io_mon_remove_sources(firmwared_get_mon(),
 			io_src_evt_get_source(&i->monitor_evt),
@@ -260,13 +243,121 @@ static void clean_instance(struct instance *i, bool only_unregister)
 	io_src_clean(&i->ptspair_src);
 
 	ptspair_clean(&i->ptspair);
-	clean_mount_points(i, only_unregister);
+}
 
+static void free_instance(struct instance *i)
+{
+	clean_paths(i);
 	ut_string_free(&i->stolen_interface);
 	ut_string_free(&i->interface);
 	ut_string_free(&i->firmware_path);
 	ut_bit_field_release_index(&indices, i->id);
 	memset(i, 0, sizeof(*i));
+	free(i);
+}
+
+static int remove_workspace_work(struct worker_job *job)
+{
+	struct instance *i = ut_container_of(job, typeof(*i), job);
+
+	return remove_tree(folder_entity_get_base_workspace(&i->entity));
+}
+
+static void remove_workspace_done(struct worker_job *job, int status)
+{
+	struct instance *i = ut_container_of(job, typeof(*i), job);
+
+	if (status < 0)
+		ULOGE("removing the run artifacts of %s failed: %s",
+				instance_get_sha1(i), strerror(-status));
+
+	free_instance(i);
+}
+
+static void destroy_mount_points_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *i = ut_container_of(hook, typeof(*i), hook);
+
+	/* on error, something may still be mounted, don't remove anything */
+	if (status != 0) {
+		ULOGE("invoke_mount_helper clean returned %d", status);
+		free_instance(i);
+		return;
+	}
+	if (config_get_bool(CONFIG_PREVENT_REMOVAL)) {
+		free_instance(i);
+		return;
+	}
+
+	ret = workers_submit(&i->job, remove_workspace_work,
+			remove_workspace_done);
+	if (ret < 0)
+		remove_workspace_done(&i->job, ret);
+}
+
+static void destroy_profile_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *i = ut_container_of(hook, typeof(*i), hook);
+
+	if (status != 0)
+		ULOGE("apparmor_remove_profile returned %d", status);
+
+	/* the paths are needed by the hook, nothing to clean without them */
+	if (i->ro_mount_point == NULL) {
+		free_instance(i);
+		return;
+	}
+	ret = invoke_mount_helper(i, "clean", false, destroy_mount_points_cb);
+	if (ret < 0)
+		destroy_mount_points_cb(hook, ret);
+}
+
+static void instance_done(struct instance *instance, int status)
+{
+	instance_done_cb cb = instance->done_cb;
+
+	if (cb == NULL)
+		return;
+	instance->done_cb = NULL;
+	cb(instance, status, instance->done_data);
+}
+
+/*
+ * at exit, the main loop isn't running anymore, so the hooks are waited for,
+ * otherwise, the instance is freed when they are all done
+ */
+static void destroy_instance(struct instance *i, bool only_unregister)
+{
+	int ret;
+	bool apparmor = !config_get_bool(CONFIG_DISABLE_APPARMOR);
+
+	instance_done(i, -ECANCELED);
+	clean_instance(i);
+
+	if (only_unregister) {
+		if (apparmor)
+			apparmor_remove_profile(NULL, NULL,
+					instance_get_sha1(i));
+		if (i->ro_mount_point != NULL) {
+			ret = invoke_mount_helper(i, "clean", true, NULL);
+			if (ret != 0)
+				ULOGE("invoke_mount_helper clean returned %d",
+						ret);
+		}
+		free_instance(i);
+		return;
+	}
+
+	if (!apparmor) {
+		destroy_profile_cb(&i->hook, 0);
+		return;
+	}
+	ret = apparmor_remove_profile(&i->hook, destroy_profile_cb,
+			instance_get_sha1(i));
+	if (ret < 0)
+		destroy_profile_cb(&i->hook, ret);
 }
 
 static bool instance_is_running(struct instance *instance)
@@ -278,7 +369,8 @@ static bool instance_can_drop(struct folder_entity *entity)
 {
 	struct instance *instance = to_instance(entity);
 
-	return !instance_is_running(instance);
+	return !instance_is_running(instance) &&
+			!hook_is_running(&instance->hook);
 }
 
 static int instance_drop(struct folder_entity *entity, bool only_unregister)
@@ -290,7 +382,7 @@ static int instance_drop(struct folder_entity *entity, bool only_unregister)
 	if (instance_is_running(instance)) {
 		ULOGW("instance %s still running, try to kill and wait for it",
 				instance_get_name(instance));
-		instance_kill(instance, (uint32_t)-1);
+		instance_kill(instance, (uint32_t)-1, 0);
 		sleep(1);
 	}
 	instance_delete(&instance, only_unregister);
@@ -419,27 +511,66 @@ err:
 	return ret;
 }
 
-static int init_mount_points(struct instance *instance)
+/* reports the failure of the running operation to it's requester */
+static void instance_operation_failed(struct instance *instance, int err)
 {
 	int ret;
 
-	ret = init_paths(instance);
-	if (ret < 0) {
-		ULOGE("init_paths: %s", strerror(-ret));
-		goto err;
-	}
-	ret = invoke_mount_helper(instance, "init", false);
-	if (ret != 0) {
-		ULOGE("invoke_mount_helper init returned %d", ret);
-		ret = -ENOTRECOVERABLE;
-		goto err;
-	}
+	ret = firmwared_notify(INSTANCE_SCOPE(instance,
+			instance->operation_origin), FWD_ANSWER_ERROR,
+			FWD_FORMAT(ANSWER_ERROR), instance->operation_seqnum,
+			-err, strerror(-err));
+	if (ret < 0)
+		ULOGE("firmwared_notify : err=%d(%s)", ret, strerror(-ret));
+}
 
-	return 0;
-err:
-	clean_mount_points(instance, false);
+static void set_state(struct instance *instance, enum instance_state state)
+{
+	instance->state = state;
+	folder_entity_changed(&instance->entity);
+}
 
-	return ret;
+static void net_clean_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *i = ut_container_of(hook, typeof(*i), hook);
+
+	if (status != 0)
+		ULOGE("invoke_net_helper clean returned %d", status);
+
+	set_state(i, INSTANCE_READY);
+
+	ret = firmwared_notify(INSTANCE_SCOPE(i, i->killer_origin),
+			FWD_ANSWER_DEAD, FWD_FORMAT(ANSWER_DEAD),
+			i->killer_seqnum, instance_get_sha1(i),
+			instance_get_name(i));
+	i->killer_seqnum = (uint32_t)-1;
+	i->killer_origin = 0;
+	if (ret < 0)
+		ULOGE("firmwared_notify : err=%d(%s)", ret, strerror(-ret));
+	instance_done(i, 0);
+}
+
+static void instance_died(struct instance *i)
+{
+	int ret;
+
+	/* no more kill allowed, the pid isn't ours anymore */
+	set_state(i, INSTANCE_STOPPING);
+	ret = invoke_net_helper(i, "clean", net_clean_cb);
+	if (ret < 0)
+		net_clean_cb(&i->hook, ret);
+}
+
+/* must be called at the end of each operation, i.e. when it's hook is done */
+static void instance_operation_done(struct instance *i)
+{
+	i->operation_seqnum = (uint32_t)-1;
+	i->operation_origin = 0;
+	if (i->death_pending) {
+		i->death_pending = false;
+		instance_died(i);
+	}
 }
 
 static void monitor_evt_cb(struct io_src_evt *evt, uint64_t ignored)
@@ -447,6 +578,7 @@ static void monitor_evt_cb(struct io_src_evt *evt, uint64_t ignored)
 	int ret;
 	int program_status;
 	struct instance *i = ut_container_of(evt, typeof(*i), monitor_evt);
+	WATCHDOG_PROBE("instance death", i->sha1);
 
 	ret = waitpid(i->pid, &program_status, 0);
 	if (ret < 0) {
@@ -455,18 +587,10 @@ static void monitor_evt_cb(struct io_src_evt *evt, uint64_t ignored)
 	}
 	ULOGD("waitpid said %d", program_status);
 
-	ret = invoke_net_helper(i, "clean");
-	if (ret != 0)
-		ULOGE("invoke_net_helper assign returned %d", ret);
-
-	i->state = INSTANCE_READY;
-
-	ret = firmwared_notify(FWD_ANSWER_DEAD, FWD_FORMAT_ANSWER_DEAD,
-			i->killer_seqnum, instance_get_sha1(i),
-			instance_get_name(i));
-	i->killer_seqnum = (uint32_t)-1;
-	if (ret < 0)
-		ULOGE("firmwared_notify : err=%d(%s)", ret, strerror(-ret));
+	if (hook_is_running(&i->hook))
+		i->death_pending = true;
+	else
+		instance_died(i);
 }
 
 static void ptspair_src_cb(struct io_src *src)
@@ -474,6 +598,7 @@ static void ptspair_src_cb(struct io_src *src)
 	int ret;
 	struct instance *i = ut_container_of(src, typeof(*i), ptspair_src);
 	struct ptspair *ptspair = &i->ptspair;
+	WATCHDOG_PROBE("ptspair", i->sha1);
 
 	ret = ptspair_process_events(ptspair);
 	if (ret < 0) {
@@ -671,7 +796,7 @@ static void launch_instance(struct instance *instance)
 	if (ret < 0)
 		ULOGE("ut_process_sync_child_lock: parent/child "
 				"synchronisation failed: %s", strerror(-ret));
-	ret = invoke_net_helper(instance, "config");
+	ret = invoke_net_helper(instance, "config", NULL);
 	if (ret != 0) {
 		ULOGE("invoke_net_helper config returned %d", ret);
 		_exit(EXIT_FAILURE);
@@ -843,34 +968,69 @@ static int init_command_line(struct instance *instance)
 #undef RO_BOOT_CONSOLE
 }
 
-static int init_instance(struct instance *instance,
-		struct folder_entity *firmware_entity)
+static void instance_preparation_failed(struct instance *instance, int err)
 {
 	int ret;
-	struct firmware *firmware;
+	struct preparation *preparation = instance->preparation;
+
+	ULOGE("preparation of instance %s failed: %s",
+			instance_get_sha1(instance), strerror(-err));
+	instance->preparation = NULL;
+	ret = preparation_notify(preparation, PREPARATION_SCOPE(preparation),
+			FWD_ANSWER_ERROR, FWD_FORMAT(ANSWER_ERROR),
+			preparation->seqnum, -err, strerror(-err));
+	if (ret < 0)
+		ULOGE("preparation_notify : err=%d(%s)", ret, strerror(-ret));
+	destroy_instance(instance, false);
 
-	firmware = firmware_from_entity(firmware_entity);
+	preparation->completion(preparation, NULL);
+}
 
-	instance->entity.folder = folder_find(INSTANCES_FOLDER_NAME);
-	instance->id = ut_bit_field_claim_free_index(&indices);
-	if (instance->id == UT_BIT_FIELD_INVALID_INDEX) {
-		ULOGE("ut_bit_field_claim_free_index: No free index");
-		return -ENOMEM;
+static void post_prepare_cb(struct hook *hook, int status)
+{
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
+	struct preparation *preparation = instance->preparation;
+
+	if (status < 0)
+		ULOGW("invoke_post_prepare_instance_helper failed: %d", status);
+
+	instance->preparation = NULL;
+	preparation->completion(preparation, instance_to_entity(instance));
+}
+
+static void apparmor_load_profile_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
+
+	if (status < 0) {
+		ULOGE("apparmor_load_profile: %s", strerror(-status));
+		instance_preparation_failed(instance, status);
+		return;
 	}
-	instance->time = time(NULL);
-	instance->state = INSTANCE_READY;
-	instance->killer_seqnum = (uint32_t)-1;
-	instance->firmware_path = strdup(firmware_get_path(firmware));
-	instance->interface = strdup(config_get(CONFIG_CONTAINER_INTERFACE));
-	if (instance->firmware_path == NULL || instance->interface == NULL) {
-		ret = -ENOMEM;
-		goto err;
+	ret = init_command_line(instance);
+	if (ret < 0) {
+		ULOGE("init_command_line: %s", strerror(-ret));
+		instance_preparation_failed(instance, ret);
+		return;
 	}
 
-	ret = init_mount_points(instance);
-	if (ret < 0) {
-		ULOGE("install_mount_points");
-		errno = -ret;
+	ret = invoke_post_prepare_instance_helper(instance, post_prepare_cb);
+	if (ret < 0)
+		post_prepare_cb(hook, ret);
+}
+
+static void mount_init_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
+
+	if (status != 0) {
+		ULOGE("invoke_mount_helper init returned %d", status);
+		ret = -ENOTRECOVERABLE;
 		goto err;
 	}
 
@@ -905,48 +1065,123 @@ static int init_instance(struct instance *instance,
 		ULOGE("ut_process_sync_init: %s", strerror(-ret));
 		goto err;
 	}
-	if (!config_get_bool(CONFIG_DISABLE_APPARMOR)) {
-		ret = apparmor_load_profile(folder_entity_get_base_workspace(
-						&instance->entity),
-				instance_get_sha1(instance));
-		if (ret < 0) {
-			ULOGE("apparmor_load_profile: %s", strerror(-ret));
-			goto err;
-		}
+	if (config_get_bool(CONFIG_DISABLE_APPARMOR)) {
+		apparmor_load_profile_cb(hook, 0);
+		return;
 	}
-	ret = init_command_line(instance);
+	ret = apparmor_load_profile(&instance->hook, apparmor_load_profile_cb,
+			folder_entity_get_base_workspace(&instance->entity),
+			instance_get_sha1(instance));
+	if (ret < 0)
+		apparmor_load_profile_cb(hook, ret);
+
+	return;
+err:
+	instance_preparation_failed(instance, ret);
+}
+
+static int create_workspace_work(struct worker_job *job)
+{
+	int ret;
+	struct instance *instance = ut_container_of(job, typeof(*instance),
+			job);
+	char __attribute__((cleanup(ut_string_free))) *workdir = NULL;
+
+	ret = mkdir_tree(instance->ro_mount_point, 0755);
+	if (ret < 0)
+		return ret;
+	ret = mkdir_tree(instance->rw_dir, 0755);
+	if (ret < 0)
+		return ret;
+	ret = mkdir_tree(instance->union_mount_point, 0755);
+	if (ret < 0)
+		return ret;
+	ret = asprintf(&workdir, "%s/workdir",
+			folder_entity_get_base_workspace(&instance->entity));
 	if (ret < 0) {
-		ULOGE("init_command_line: %s", strerror(-ret));
-		goto err;
+		workdir = NULL;
+		return -ENOMEM;
+	}
+
+	return mkdir_tree(workdir, 0755);
+}
+
+static void create_workspace_done(struct worker_job *job, int status)
+{
+	int ret;
+	struct instance *instance = ut_container_of(job, typeof(*instance),
+			job);
+
+	if (status < 0) {
+		ULOGE("creating the workspace of %s failed: %s",
+				instance_get_sha1(instance), strerror(-status));
+		instance_preparation_failed(instance, status);
+		return;
 	}
 
-	ret = invoke_post_prepare_instance_helper(instance);
+	ret = invoke_mount_helper(instance, "init", false, mount_init_cb);
 	if (ret < 0)
-		ULOGW("invoke_post_prepare_instance_helper failed: %d", ret);
+		mount_init_cb(&instance->hook, ret);
+}
 
-	return 0;
-err:
-	clean_instance(instance, false);
+/*
+ * initializes what can be without blocking, then launches the preparation
+ * chain: create_workspace_done -> mount_init_cb -> apparmor_load_profile_cb
+ * -> post_prepare_cb
+ */
+static int init_instance(struct instance *instance,
+		struct folder_entity *firmware_entity)
+{
+	int ret;
+	struct firmware *firmware;
 
-	return ret;
+	firmware = firmware_from_entity(firmware_entity);
+
+	instance->entity.folder = folder_find(INSTANCES_FOLDER_NAME);
+	instance->id = ut_bit_field_claim_free_index(&indices);
+	if (instance->id == UT_BIT_FIELD_INVALID_INDEX) {
+		ULOGE("ut_bit_field_claim_free_index: No free index");
+		return -ENOMEM;
+	}
+	instance->time = time(NULL);
+	instance->state = INSTANCE_READY;
+	instance->killer_seqnum = (uint32_t)-1;
+	instance->killer_origin = 0;
+	instance->operation_seqnum = (uint32_t)-1;
+	instance->operation_origin = 0;
+	instance->firmware_path = strdup(firmware_get_path(firmware));
+	instance->interface = strdup(config_get(CONFIG_CONTAINER_INTERFACE));
+	if (instance->firmware_path == NULL || instance->interface == NULL)
+		return -ENOMEM;
+
+	ret = init_paths(instance);
+	if (ret < 0) {
+		ULOGE("init_paths: %s", strerror(-ret));
+		return ret;
+	}
+
+	return workers_submit(&instance->job, create_workspace_work,
+			create_workspace_done);
 }
 
-static struct instance *instance_new(const char *firmware_identifier)
+static struct instance *instance_new(struct preparation *preparation)
 {
 	int ret;
 	struct instance *instance;
 	struct folder_entity *firmware_entity;
 
-	instance = calloc(1, sizeof(*instance));
-	if (instance == NULL)
-		return NULL;
-
 	firmware_entity = folder_find_entity(FIRMWARES_FOLDER_NAME,
-			firmware_identifier);
-
+			preparation->identification_string);
 	if (firmware_entity == NULL)
 		return NULL;
 
+	instance = calloc(1, sizeof(*instance));
+	if (instance == NULL)
+		return NULL;
+	instance->preparation = preparation;
+	/* filled by init_instance(), before any hook is launched */
+	instance->hook.owner = instance->sha1;
+
 	ret = init_instance(instance, firmware_entity);
 	if (ret < 0) {
 		ULOGE("init_instance: %s", strerror(-ret));
@@ -955,19 +1190,21 @@ static struct instance *instance_new(const char *firmware_identifier)
 
 	return instance;
 err:
-	instance_delete(&instance, false);
+	instance->preparation = NULL;
+	destroy_instance(instance, false);
 
 	errno = -ret;
 
 	return NULL;
 }
 
+/* the preparation completes when the hooks chain launched here ends */
 static int instance_preparation_start(struct preparation *preparation)
 {
 	int ret;
 	struct instance *instance;
 
-	instance = instance_new(preparation->identification_string);
+	instance = instance_new(preparation);
 	if (instance == NULL) {
 		ret = -errno;
 		ULOGE("instance_new(%s): %m",
@@ -975,8 +1212,7 @@ static int instance_preparation_start(struct preparation *preparation)
 		return ret;
 	}
 
-	return preparation->completion(preparation,
-			instance_to_entity(instance));
+	return 0;
 }
 
 static struct preparation *instance_get_preparation(void)
@@ -1035,6 +1271,8 @@ int instances_init(void)
 
 	instances_folder.name = INSTANCES_FOLDER_NAME;
 	memcpy(&instances_folder.ops, &instance_ops, sizeof(instance_ops));
+	instances_folder.max_preparations = config_get_int(
+			CONFIG_MAX_INSTANCE_PREPARATIONS);
 	ret = folder_register(&instances_folder);
 	if (ret < 0) {
 		ULOGE("folder_register: %s", strerror(-ret));
@@ -1098,44 +1336,69 @@ static int read_stolen_btusb_id(struct instance *instance)
 	return 0;
 }
 
-int instance_start(struct instance *instance)
+static void net_assign_cb(struct hook *hook, int status)
 {
 	int ret;
-	pid_t pid;
-
-	if (instance == NULL)
-		return -EINVAL;
-
-	if (instance->state != INSTANCE_READY) {
-		ULOGW("wrong state %s for instance %s",
-				instance_state_to_str(instance->state),
-				instance_get_sha1(instance));
-		return -EBUSY;
-	}
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
 
+	if (status != 0)
+		ULOGE("invoke_net_helper assign returned %d", status);
 	/*
-	 * the veth pair must be re-created at each instance startup, because it
-	 * is automatically deleted at the namespace's destruction
+	 * now the interface has been assigned to the child's name space, the
+	 * child can be unlocked and can now configure the interface to fit it's
+	 * needs
 	 */
-	ret = invoke_net_helper(instance, "create");
-	if (ret != 0) {
-		ULOGE("invoke_net_helper create returned %d", ret);
-		return -EBUSY;
+	ret = ut_process_sync_parent_unlock(&instance->sync);
+	if (ret < 0)
+		ULOGE("ut_process_sync_parent_unlock: parent/child "
+				"synchronisation failed: %s", strerror(-ret));
+
+	ret = firmwared_notify(INSTANCE_SCOPE(instance,
+			instance->operation_origin), FWD_ANSWER_STARTED,
+			FWD_FORMAT(ANSWER_STARTED),
+			instance->operation_seqnum, instance_get_sha1(instance),
+			instance_get_name(instance));
+	if (ret < 0)
+		ULOGE("firmwared_notify : err=%d(%s)", ret, strerror(-ret));
+
+	instance_operation_done(instance);
+	instance_done(instance, 0);
+}
+
+static void net_create_cb(struct hook *hook, int status)
+{
+	int ret;
+	pid_t pid;
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
+
+	if (status != 0) {
+		ULOGE("invoke_net_helper create returned %d", status);
+		instance_operation_failed(instance, -EBUSY);
+		instance_operation_done(instance);
+		instance_done(instance, -EBUSY);
+		return;
 	}
 
-	instance->state = INSTANCE_STARTED;
+	set_state(instance, INSTANCE_STARTED);
 	ptspair_cooked(&instance->ptspair, PTSPAIR_BAR);
 	pid = fork();
 	if (pid == -1) {
 		ret = -errno;
 		ULOGE("fork: %m");
-		return ret;
+		set_state(instance, INSTANCE_READY);
+		instance_operation_failed(instance, ret);
+		instance_operation_done(instance);
+		instance_done(instance, ret);
+		return;
 	}
 	if (pid == 0)
 		launch_instance(instance); /* in child */
 	/* in parent */
 	/* the pid must be set before being used, e.g. in invoke_net_helper() */
 	instance->pid = pid;
+	folder_entity_changed(&instance->entity);
 
 	/*
 	 * wait until the child as setup it's network container, so that we can
@@ -1149,24 +1412,61 @@ int instance_start(struct instance *instance)
 	ret = read_stolen_btusb_id(instance);
 	if (ret != 0)
 		ULOGE("read_stolen_btusb_id: %s", strerror(-ret));
-	ret = invoke_net_helper(instance, "assign");
-	if (ret != 0)
-		ULOGE("invoke_net_helper assign returned %d", ret);
+	ret = invoke_net_helper(instance, "assign", net_assign_cb);
+	if (ret < 0)
+		net_assign_cb(hook, ret);
+}
+
+/* the STARTED notification is sent when the start sequence is over */
+int instance_start(struct instance *instance, uint32_t seqnum,
+		uint32_t origin)
+{
+	int ret;
+
+	if (instance == NULL)
+		return -EINVAL;
+
+	if (instance->state != INSTANCE_READY ||
+			hook_is_running(&instance->hook)) {
+		ULOGW("wrong state %s for instance %s",
+				instance_state_to_str(instance->state),
+				instance_get_sha1(instance));
+		return -EBUSY;
+	}
+
 	/*
-	 * now the interface has been assigned to the child's name space, the
-	 * child can be unlocked and can now configure the interface to fit it's
-	 * needs
+	 * the veth pair must be re-created at each instance startup, because it
+	 * is automatically deleted at the namespace's destruction
 	 */
-	ret = ut_process_sync_parent_unlock(&instance->sync);
-	if (ret < 0)
-		ULOGE("ut_process_sync_parent_unlock: parent/child "
-				"synchronisation failed: %s", strerror(-ret));
+	instance->operation_seqnum = seqnum;
+	instance->operation_origin = origin;
+	ret = invoke_net_helper(instance, "create", net_create_cb);
+	if (ret < 0) {
+		ULOGE("invoke_net_helper create: %s", strerror(-ret));
+		instance->operation_seqnum = (uint32_t)-1;
+		instance->operation_origin = 0;
+		return -EBUSY;
+	}
+
+	return 0;
+}
 
+int instance_set_done_cb(struct instance *instance, instance_done_cb cb,
+		void *data)
+{
+	if (instance == NULL)
+		return -EINVAL;
+	if (cb != NULL && instance->done_cb != NULL)
+		return -EBUSY;
+
+	instance->done_cb = cb;
+	instance->done_data = data;
 
 	return 0;
 }
 
-int instance_kill(struct instance *instance, uint32_t killer_seqnum)
+int instance_kill(struct instance *instance, uint32_t killer_seqnum,
+		uint32_t killer_origin)
 {
 	int ret;
 
@@ -1176,8 +1476,13 @@ int instance_kill(struct instance *instance, uint32_t killer_seqnum)
 	if (instance->state != INSTANCE_STARTED)
 		return -ECHILD;
 
-	instance->state = INSTANCE_STOPPING;
+	/* the instance is still being started */
+	if (hook_is_running(&instance->hook))
+		return -EBUSY;
+
+	set_state(instance, INSTANCE_STOPPING);
 	instance->killer_seqnum = killer_seqnum;
+	instance->killer_origin = killer_origin;
 	ret = kill(instance->pid, SIGUSR1);
 	if (ret < 0) {
 		ret = -errno;
@@ -1187,12 +1492,50 @@ int instance_kill(struct instance *instance, uint32_t killer_seqnum)
 	return ret;
 }
 
-int instance_remount(struct instance *instance)
+static void remount_cb(struct hook *hook, int status)
+{
+	int ret;
+	struct instance *instance = ut_container_of(hook, typeof(*instance),
+			hook);
+
+	if (status != 0) {
+		ULOGE("invoke_mount_helper remount returned %d", status);
+		instance_operation_failed(instance, status);
+	} else {
+		ret = firmwared_notify(INSTANCE_SCOPE(instance,
+				instance->operation_origin),
+				FWD_ANSWER_REMOUNTED,
+				FWD_FORMAT(ANSWER_REMOUNTED),
+				instance->operation_seqnum);
+		if (ret < 0)
+			ULOGE("firmwared_notify : err=%d(%s)", ret,
+					strerror(-ret));
+	}
+
+	instance_operation_done(instance);
+}
+
+/* the REMOUNTED notification is sent when the mount hook is done */
+int instance_remount(struct instance *instance, uint32_t seqnum,
+		uint32_t origin)
 {
+	int ret;
+
 	if (instance == 0)
 		return -EINVAL;
 
-	return invoke_mount_helper(instance, "remount", false);
+	if (hook_is_running(&instance->hook))
+		return -EBUSY;
+
+	instance->operation_seqnum = seqnum;
+	instance->operation_origin = origin;
+	ret = invoke_mount_helper(instance, "remount", false, remount_cb);
+	if (ret < 0) {
+		instance->operation_seqnum = (uint32_t)-1;
+		instance->operation_origin = 0;
+	}
+
+	return ret;
 }
 
 const char *instance_get_sha1(struct instance *instance)
@@ -1225,9 +1568,8 @@ void instance_delete(struct instance **instance, bool only_unregister)
 		return;
 	i = *instance;
 
-	clean_instance(i, only_unregister);
+	destroy_instance(i, only_unregister);
 
-	free(i);
 	*instance = NULL;
 }
 
@@ -19,9 +19,30 @@ struct instance;
 int instances_init(void);
 struct instance *instance_from_entity(struct folder_entity *entity);
 struct folder_entity *instance_to_entity(struct instance *instance);
-int instance_start(struct instance *instance);
-int instance_kill(struct instance *instance, uint32_t killer_seqnum);
-int instance_remount(struct instance *instance);
+/*
+ * start and remount are asynchronous, their answer is notified, with seqnum,
+ * when they are over, origin is the id of the client which issued the command
+ */
+int instance_start(struct instance *instance, uint32_t seqnum,
+		uint32_t origin);
+/*
+ * status is 0 if the start or kill sequence succeeded, a negative errno-
+ * compatible value otherwise
+ */
+typedef void (*instance_done_cb)(struct instance *instance, int status,
+		void *data);
+/*
+ * registers a callback, called once, when the start or kill operation which has
+ * just been launched on the instance is over, or with -ECANCELED if the
+ * instance is destroyed before, returns -EBUSY if one is already registered, a
+ * NULL cb unregisters it
+ */
+int instance_set_done_cb(struct instance *instance, instance_done_cb cb,
+		void *data);
+int instance_kill(struct instance *instance, uint32_t killer_seqnum,
+		uint32_t killer_origin);
+int instance_remount(struct instance *instance, uint32_t seqnum,
+		uint32_t origin);
 const char *instance_get_sha1(struct instance *instance);
 const char *instance_get_name(const struct instance *instance);
 void instance_delete(struct instance **instance, bool only_unregister);
@@ -0,0 +1,344 @@
+/**
+ * @file group.c
+ * @brief lifecycle operations applied to a set of entities
+ *
+ * Starting and killing an instance are asynchronous, hooks run between their
+ * steps, hence a group launches the operation on up to
+ * FIRMWARED_GROUP_PARALLELISM instances, then launches the next one each time
+ * an instance is done, so that the whole group takes about the time of its
+ * slowest members. Drops are synchronous and are performed in a row.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#include <rs_dll.h>
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_group
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_group);
+
+#include <fwd.h>
+
+#include "firmwared.h"
+#include "config.h"
+#include "answer.h"
+#include "instances.h"
+#include "group.h"
+
+struct group;
+
+struct group_member {
+	char *sha1;
+	char *name;
+	/* the operation has been launched and isn't over */
+	bool running;
+	/* result of the operation, negative errno-compatible value or 0 */
+	int status;
+	struct group *group;
+};
+
+struct group {
+	struct rs_node node;
+	enum group_operation operation;
+	char *folder;
+	uint32_t seqnum;
+	uint32_t origin;
+	unsigned parallelism;
+	unsigned count;
+	struct group_member *members;
+	/* index of the next member to launch */
+	unsigned next;
+	unsigned running;
+	/* members whose operation is not over */
+	unsigned remaining;
+};
+
+static struct rs_dll groups;
+
+static const char * const operations[] = {
+		[GROUP_OPERATION_START] = "START",
+		[GROUP_OPERATION_KILL] = "KILL",
+		[GROUP_OPERATION_DROP] = "DROP",
+};
+
+static struct group *to_group(struct rs_node *node)
+{
+	return ut_container_of(node, struct group, node);
+}
+
+enum group_operation group_operation_from_str(const char *str)
+{
+	enum group_operation operation;
+
+	if (ut_string_is_invalid(str))
+		return GROUP_OPERATION_INVALID;
+
+	for (operation = GROUP_OPERATION_START;
+			operation < GROUP_OPERATION_INVALID; operation++)
+		if (strcasecmp(str, operations[operation]) == 0)
+			return operation;
+
+	return GROUP_OPERATION_INVALID;
+}
+
+const char *group_operation_to_str(enum group_operation operation)
+{
+	if (operation >= GROUP_OPERATION_INVALID)
+		return "(invalid)";
+
+	return operations[operation];
+}
+
+static void group_destroy(struct group **group)
+{
+	struct group *g = *group;
+	unsigned i;
+
+	if (g == NULL)
+		return;
+
+	for (i = 0; g->members != NULL && i < g->count; i++) {
+		ut_string_free(&g->members[i].sha1);
+		ut_string_free(&g->members[i].name);
+	}
+	free(g->members);
+	ut_string_free(&g->folder);
+	memset(g, 0, sizeof(*g));
+	free(g);
+	*group = NULL;
+}
+
+static void group_done(struct group *group)
+{
+	int ret;
+	unsigned i;
+	struct group_member *member;
+	struct answer answer;
+
+	rs_dll_remove(&groups, &group->node);
+
+	ret = answer_init(&answer, FWD_ANSWER_GROUP_DONE, group->seqnum);
+	if (ret < 0) {
+		ULOGE("answer_init: %s", strerror(-ret));
+		goto out;
+	}
+	answer_add_str(&answer, group->folder);
+	answer_add_str(&answer, group_operation_to_str(group->operation));
+	answer_add_u32(&answer, group->count);
+	for (i = 0; i < group->count; i++) {
+		member = group->members + i;
+		answer_add_str(&answer, member->sha1);
+		answer_add_str(&answer, member->name);
+		answer_add_i32(&answer, -member->status);
+	}
+	ret = answer_notify(&answer, &(struct notification_scope) {
+				.origin = group->origin,
+				.folder = group->folder,
+			});
+	if (ret < 0)
+		ULOGE("answer_notify: %s", strerror(-ret));
+out:
+	group_destroy(&group);
+}
+
+static void group_launch(struct group *group);
+
+static void member_done_cb(struct instance *instance, int status, void *data)
+{
+	struct group_member *member = data;
+	struct group *group = member->group;
+
+	if (status < 0)
+		ULOGW("%s of instance %s failed: %s",
+				group_operation_to_str(group->operation),
+				member->name, strerror(-status));
+	member->status = status;
+	member->running = false;
+	group->running--;
+	group->remaining--;
+
+	group_launch(group);
+}
+
+static int member_launch(struct group_member *member)
+{
+	int ret;
+	struct group *group = member->group;
+	struct folder_entity *entity;
+	struct instance *instance;
+
+	entity = folder_find_entity(INSTANCES_FOLDER_NAME, member->sha1);
+	if (entity == NULL)
+		return -errno;
+	instance = instance_from_entity(entity);
+
+	/*
+	 * the STARTED, DEAD or ERROR of each instance mustn't be taken as the
+	 * answer to the GROUP command, hence the invalid sequence number, an
+	 * instance can't be operated by two groups at once
+	 */
+	ret = instance_set_done_cb(instance, member_done_cb, member);
+	if (ret < 0)
+		return ret;
+	if (group->operation == GROUP_OPERATION_START)
+		ret = instance_start(instance, (uint32_t)-1, group->origin);
+	else
+		ret = instance_kill(instance, (uint32_t)-1, group->origin);
+	if (ret < 0) {
+		instance_set_done_cb(instance, NULL, NULL);
+		return ret;
+	}
+	member->running = true;
+
+	return 0;
+}
+
+static int member_drop(struct group_member *member)
+{
+	int ret;
+	struct group *group = member->group;
+	struct folder_entity *entity;
+
+	entity = folder_find_entity(group->folder, member->sha1);
+	if (entity == NULL)
+		return -errno;
+	ret = folder_drop(group->folder, entity);
+	if (ret < 0)
+		return ret;
+
+	/* coverity[bad_printf_format_string] */
+	return firmwared_notify(&(struct notification_scope) {
+				.origin = group->origin,
+				.folder = group->folder,
+				.entity = member->sha1,
+				.name = member->name,
+			}, FWD_ANSWER_DROPPED, FWD_FORMAT(ANSWER_DROPPED),
+			(uint32_t)-1, group->folder, member->sha1,
+			member->name);
+}
+
+/* the group is destroyed once all its members are done */
+static void group_launch(struct group *group)
+{
+	int ret;
+	struct group_member *member;
+
+	while (group->running < group->parallelism &&
+			group->next < group->count) {
+		member = group->members + group->next++;
+		if (group->operation == GROUP_OPERATION_DROP)
+			ret = member_drop(member);
+		else
+			ret = member_launch(member);
+		if (ret < 0 || group->operation == GROUP_OPERATION_DROP) {
+			if (ret < 0)
+				ULOGW("%s of %s failed: %s",
+						group_operation_to_str(
+							group->operation),
+						member->name, strerror(-ret));
+			member->status = ret;
+			group->remaining--;
+			continue;
+		}
+		group->running++;
+	}
+
+	if (group->remaining == 0)
+		group_done(group);
+}
+
+int group_run(enum group_operation operation, const char *folder,
+		const struct folder_entity_snapshot * const *entities,
+		unsigned count, uint32_t seqnum, uint32_t origin)
+{
+	int ret;
+	unsigned i;
+	struct group *group;
+	struct group_member *member;
+
+	if (operation >= GROUP_OPERATION_INVALID ||
+			ut_string_is_invalid(folder) ||
+			(entities == NULL && count != 0))
+		return -EINVAL;
+	if (operation != GROUP_OPERATION_DROP &&
+			strcmp(folder, INSTANCES_FOLDER_NAME) != 0)
+		return -ENOTSUP;
+
+	group = calloc(1, sizeof(*group));
+	if (group == NULL)
+		return -errno;
+	group->operation = operation;
+	group->seqnum = seqnum;
+	group->origin = origin;
+	group->parallelism = config_get_int(CONFIG_GROUP_PARALLELISM);
+	group->count = group->remaining = count;
+	group->folder = strdup(folder);
+	group->members = calloc(count + 1, sizeof(*group->members));
+	if (group->folder == NULL || group->members == NULL) {
+		ret = -errno;
+		goto err;
+	}
+	for (i = 0; i < count; i++) {
+		member = group->members + i;
+		member->group = group;
+		member->sha1 = strdup(entities[i]->sha1);
+		member->name = strdup(entities[i]->name);
+		if (member->sha1 == NULL || member->name == NULL) {
+			ret = -errno;
+			goto err;
+		}
+	}
+
+	ULOGI("%s of %u entities of folder %s", group_operation_to_str(operation),
+			count, folder);
+	rs_dll_enqueue(&groups, &group->node);
+	group_launch(group);
+
+	return 0;
+err:
+	group_destroy(&group);
+
+	return ret;
+}
+
+void groups_cleanup(void)
+{
+	struct rs_node *node;
+	struct group *group;
+	struct group_member *member;
+	struct folder_entity *entity;
+	unsigned i;
+
+	ULOGD("%s", __func__);
+
+	while ((node = rs_dll_pop(&groups)) != NULL) {
+		group = to_group(node);
+		/* the instances mustn't call back into a destroyed group */
+		for (i = 0; i < group->count; i++) {
+			member = group->members + i;
+			if (!member->running)
+				continue;
+			entity = folder_find_entity(INSTANCES_FOLDER_NAME,
+					member->sha1);
+			if (entity != NULL)
+				instance_set_done_cb(
+						instance_from_entity(entity),
+						NULL, NULL);
+		}
+		group_destroy(&group);
+	}
+}
+
+static __attribute__((constructor)) void group_init(void)
+{
+	rs_dll_init(&groups, NULL);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file group.h
+ * @brief lifecycle operations applied to a set of entities, the instances being
+ * started or killed concurrently, up to FIRMWARED_GROUP_PARALLELISM at a time
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef GROUP_H_
+#define GROUP_H_
+#include <stdint.h>
+
+#include "folders.h"
+
+enum group_operation {
+	GROUP_OPERATION_START,
+	GROUP_OPERATION_KILL,
+	GROUP_OPERATION_DROP,
+
+	GROUP_OPERATION_INVALID,
+};
+
+enum group_operation group_operation_from_str(const char *str);
+const char *group_operation_to_str(enum group_operation operation);
+/*
+ * applies the operation to the entities, a GROUP_DONE notification with the
+ * result of each of them is sent to the client origin once they are all done,
+ * START and KILL are only valid on the instances folder
+ */
+int group_run(enum group_operation operation, const char *folder,
+		const struct folder_entity_snapshot * const *entities,
+		unsigned count, uint32_t seqnum, uint32_t origin);
+/* drops the groups still running, without notifying their clients */
+void groups_cleanup(void);
+
+#endif /* GROUP_H_ */
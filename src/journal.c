@@ -0,0 +1,153 @@
+/**
+ * @file journal.c
+ * @brief bounded history of the changes of the folders' entities
+ *
+ * The entries are stored in a ring buffer of FIRMWARED_JOURNAL_SIZE entries,
+ * the entry of generation g lives at index g % size, so that any generation
+ * still in the journal is found without searching.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <sys/types.h>
+
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <time.h>
+
+#define ULOG_TAG firmwared_journal
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_journal);
+
+#include <ut_string.h>
+
+#include "config.h"
+#include "journal.h"
+
+#define JOURNAL_EPOCH_SIZE 0x20
+
+static struct {
+	struct journal_entry *entries;
+	unsigned size;
+	uint64_t generation;
+	/* oldest generation still available */
+	uint64_t first;
+	char epoch[JOURNAL_EPOCH_SIZE];
+} journal;
+
+static void entry_clean(struct journal_entry *entry)
+{
+	ut_string_free(&entry->folder);
+	ut_string_free(&entry->entity);
+	ut_string_free(&entry->name);
+	ut_string_free(&entry->property);
+	ut_string_free(&entry->value);
+	memset(entry, 0, sizeof(*entry));
+}
+
+int journal_init(void)
+{
+	struct timespec now;
+
+	ULOGD("%s", __func__);
+
+	memset(&journal, 0, sizeof(journal));
+	journal.size = config_get_int(CONFIG_JOURNAL_SIZE);
+	journal.entries = calloc(journal.size, sizeof(*journal.entries));
+	if (journal.entries == NULL)
+		return -errno;
+	journal.first = 1;
+	clock_gettime(CLOCK_REALTIME, &now);
+	snprintf(journal.epoch, JOURNAL_EPOCH_SIZE, "%lx.%x",
+			(unsigned long)now.tv_sec, (unsigned)getpid());
+
+	return 0;
+}
+
+void journal_record(enum journal_event event, const char *folder,
+		const char *entity, const char *name, const char *property,
+		const char *value)
+{
+	struct journal_entry *entry;
+
+	if (journal.entries == NULL)
+		return;
+
+	journal.generation++;
+	entry = journal.entries + journal.generation % journal.size;
+	entry_clean(entry);
+	if (journal.generation - journal.first >= journal.size)
+		journal.first = journal.generation - journal.size + 1;
+
+	entry->generation = journal.generation;
+	entry->event = event;
+	entry->folder = strdup(folder);
+	entry->entity = strdup(entity);
+	entry->name = strdup(name);
+	entry->property = strdup(property == NULL ? "" : property);
+	entry->value = strdup(value == NULL ? "" : value);
+	if (entry->folder == NULL || entry->entity == NULL ||
+			entry->name == NULL || entry->property == NULL ||
+			entry->value == NULL) {
+		ULOGE("change %"PRIu64" lost", journal.generation);
+		entry_clean(entry);
+		journal.first = journal.generation + 1;
+	}
+}
+
+uint64_t journal_get_generation(void)
+{
+	return journal.generation;
+}
+
+const char *journal_get_epoch(void)
+{
+	return journal.epoch;
+}
+
+const struct journal_entry *journal_next(uint64_t generation)
+{
+	if (generation >= journal.generation) {
+		errno = ENOENT;
+		return NULL;
+	}
+	if (generation + 1 < journal.first) {
+		errno = ERANGE;
+		return NULL;
+	}
+
+	return journal.entries + (generation + 1) % journal.size;
+}
+
+const char *journal_event_str(enum journal_event event)
+{
+	switch (event) {
+	case JOURNAL_EVENT_ADDED:
+		return "ADDED";
+	case JOURNAL_EVENT_CHANGED:
+		return "CHANGED";
+	case JOURNAL_EVENT_DROPPED:
+		return "DROPPED";
+	default:
+		return "UNKNOWN";
+	}
+}
+
+void journal_cleanup(void)
+{
+	unsigned i;
+
+	ULOGD("%s", __func__);
+
+	if (journal.entries == NULL)
+		return;
+	for (i = 0; i < journal.size; i++)
+		entry_clean(journal.entries + i);
+	free(journal.entries);
+	journal.entries = NULL;
+}
@@ -0,0 +1,52 @@
+/**
+ * @file journal.h
+ * @brief bounded history of the changes of the folders' entities, numbered by
+ * a generation counter, for the clients to resynchronize incrementally
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef JOURNAL_H_
+#define JOURNAL_H_
+#include <stdint.h>
+
+enum journal_event {
+	JOURNAL_EVENT_ADDED,
+	JOURNAL_EVENT_CHANGED,
+	JOURNAL_EVENT_DROPPED,
+};
+
+struct journal_entry {
+	uint64_t generation;
+	enum journal_event event;
+	char *folder;
+	char *entity;
+	char *name;
+	/* property and value are empty unless event is JOURNAL_EVENT_CHANGED */
+	char *property;
+	char *value;
+};
+
+int journal_init(void);
+/*
+ * increments the generation, the event is lost if it can't be stored, which
+ * forces the clients behind it to resynchronize
+ */
+void journal_record(enum journal_event event, const char *folder,
+		const char *entity, const char *name, const char *property,
+		const char *value);
+/* generation of the last event recorded, 0 if none */
+uint64_t journal_get_generation(void);
+/* changes each time firmwared is started, the generations restart from 0 */
+const char *journal_get_epoch(void);
+/*
+ * returns the entry following generation, NULL with errno set to ENOENT if
+ * generation is the last one, or to ERANGE if the entry isn't in the journal
+ * anymore
+ */
+const struct journal_entry *journal_next(uint64_t generation);
+const char *journal_event_str(enum journal_event event);
+void journal_cleanup(void);
+
+#endif /* JOURNAL_H_ */
@@ -10,11 +10,14 @@
 #include <ulog.h>
 ULOG_DECLARE_TAG(firmwared_log);
 
+#include "watchdog.h"
 #include "log.h"
 
 static void log_cb_implem(struct io_src_sep *sep, char *chunk, unsigned len,
 		int level)
 {
+	WATCHDOG_PROBE("hook output", NULL);
+
 	if (len == 0)
 		return;
 
@@ -34,6 +34,12 @@
 #include "firmwared.h"
 #include "commands.h"
 #include "config.h"
+#include "workers.h"
+#include "watchdog.h"
+#include "journal.h"
+#include "status.h"
+#include "templates.h"
+#include "group.h"
 
 #define ULOG_TAG firmwared_main
 #include <ulog.h>
@@ -60,11 +66,17 @@ static void usage(int status)
 
 static void clean_subsystems(void)
 {
+	/* no job must be running while the entities are destroyed */
+	workers_cleanup();
 	if (!config_get_bool(CONFIG_DISABLE_APPARMOR))
 		apparmor_cleanup();
+	groups_cleanup();
 	instances_cleanup();
 	firmwares_cleanup();
 	folders_cleanup();
+	templates_cleanup();
+	status_cleanup();
+	journal_cleanup();
 }
 
 static void initial_cleanup_mount_points(const char *entity_folder)
@@ -133,9 +145,35 @@ static int init_subsystems(void)
 {
 	int ret;
 
+	ret = watchdog_init();
+	if (ret < 0) {
+		ULOGE("watchdog_init: %s", strerror(-ret));
+		return ret;
+	}
+	ret = journal_init();
+	if (ret < 0) {
+		ULOGE("journal_init: %s", strerror(-ret));
+		return ret;
+	}
+	ret = status_init();
+	if (ret < 0) {
+		ULOGE("status_init: %s", strerror(-ret));
+		journal_cleanup();
+		return ret;
+	}
+	ret = workers_init();
+	if (ret < 0) {
+		ULOGE("workers_init: %s", strerror(-ret));
+		status_cleanup();
+		journal_cleanup();
+		return ret;
+	}
 	ret = folders_init();
 	if (ret < 0) {
 		ULOGE("folders_init: %s", strerror(-ret));
+		workers_cleanup();
+		status_cleanup();
+		journal_cleanup();
 		return ret;
 	}
 	ret = firmwares_init();
@@ -148,6 +186,11 @@ static int init_subsystems(void)
 		ULOGE("instances_init: %s", strerror(-ret));
 		goto err;
 	}
+	ret = templates_init();
+	if (ret < 0) {
+		ULOGE("templates_init: %s", strerror(-ret));
+		goto err;
+	}
 	if (!config_get_bool(CONFIG_DISABLE_APPARMOR)) {
 		ret = apparmor_init();
 		if (ret < 0) {
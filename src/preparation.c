@@ -6,17 +6,152 @@
  * @author nicolas.carrier@parrot.com
  * @copyright Copyright (C) 2015 Parrot S.A.
  */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <envz.h>
 #include <errno.h>
+#include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 
 #include <ut_string.h>
 
+#define ULOG_TAG firmwared_preparation
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_preparation);
+
+#include <fwd.h>
+
+#include "config.h"
+#include "clients.h"
+#include "utils.h"
+#include "templates.h"
 #include "preparation.h"
 
+#define OPTION_NAME_CHARS "abcdefghijklmnopqrstuvwxyz_"
+
+static const char * const options[] = {
+	"detached",
+	"priority",
+	"template",
+	NULL,
+};
+
+static const char * const priorities[PREPARATION_PRIORITY_NB] = {
+	[PREPARATION_PRIORITY_HIGH] = "high",
+	[PREPARATION_PRIORITY_NORMAL] = "normal",
+	[PREPARATION_PRIORITY_LOW] = "low",
+};
+
+static bool is_option(const char *word)
+{
+	size_t len = strspn(word, OPTION_NAME_CHARS);
+
+	return len != 0 && word[len] == '=';
+}
+
+static bool option_is_known(const char *name)
+{
+	const char * const *option;
+
+	for (option = options; *option != NULL; option++)
+		if (ut_string_match(name, *option))
+			return true;
+
+	return false;
+}
+
+/* moves the trailing options of the identification string to the envz */
+static int extract_options(struct preparation *preparation)
+{
+	char *word;
+	char *equal;
+	error_t err;
+
+	while ((word = strrchr(preparation->identification_string, ' '))
+			!= NULL) {
+		if (!is_option(word + 1))
+			break;
+		*word = '\0';
+		word++;
+		equal = strchr(word, '=');
+		*equal = '\0';
+		if (!option_is_known(word))
+			return -EINVAL;
+		err = envz_add(&preparation->options,
+				&preparation->options_len, word, equal + 1);
+		if (err != 0)
+			return -err;
+	}
+	/* only options were given */
+	if (ut_string_is_invalid(preparation->identification_string))
+		return -EINVAL;
+
+	return 0;
+}
+
+static int parse_priority(struct preparation *preparation)
+{
+	const char *priority;
+	enum preparation_priority p;
+
+	priority = preparation_get_option(preparation, "priority");
+	if (priority == NULL) {
+		preparation->priority = PREPARATION_PRIORITY_NORMAL;
+		return 0;
+	}
+
+	for (p = 0; p < PREPARATION_PRIORITY_NB; p++)
+		if (ut_string_match(priority, priorities[p])) {
+			preparation->priority = p;
+			return 0;
+		}
+
+	return -EINVAL;
+}
+
+static int parse_detached(struct preparation *preparation)
+{
+	const char *detached;
+
+	detached = preparation_get_option(preparation, "detached");
+	if (detached == NULL || ut_string_match(detached, "no")) {
+		preparation->detached = false;
+		return 0;
+	}
+	if (ut_string_match(detached, "yes")) {
+		preparation->detached = true;
+		return 0;
+	}
+
+	return -EINVAL;
+}
+
+/* fails early rather than after the whole preparation */
+static int check_template(struct preparation *preparation)
+{
+	const char *template;
+
+	template = preparation_get_option(preparation, "template");
+	if (template == NULL)
+		return 0;
+
+	if (!template_exists(preparation->folder, template)) {
+		ULOGE("no template %s for folder %s", template,
+				preparation->folder);
+		return -ENOENT;
+	}
+
+	return 0;
+}
+
 int preparation_init(struct preparation *preparation,
 		const char *identification_string, uint32_t seqnum,
-		preparation_completion_cb completion)
+		uint32_t origin, preparation_completion_cb completion)
 {
+	int ret;
+
 	if (preparation == NULL ||
 			ut_string_is_invalid(identification_string) ||
 			completion == NULL)
@@ -24,15 +159,288 @@ int preparation_init(struct preparation *preparation,
 
 	/* no memset, the preparation implementation has filled some fields */
 	preparation->seqnum = seqnum;
+	preparation->origin = origin;
 	preparation->completion = completion;
+	preparation->options = NULL;
+	preparation->options_len = 0;
+	preparation->attached = NULL;
+	preparation->nb_attached = 0;
 	preparation->identification_string = strdup(identification_string);
 	if (preparation->identification_string == NULL)
 		return -errno;
 	preparation->has_ended = false;
+	preparation->queue_position = 0;
+	preparation->notified_progress = -1;
+
+	ret = extract_options(preparation);
+	if (ret < 0)
+		goto err;
+	ret = parse_priority(preparation);
+	if (ret < 0)
+		goto err;
+	ret = parse_detached(preparation);
+	if (ret < 0)
+		goto err;
+	ret = check_template(preparation);
+	if (ret < 0)
+		goto err;
+
+	return 0;
+err:
+	preparation_clean(preparation);
+
+	return ret;
+}
+
+static bool progress_is_coalesced(struct preparation *preparation,
+		const char *progress)
+{
+	long percentage;
+	char *endptr;
+
+	errno = 0;
+	percentage = strtol(progress, &endptr, 10);
+	if (errno != 0 || *progress == '\0' || *endptr != '\0')
+		return false;
+
+	if (preparation->notified_progress >= 0 && percentage != 100 &&
+			percentage - preparation->notified_progress <
+			config_get_int(CONFIG_PROGRESS_STEP) &&
+			time_elapsed_ms(&preparation->notified_time) <
+			(uint64_t)config_get_int(CONFIG_PROGRESS_INTERVAL))
+		return true;
+
+	preparation->notified_progress = percentage;
+	clock_gettime(CLOCK_MONOTONIC, &preparation->notified_time);
+
+	return false;
+}
+
+int preparation_notify_progress(struct preparation *preparation,
+		const char *progress)
+{
+	if (preparation == NULL || progress == NULL)
+		return -EINVAL;
+
+	if (progress_is_coalesced(preparation, progress))
+		return 0;
+
+	return preparation_notify(preparation, PREPARATION_SCOPE(preparation),
+			FWD_ANSWER_PREPARE_PROGRESS,
+			FWD_FORMAT(ANSWER_PREPARE_PROGRESS),
+			preparation->seqnum, preparation->folder,
+			preparation->identification_string, progress);
+}
+
+static int notify_request(const struct notification_scope *scope,
+		uint32_t msgid, uint32_t seqnum, const char *fmt, va_list args)
+{
+	int ret;
+	struct pomp_msg *msg;
+	struct pomp_encoder *encoder;
+
+	msg = pomp_msg_new();
+	encoder = pomp_encoder_new();
+	if (msg == NULL || encoder == NULL) {
+		ret = -ENOMEM;
+		goto out;
+	}
+	ret = pomp_msg_init(msg, msgid);
+	if (ret < 0)
+		goto out;
+	ret = pomp_encoder_init(encoder, msg);
+	if (ret < 0)
+		goto out;
+	ret = pomp_encoder_write_u32(encoder, seqnum);
+	if (ret < 0)
+		goto out;
+	ret = pomp_encoder_writev(encoder, fmt, args);
+	if (ret < 0)
+		goto out;
+	ret = pomp_msg_finish(msg);
+	if (ret < 0)
+		goto out;
+
+	clients_notify(scope, msg);
+out:
+	if (encoder != NULL)
+		pomp_encoder_destroy(encoder);
+	if (msg != NULL)
+		pomp_msg_destroy(msg);
+
+	return ret;
+}
+
+int preparation_notify(struct preparation *preparation,
+		const struct notification_scope *scope, uint32_t msgid,
+		const char *fmt, ...)
+{
+	int ret;
+	unsigned i;
+	va_list args;
+	va_list copy;
+	uint32_t seqnum;
+	const char *arguments_fmt;
+	struct notification_scope request_scope;
+
+	if (preparation == NULL || scope == NULL ||
+			!ut_string_match_prefix(fmt, FWD_FORMAT_TYPE_U32))
+		return -EINVAL;
+	/* the seqnum is replaced by the one of each request */
+	arguments_fmt = fmt + strlen(FWD_FORMAT_TYPE_U32);
+
+	va_start(args, fmt);
+	seqnum = va_arg(args, uint32_t);
+	va_copy(copy, args);
+	ret = notify_request(scope, msgid, seqnum, arguments_fmt, copy);
+	va_end(copy);
+
+	request_scope = *scope;
+	request_scope.origin_only = true;
+	for (i = 0; i < preparation->nb_attached && ret >= 0; i++) {
+		request_scope.origin = preparation->attached[i].origin;
+		va_copy(copy, args);
+		ret = notify_request(&request_scope, msgid,
+				preparation->attached[i].seqnum,
+				arguments_fmt, copy);
+		va_end(copy);
+	}
+	va_end(args);
+
+	return ret;
+}
+
+bool preparation_options_match(const struct preparation *a,
+		const struct preparation *b)
+{
+	const char *template_a = preparation_get_option(a, "template");
+	const char *template_b = preparation_get_option(b, "template");
+
+	if (template_a == NULL || template_b == NULL)
+		return template_a == template_b;
+
+	return ut_string_match(template_a, template_b);
+}
+
+int preparation_attach(struct preparation *preparation,
+		struct preparation *request)
+{
+	struct preparation_request *attached;
+	unsigned count;
+
+	if (preparation == NULL || request == NULL)
+		return -EINVAL;
+
+	count = preparation->nb_attached + 1 + request->nb_attached;
+	attached = realloc(preparation->attached, count * sizeof(*attached));
+	if (attached == NULL)
+		return -errno;
+	preparation->attached = attached;
+
+	attached += preparation->nb_attached;
+	*attached = (struct preparation_request) {
+		.seqnum = request->seqnum,
+		.origin = request->origin,
+		.detached = request->detached,
+	};
+	if (request->nb_attached != 0)
+		memcpy(attached + 1, request->attached,
+				request->nb_attached * sizeof(*attached));
+	preparation->nb_attached = count;
+
+	free(request->attached);
+	request->attached = NULL;
+	request->nb_attached = 0;
 
 	return 0;
 }
 
+static bool request_is_released(const struct preparation_request *request,
+		uint32_t origin)
+{
+	return request->origin == origin && !request->detached;
+}
+
+/* the main request is replaced by the last attached one, which must exist */
+static void take_over(struct preparation *preparation)
+{
+	struct preparation_request *last;
+
+	last = preparation->attached + --preparation->nb_attached;
+	preparation->seqnum = last->seqnum;
+	preparation->origin = last->origin;
+	preparation->detached = last->detached;
+}
+
+bool preparation_release(struct preparation *preparation, uint32_t origin)
+{
+	unsigned i;
+	unsigned kept = 0;
+	struct preparation_request *attached;
+
+	attached = preparation->attached;
+	for (i = 0; i < preparation->nb_attached; i++)
+		if (!request_is_released(attached + i, origin))
+			attached[kept++] = attached[i];
+	preparation->nb_attached = kept;
+
+	if (preparation->origin != origin || preparation->detached)
+		return false;
+	if (preparation->nb_attached == 0)
+		return true;
+
+	/* an attached request takes over */
+	take_over(preparation);
+
+	return false;
+}
+
+int preparation_withdraw(struct preparation *preparation, uint32_t origin,
+		struct preparation_request **withdrawn)
+{
+	unsigned i;
+	unsigned kept = 0;
+	unsigned count = 0;
+	struct preparation_request *attached;
+	struct preparation_request *requests;
+
+	if (preparation == NULL || withdrawn == NULL)
+		return -EINVAL;
+
+	/* at most, all the attached requests and the main one */
+	requests = calloc(preparation->nb_attached + 1, sizeof(*requests));
+	if (requests == NULL)
+		return -errno;
+	attached = preparation->attached;
+	for (i = 0; i < preparation->nb_attached; i++)
+		if (attached[i].origin == origin)
+			requests[count++] = attached[i];
+		else
+			attached[kept++] = attached[i];
+	preparation->nb_attached = kept;
+
+	if (preparation->origin == origin && preparation->nb_attached != 0) {
+		requests[count++] = (struct preparation_request) {
+			.seqnum = preparation->seqnum,
+			.origin = preparation->origin,
+			.detached = preparation->detached,
+		};
+		take_over(preparation);
+	}
+	*withdrawn = requests;
+
+	return count;
+}
+
+const char *preparation_get_option(const struct preparation *preparation,
+		const char *name)
+{
+	if (preparation == NULL || ut_string_is_invalid(name))
+		return NULL;
+
+	return envz_get(preparation->options, preparation->options_len, name);
+}
+
 /* preparation_match_str_identification_string */
 RS_NODE_MATCH_STR_MEMBER(preparation, identification_string, node)
 
@@ -41,4 +449,10 @@ void preparation_clean(struct preparation *preparation)
 	if (preparation == NULL)
 		return;
 	ut_string_free(&preparation->identification_string);
+	free(preparation->attached);
+	preparation->attached = NULL;
+	preparation->nb_attached = 0;
+	free(preparation->options);
+	preparation->options = NULL;
+	preparation->options_len = 0;
 }
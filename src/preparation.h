@@ -9,6 +9,8 @@
 #ifndef PREPARATION_H_
 #define PREPARATION_H_
 #include <stdint.h>
+#include <stddef.h>
+#include <time.h>
 
 #include <rs_node.h>
 
@@ -17,6 +19,22 @@
 
 struct preparation;
 
+/* order of the classes in which the queued preparations are started */
+enum preparation_priority {
+	PREPARATION_PRIORITY_HIGH,
+	PREPARATION_PRIORITY_NORMAL,
+	PREPARATION_PRIORITY_LOW,
+
+	PREPARATION_PRIORITY_NB,
+};
+
+/* PREPARE command sharing the outcome of an identical preparation */
+struct preparation_request {
+	uint32_t seqnum;
+	uint32_t origin;
+	bool detached;
+};
+
 typedef int (*preparation_completion_cb)(struct preparation *preparation,
 			struct folder_entity *entity);
 
@@ -27,26 +45,97 @@ struct preparation {
 	int (*start)(struct preparation *preparation);
 	void (*abort)(struct preparation *preparation);
 	const char *folder;
+	/*
+	 * true if two preparations with the same identification string produce
+	 * the same entity, the second one is then attached to the first one
+	 */
+	bool shareable;
 
 	/* fields initialized by the folder_prepare function */
+	/* stripped of the trailing key=value options */
 	char *identification_string;
+	/* envz of the options */
+	char *options;
+	size_t options_len;
+	enum preparation_priority priority;
 	uint32_t seqnum;
+	/* id of the client which issued the PREPARE command */
+	uint32_t origin;
+	/* if false, the preparation is aborted when its client disconnects */
+	bool detached;
+	/* identical PREPARE commands received while it was in progress */
+	struct preparation_request *attached;
+	unsigned nb_attached;
 	/* functions the preparation will call */
 	/* error when entity is NULL with errno set */
 	preparation_completion_cb completion;
 
 	bool has_ended;
+	/* position in the queue last notified to the client, 0 if running */
+	unsigned queue_position;
+	/* last percentage notified and when, -1 if none yet */
+	long notified_progress;
+	struct timespec notified_time;
 };
 
 #define to_preparation(p) ut_container_of(p, struct preparation, node)
 
+/* scope of the notifications concerning a preparation, before it's completion */
+#define PREPARATION_SCOPE(p) (&(struct notification_scope) { \
+	.origin = (p)->origin, \
+	.folder = (p)->folder, \
+	.key = (p)->identification_string, \
+})
+
+/*
+ * the identification string can be followed by space-separated key=value
+ * options, e.g. "firmware.ext2 priority=high", unknown options are rejected
+ */
 int preparation_init(struct preparation *preparation,
 		const char *identification_string, uint32_t seqnum,
-		preparation_completion_cb completion);
+		uint32_t origin, preparation_completion_cb completion);
+/*
+ * notifies a PREPARE_PROGRESS, unless the progress is a percentage which
+ * neither advanced by FIRMWARED_PROGRESS_STEP nor has been notified for
+ * FIRMWARED_PROGRESS_INTERVAL ms, to limit the rate of the notifications
+ */
+int preparation_notify_progress(struct preparation *preparation,
+		const char *progress);
+/*
+ * sends a notification concerning the preparation, as firmwared_notify() does,
+ * then a copy of it to the client of each of the attached requests, with the
+ * request's seqnum, fmt must start with the seqnum of the preparation
+ */
+__attribute__ ((format (printf, 4, 5)))
+int preparation_notify(struct preparation *preparation,
+		const struct notification_scope *scope, uint32_t msgid,
+		const char *fmt, ...);
+/* true if both would produce the same entity, given the same one to prepare */
+bool preparation_options_match(const struct preparation *a,
+		const struct preparation *b);
+/* the requests attached to preparation are moved too */
+int preparation_attach(struct preparation *preparation,
+		struct preparation *request);
+/*
+ * forgets the requests of the client origin, except the detached ones, returns
+ * true if none remains, in which case the main request is kept
+ */
+bool preparation_release(struct preparation *preparation, uint32_t origin);
+/*
+ * removes the requests of the client origin, detached or not, except the main
+ * one if no other client's request remains, in which case it's up to the
+ * caller to abort the preparation, the removed requests are stored in
+ * withdrawn, to free, returns their number or a negative errno value
+ */
+int preparation_withdraw(struct preparation *preparation, uint32_t origin,
+		struct preparation_request **withdrawn);
+/* returns NULL if the option wasn't passed */
+const char *preparation_get_option(const struct preparation *preparation,
+		const char *name);
 
 int preparation_match_str_identification_string(struct rs_node *node,
 		const void *identification_string);
 
 void preparation_clean(struct preparation *preparation);
 
-#endif /* FOLDERS_H_ */
+#endif /* PREPARATION_H_ */
@@ -6,9 +6,24 @@
  * @author ncarrier
  * @copyright Copyright (C) 2015 Parrot S.A.
  */
+#include <sys/wait.h>
+
 #include <signal.h>
+#include <inttypes.h>
+#include <errno.h>
+#include <string.h>
+
+#define ULOG_TAG firmwared_process
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_process);
+
+#include <io_mon.h>
+
+#include <ut_utils.h>
 
 #include "log.h"
+#include "firmwared.h"
+#include "watchdog.h"
 #include "process.h"
 
 struct io_process_parameters process_default_parameters = {
@@ -21,3 +36,60 @@ struct io_process_parameters process_default_parameters = {
 	.timeout = 1000,
 	.signum = SIGKILL,
 };
+
+void hook_termination(struct io_process *process, pid_t pid, int status)
+{
+	struct hook *hook = ut_container_of(process, struct hook, process);
+	WATCHDOG_PROBE(hook->name, hook->owner);
+
+	io_mon_remove_source(firmwared_get_mon(),
+			io_process_get_src(&hook->process));
+	hook->running = false;
+	if (status != 0)
+		ULOGW("hook %s (pid %jd) exited with status %d", hook->name,
+				(intmax_t)pid, status);
+	else
+		ULOGD("hook %s (pid %jd) done", hook->name, (intmax_t)pid);
+
+	/* the callback can free the hook, it mustn't be accessed after */
+	hook->cb(hook, status == 0 ? 0 : -ECANCELED);
+}
+
+int hook_wait(const char *name, struct io_process *process, int ret)
+{
+	if (ret < 0) {
+		ULOGE("hook %s: %s", name, strerror(-ret));
+		return ret;
+	}
+
+	return process->status == 0 ? 0 : -ECANCELED;
+}
+
+int hook_watch(struct hook *hook, const char *name, hook_cb cb, int ret)
+{
+	hook->name = name;
+	if (ret < 0) {
+		ULOGE("hook %s: %s", name, strerror(-ret));
+		return ret;
+	}
+	hook->cb = cb;
+	ret = io_mon_add_source(firmwared_get_mon(),
+			io_process_get_src(&hook->process));
+	if (ret < 0) {
+		ULOGE("io_mon_add_source: %s", strerror(-ret));
+		/* not monitored, hook_termination() won't be called */
+		io_process_signal(&hook->process, SIGKILL);
+		if (waitpid(hook->process.pid, NULL, 0) == -1)
+			ULOGE("waitpid: %m");
+		io_process_clean(&hook->process);
+		return ret;
+	}
+	hook->running = true;
+
+	return 0;
+}
+
+bool hook_is_running(const struct hook *hook)
+{
+	return hook->running;
+}
@@ -9,9 +9,62 @@
 
 #ifndef SRC_PROCESS_H_
 #define SRC_PROCESS_H_
+#include <stdbool.h>
 
 #include <io_process.h>
 
 extern struct io_process_parameters process_default_parameters;
 
+struct hook;
+
+/* status is 0 if the hook exited successfully, a negative errno otherwise */
+typedef void (*hook_cb)(struct hook *hook, int status);
+
+/*
+ * hooks are the external helpers (mount, net, apparmor_parser...) firmwared
+ * launches to perform privileged operations on the entities. When a
+ * completion callback is given, they are executed without blocking the main
+ * loop, otherwise, they are waited for.
+ */
+struct hook {
+	struct io_process process;
+	const char *name;
+	/* sha1 of the entity the hook is run for, for diagnostic purpose */
+	const char *owner;
+	hook_cb cb;
+	bool running;
+};
+
+/* don't use directly, use hook_launch() */
+void hook_termination(struct io_process *process, pid_t pid, int status);
+int hook_wait(const char *name, struct io_process *process, int ret);
+int hook_watch(struct hook *hook, const char *name, hook_cb cb, int ret);
+
+/*
+ * launches the hook with the given, NULL-terminated, arguments. If cb is NULL,
+ * the hook is waited for and it's status is returned, hook isn't used in this
+ * case and can even be already running. Otherwise, 0 is returned if the hook
+ * has been launched and cb will be called from the main loop, when it
+ * terminates
+ */
+#define hook_launch(hook, name, parameters, cb, ...) \
+	((cb) == NULL ? \
+		({ \
+			struct io_process _process; \
+			hook_wait((name), &_process, \
+				io_process_init_prepare_launch_and_wait( \
+						&_process, \
+						(parameters), \
+						NULL, \
+						__VA_ARGS__)); \
+		}) : \
+		hook_watch((hook), (name), (cb), \
+				io_process_init_prepare_and_launch( \
+						&(hook)->process, \
+						(parameters), \
+						hook_termination, \
+						__VA_ARGS__)))
+
+bool hook_is_running(const struct hook *hook);
+
 #endif /* SRC_PROCESS_H_ */
@@ -0,0 +1,228 @@
+/**
+ * @file status.c
+ * @brief status table of the entities, published in shared memory
+ *
+ * The table has FIRMWARED_STATUS_SLOTS slots, an entity keeps its slot from
+ * its storage to its drop. Firmwared is the only writer, the slots are looked
+ * up by scanning the table, which is small.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <sys/mman.h>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#define ULOG_TAG firmwared_status
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_status);
+
+#include <ut_string.h>
+
+#include <fwd_status.h>
+
+#include "config.h"
+#include "status.h"
+
+static struct {
+	struct fwd_status_header *header;
+	struct fwd_status_slot *slots;
+	size_t size;
+	char *path;
+} status;
+
+static void copy_field(char *dest, size_t size, const char *src)
+{
+	snprintf(dest, size, "%s", src == NULL ? "" : src);
+}
+
+static void fill_entry(struct fwd_status_entry *entry, const char *folder,
+		const struct folder_entity_snapshot *es)
+{
+	const char *pid;
+	const char *id;
+
+	memset(entry, 0, sizeof(*entry));
+	copy_field(entry->folder, sizeof(entry->folder), folder);
+	copy_field(entry->name, sizeof(entry->name), es->name);
+	copy_field(entry->sha1, sizeof(entry->sha1), es->sha1);
+	copy_field(entry->state, sizeof(entry->state),
+			folder_entity_snapshot_get_property(es, "state"));
+	copy_field(entry->firmware, sizeof(entry->firmware),
+			folder_entity_snapshot_get_property(es,
+					"firmware_path"));
+	pid = folder_entity_snapshot_get_property(es, "pid");
+	if (pid != NULL)
+		entry->pid = strtol(pid, NULL, 10);
+	/* only the instances have an id, which gives their address */
+	id = folder_entity_snapshot_get_property(es, "id");
+	if (id != NULL) {
+		entry->id = strtoul(id, NULL, 10);
+		snprintf(entry->ip, sizeof(entry->ip), "%s%s.1",
+				config_get(CONFIG_NET_FIRST_TWO_BYTES), id);
+	}
+}
+
+static struct fwd_status_slot *find_slot(const char *folder, const char *sha1)
+{
+	uint32_t i;
+	struct fwd_status_slot *slot;
+
+	for (i = 0; i < status.header->nb_slots; i++) {
+		slot = status.slots + i;
+		if (slot->used && ut_string_match(slot->entry.sha1, sha1) &&
+				ut_string_match(slot->entry.folder, folder))
+			return slot;
+	}
+
+	return NULL;
+}
+
+static struct fwd_status_slot *find_free_slot(void)
+{
+	uint32_t i;
+
+	for (i = 0; i < status.header->nb_slots; i++)
+		if (!status.slots[i].used)
+			return status.slots + i;
+
+	return NULL;
+}
+
+/* entry is NULL to free the slot */
+static void write_slot(struct fwd_status_slot *slot,
+		const struct fwd_status_entry *entry)
+{
+	uint32_t sequence = slot->sequence;
+
+	/* odd, the readers retry until the write is over */
+	__atomic_store_n(&slot->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	if (entry == NULL) {
+		__atomic_store_n(&slot->used, 0, __ATOMIC_RELAXED);
+		memset(&slot->entry, 0, sizeof(slot->entry));
+	} else {
+		__atomic_store_n(&slot->used, 1, __ATOMIC_RELAXED);
+		memcpy(&slot->entry, entry, sizeof(slot->entry));
+	}
+	__atomic_store_n(&slot->sequence, sequence + 2, __ATOMIC_RELEASE);
+	__atomic_add_fetch(&status.header->generation, 1, __ATOMIC_RELEASE);
+}
+
+int status_init(void)
+{
+	int ret;
+	int fd;
+	const char *path = config_get(CONFIG_STATUS_PATH);
+	uint32_t nb_slots = config_get_int(CONFIG_STATUS_SLOTS);
+
+	ULOGD("%s", __func__);
+
+	memset(&status, 0, sizeof(status));
+	if (ut_string_is_invalid(path))
+		return 0;
+
+	status.path = strdup(path);
+	if (status.path == NULL)
+		return -errno;
+	/*
+	 * a new file is created, so that the readers of the previous one don't
+	 * see it being truncated
+	 */
+	unlink(path);
+	fd = open(path, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC, 0644);
+	if (fd == -1) {
+		ret = -errno;
+		ULOGE("open(%s): %m", path);
+		goto err;
+	}
+	status.size = sizeof(*status.header) + nb_slots * sizeof(*status.slots);
+	ret = ftruncate(fd, status.size);
+	if (ret == -1) {
+		ret = -errno;
+		ULOGE("ftruncate: %m");
+		close(fd);
+		goto err;
+	}
+	status.header = mmap(NULL, status.size, PROT_READ | PROT_WRITE,
+			MAP_SHARED, fd, 0);
+	close(fd);
+	if (status.header == MAP_FAILED) {
+		ret = -errno;
+		status.header = NULL;
+		ULOGE("mmap: %s", strerror(-ret));
+		goto err;
+	}
+	status.slots = (struct fwd_status_slot *)(status.header + 1);
+	status.header->version = FWD_STATUS_VERSION;
+	status.header->slot_size = sizeof(*status.slots);
+	status.header->nb_slots = nb_slots;
+	status.header->pid = getpid();
+	/* the table is valid once the rest of the header is written */
+	__atomic_store_n(&status.header->magic, FWD_STATUS_MAGIC,
+			__ATOMIC_RELEASE);
+
+	return 0;
+err:
+	status_cleanup();
+
+	return ret;
+}
+
+void status_update(const char *folder,
+		const struct folder_entity_snapshot *es)
+{
+	struct fwd_status_slot *slot;
+	struct fwd_status_entry entry;
+
+	if (status.header == NULL)
+		return;
+
+	fill_entry(&entry, folder, es);
+	slot = find_slot(folder, es->sha1);
+	if (slot == NULL) {
+		slot = find_free_slot();
+		if (slot == NULL) {
+			ULOGW("status table full, %s not published", es->sha1);
+			return;
+		}
+	} else if (memcmp(&slot->entry, &entry, sizeof(entry)) == 0) {
+		/* the change concerns a property which isn't published */
+		return;
+	}
+
+	write_slot(slot, &entry);
+}
+
+void status_remove(const char *folder, const char *sha1)
+{
+	struct fwd_status_slot *slot;
+
+	if (status.header == NULL)
+		return;
+
+	slot = find_slot(folder, sha1);
+	if (slot != NULL)
+		write_slot(slot, NULL);
+}
+
+void status_cleanup(void)
+{
+	ULOGD("%s", __func__);
+
+	if (status.header != NULL) {
+		__atomic_store_n(&status.header->magic, 0, __ATOMIC_RELEASE);
+		munmap(status.header, status.size);
+	}
+	if (status.path != NULL)
+		unlink(status.path);
+	ut_string_free(&status.path);
+	memset(&status, 0, sizeof(status));
+}
@@ -0,0 +1,27 @@
+/**
+ * @file status.h
+ * @brief status table of the entities, published in shared memory for the
+ * monitoring agents, see fwd_status.h for its layout
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef STATUS_H_
+#define STATUS_H_
+
+#include "folders.h"
+
+/* does nothing if FIRMWARED_STATUS_PATH is empty */
+int status_init(void);
+/*
+ * publishes the new version of an entity, stored or modified, it isn't
+ * published if all the slots are used
+ */
+void status_update(const char *folder,
+		const struct folder_entity_snapshot *es);
+void status_remove(const char *folder, const char *sha1);
+/* the readers still mapping the table see it as stale */
+void status_cleanup(void);
+
+#endif /* STATUS_H_ */
@@ -0,0 +1,247 @@
+/**
+ * @file templates.c
+ * @brief named sets of property values, applied at preparation time
+ *
+ * FIRMWARED_TEMPLATES contains one "FOLDER TEMPLATE PROPERTY VALUE" line per
+ * property, VALUE being the rest of the line, the templates can then be
+ * modified with the DEFINE_TEMPLATE command.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <argz.h>
+#include <envz.h>
+
+#include <rs_dll.h>
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#define ULOG_TAG firmwared_templates
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_templates);
+
+#include "config.h"
+#include "templates.h"
+
+struct template {
+	struct rs_node node;
+	char *folder;
+	char *name;
+	/* envz of the property values, in their definition order */
+	char *properties;
+	size_t properties_len;
+};
+
+static struct rs_dll templates;
+
+static struct template *to_template(struct rs_node *node)
+{
+	return ut_container_of(node, struct template, node);
+}
+
+static void template_destroy(struct template **template)
+{
+	struct template *t = *template;
+
+	if (t == NULL)
+		return;
+
+	ut_string_free(&t->folder);
+	ut_string_free(&t->name);
+	free(t->properties);
+	memset(t, 0, sizeof(*t));
+	free(t);
+	*template = NULL;
+}
+
+static int template_remove(struct rs_node *node)
+{
+	struct template *template = to_template(node);
+
+	template_destroy(&template);
+
+	return 0;
+}
+
+static const struct rs_dll_vtable templates_vtable = {
+	.remove = template_remove,
+};
+
+static struct template *template_find(const char *folder, const char *name)
+{
+	struct rs_node *node = NULL;
+	struct template *template;
+
+	while ((node = rs_dll_next_from(&templates, node)) != NULL) {
+		template = to_template(node);
+		if (ut_string_match(template->folder, folder) &&
+				ut_string_match(template->name, name))
+			return template;
+	}
+
+	return NULL;
+}
+
+static struct template *template_new(const char *folder, const char *name)
+{
+	struct template *template;
+
+	template = calloc(1, sizeof(*template));
+	if (template == NULL)
+		return NULL;
+	template->folder = strdup(folder);
+	template->name = strdup(name);
+	if (template->folder == NULL || template->name == NULL) {
+		template_destroy(&template);
+		errno = ENOMEM;
+		return NULL;
+	}
+	rs_dll_enqueue(&templates, &template->node);
+
+	return template;
+}
+
+/* parses a "FOLDER TEMPLATE PROPERTY VALUE" line of FIRMWARED_TEMPLATES */
+static int add_line(char *line)
+{
+	char *folder;
+	char *name;
+	char *property;
+	char *value;
+	char *saveptr = NULL;
+	struct template *template;
+
+	folder = strtok_r(line, " \t", &saveptr);
+	if (folder == NULL)
+		return 0; /* blank line */
+	name = strtok_r(NULL, " \t", &saveptr);
+	property = strtok_r(NULL, " \t", &saveptr);
+	value = strtok_r(NULL, "", &saveptr);
+	if (name == NULL || property == NULL)
+		return -EINVAL;
+	if (value == NULL)
+		value = "";
+
+	template = template_find(folder, name);
+	if (template == NULL)
+		template = template_new(folder, name);
+	if (template == NULL)
+		return -errno;
+
+	return -envz_add(&template->properties, &template->properties_len,
+			property, value);
+}
+
+int templates_init(void)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *config = NULL;
+	char *line;
+	char *saveptr = NULL;
+
+	ULOGD("%s", __func__);
+
+	rs_dll_init(&templates, &templates_vtable);
+
+	config = strdup(config_get(CONFIG_TEMPLATES));
+	if (config == NULL)
+		return -errno;
+	for (line = strtok_r(config, "\n", &saveptr); line != NULL;
+			line = strtok_r(NULL, "\n", &saveptr)) {
+		ret = add_line(line);
+		if (ret < 0) {
+			ULOGE("invalid template definition \"%s\": %s", line,
+					strerror(-ret));
+			templates_cleanup();
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+int template_define(const char *folder, const char *name,
+		const char *properties, size_t properties_len)
+{
+	struct template *template;
+
+	if (ut_string_is_invalid(folder) || ut_string_is_invalid(name))
+		return -EINVAL;
+
+	template = template_find(folder, name);
+	if (template != NULL) {
+		rs_dll_remove(&templates, &template->node);
+		template_destroy(&template);
+	}
+	if (properties_len == 0)
+		return 0;
+
+	template = template_new(folder, name);
+	if (template == NULL)
+		return -errno;
+	template->properties = malloc(properties_len);
+	if (template->properties == NULL) {
+		rs_dll_remove(&templates, &template->node);
+		template_destroy(&template);
+		return -ENOMEM;
+	}
+	memcpy(template->properties, properties, properties_len);
+	template->properties_len = properties_len;
+
+	return 0;
+}
+
+bool template_exists(const char *folder, const char *name)
+{
+	return template_find(folder, name) != NULL;
+}
+
+int template_apply(const char *name, struct folder_entity *entity)
+{
+	int ret;
+	char *entry = NULL;
+	char *value;
+	char __attribute__((cleanup(ut_string_free))) *property = NULL;
+	struct template *template;
+
+	if (entity == NULL)
+		return -EINVAL;
+
+	template = template_find(entity->folder->name, name);
+	if (template == NULL)
+		return -ENOENT;
+
+	while ((entry = argz_next(template->properties,
+			template->properties_len, entry)) != NULL) {
+		value = strchr(entry, '=');
+		if (value == NULL)
+			continue;
+		ut_string_free(&property);
+		property = strndup(entry, value - entry);
+		if (property == NULL)
+			return -errno;
+		ret = folder_entity_set_property(entity, property, value + 1);
+		if (ret < 0) {
+			ULOGE("template %s: setting %s failed: %s", name,
+					property, strerror(-ret));
+			return ret;
+		}
+	}
+
+	return 0;
+}
+
+void templates_cleanup(void)
+{
+	ULOGD("%s", __func__);
+
+	rs_dll_remove_all(&templates);
+}
@@ -0,0 +1,37 @@
+/**
+ * @file templates.h
+ * @brief named sets of property values, applied to the entities prepared with
+ * the template=NAME option, before their PREPARED notification is sent
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef TEMPLATES_H_
+#define TEMPLATES_H_
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "folders.h"
+
+/* maximum number of properties a template can set */
+#define TEMPLATES_MAX_PROPERTIES 256
+
+/* loads the templates defined in FIRMWARED_TEMPLATES */
+int templates_init(void);
+/*
+ * properties is an envz of the property values, applied in order, an empty one
+ * removes the template, defining an existing template replaces it
+ */
+int template_define(const char *folder, const char *name,
+		const char *properties, size_t properties_len);
+bool template_exists(const char *folder, const char *name);
+/*
+ * sets the template's properties on the entity, which must be stored in its
+ * folder, stops at the first failure, returns -ENOENT if the template doesn't
+ * exist
+ */
+int template_apply(const char *name, struct folder_entity *entity);
+void templates_cleanup(void);
+
+#endif /* TEMPLATES_H_ */
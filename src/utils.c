@@ -6,8 +6,15 @@
  * @author nicolas.carrier@parrot.com
  * @copyright Copyright (C) 2015 Parrot S.A.
  */
+#ifndef _XOPEN_SOURCE
+#define _XOPEN_SOURCE 500
+#endif /* _XOPEN_SOURCE */
 #include <sys/stat.h>
 
+#include <ftw.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
 #include <string.h>
 #include <argz.h>
 
@@ -108,3 +115,73 @@ int argz_property_seti(char **argz, size_t *argz_len, unsigned index,
 
 	return -argz_insert(argz, argz_len, before, value);
 }
+
+static int remove_entry(const char *path, const struct stat *sb, int type,
+		struct FTW *ftwbuf)
+{
+	int ret;
+
+	ret = remove(path);
+	if (ret < 0)
+		ULOGW("remove(%s): %m", path);
+
+	/* try to remove as much as possible */
+	return 0;
+}
+
+/*
+ * equivalent of rm -rf which doesn't cross the mount points, nor follow the
+ * symbolic links, so that mount points left mounted don't get emptied
+ */
+int remove_tree(const char *path)
+{
+	int ret;
+
+	ret = nftw(path, remove_entry, 20, FTW_DEPTH | FTW_MOUNT | FTW_PHYS);
+	if (ret < 0) {
+		ret = -errno;
+		if (ret == -ENOENT)
+			return 0;
+		ULOGE("nftw(%s): %m", path);
+		return ret;
+	}
+
+	return 0;
+}
+
+/* equivalent of mkdir -p */
+int mkdir_tree(const char *path, mode_t mode)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *tmp = NULL;
+	char *p;
+
+	tmp = strdup(path);
+	if (tmp == NULL)
+		return -errno;
+
+	for (p = tmp + 1; *p != '\0'; p++) {
+		if (*p != '/')
+			continue;
+		*p = '\0';
+		ret = mkdir(tmp, mode);
+		if (ret < 0 && errno != EEXIST)
+			return -errno;
+		*p = '/';
+	}
+	ret = mkdir(tmp, mode);
+	if (ret < 0 && errno != EEXIST)
+		return -errno;
+
+	return 0;
+}
+
+uint64_t time_elapsed_ms(const struct timespec *since)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+
+	return (now.tv_sec - since->tv_sec) * 1000ull +
+			(now.tv_nsec - since->tv_nsec) / 1000000ll;
+}
@@ -8,8 +8,12 @@
  */
 #ifndef UTILS_H_
 #define UTILS_H_
+#include <sys/types.h>
+
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
 
 char *buffer_to_string(const unsigned char *src, size_t len, char *dst);
 char *get_argz_i(const char *argz, size_t argz_len, int i);
@@ -17,5 +21,10 @@ int argz_property_geti(const char *argz, size_t argz_len, unsigned index,
 		char **value);
 int argz_property_seti(char **argz, size_t *argz_len, unsigned index,
 		const char *value);
+/* both are blocking and are meant to be called from a worker */
+int remove_tree(const char *path);
+int mkdir_tree(const char *path, mode_t mode);
+/* milliseconds elapsed since a date obtained with CLOCK_MONOTONIC */
+uint64_t time_elapsed_ms(const struct timespec *since);
 
 #endif /* UTILS_H_ */
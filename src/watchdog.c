@@ -0,0 +1,157 @@
+/**
+ * @file watchdog.c
+ * @brief measures the time spent in the main loop's callbacks
+ *
+ * The probes can be nested, e.g. a hook termination callback launching another
+ * hook, only the outermost ones are accounted for in the loop lag, which is the
+ * time the loop couldn't process any event during one iteration, that is, the
+ * maximum time an event could have waited for being processed.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#define ULOG_TAG firmwared_watchdog
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_watchdog);
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#include "config.h"
+#include "utils.h"
+#include "watchdog.h"
+
+/*
+ * bucket 0 counts the iterations with a lag under 1ms, bucket i, those with a
+ * lag in [2^(i-1), 2^i[ ms and the last one, all those above
+ */
+#define WATCHDOG_BUCKETS 14
+
+struct watchdog {
+	uint64_t threshold;
+	unsigned depth;
+	/* time spent in the outermost callbacks during the current iteration */
+	uint64_t iteration_lag;
+	uint64_t iterations;
+	uint64_t slow_callbacks;
+	uint64_t max_lag;
+	uint64_t histogram[WATCHDOG_BUCKETS];
+};
+
+static struct watchdog watchdog;
+
+static unsigned lag_to_bucket(uint64_t lag)
+{
+	unsigned bucket = 0;
+
+	while (lag != 0 && bucket < WATCHDOG_BUCKETS - 1) {
+		lag >>= 1;
+		bucket++;
+	}
+
+	return bucket;
+}
+
+int watchdog_init(void)
+{
+	ULOGD("%s", __func__);
+
+	memset(&watchdog, 0, sizeof(watchdog));
+	watchdog.threshold = config_get_int(CONFIG_LAG_THRESHOLD);
+
+	return 0;
+}
+
+struct watchdog_probe watchdog_probe_start(const char *name,
+		const char *entity)
+{
+	struct watchdog_probe probe = {.name = name};
+
+	/* copied because the callback can free it */
+	if (entity != NULL)
+		snprintf(probe.entity, WATCHDOG_ENTITY_MAX, "%s", entity);
+	watchdog.depth++;
+	clock_gettime(CLOCK_MONOTONIC, &probe.start);
+
+	return probe;
+}
+
+void watchdog_probe_end(struct watchdog_probe *probe)
+{
+	uint64_t duration;
+
+	duration = time_elapsed_ms(&probe->start);
+	watchdog.depth--;
+	if (watchdog.depth == 0)
+		watchdog.iteration_lag += duration;
+
+	/* threshold is 0 until watchdog_init() is called */
+	if (watchdog.threshold == 0 || duration < watchdog.threshold)
+		return;
+
+	watchdog.slow_callbacks++;
+	if (probe->entity[0] != '\0')
+		ULOGW("%s for %s blocked the loop for %"PRIu64"ms", probe->name,
+				probe->entity, duration);
+	else
+		ULOGW("%s blocked the loop for %"PRIu64"ms", probe->name,
+				duration);
+}
+
+void watchdog_loop_iteration_end(void)
+{
+	uint64_t lag = watchdog.iteration_lag;
+
+	watchdog.iterations++;
+	watchdog.histogram[lag_to_bucket(lag)]++;
+	if (lag > watchdog.max_lag)
+		watchdog.max_lag = lag;
+	watchdog.iteration_lag = 0;
+}
+
+char *watchdog_get_stats(void)
+{
+	int ret;
+	unsigned i;
+	char *stats = NULL;
+
+	ret = asprintf(&stats, "loop_iterations: %"PRIu64"\n"
+			"slow_callbacks: %"PRIu64"\n"
+			"lag_threshold_ms: %"PRIu64"\n"
+			"max_lag_ms: %"PRIu64"\n",
+			watchdog.iterations, watchdog.slow_callbacks,
+			watchdog.threshold, watchdog.max_lag);
+	if (ret < 0) {
+		errno = ENOMEM;
+		return NULL;
+	}
+	for (i = 0; i < WATCHDOG_BUCKETS; i++) {
+		if (i == 0)
+			ret = ut_string_append(&stats, "lag_ms[0]: %"PRIu64"\n",
+					watchdog.histogram[i]);
+		else if (i == WATCHDOG_BUCKETS - 1)
+			ret = ut_string_append(&stats, "lag_ms[%u+]: %"PRIu64
+					"\n", 1u << (i - 1),
+					watchdog.histogram[i]);
+		else
+			ret = ut_string_append(&stats, "lag_ms[%u-%u]: %"PRIu64
+					"\n", 1u << (i - 1), (1u << i) - 1,
+					watchdog.histogram[i]);
+		if (ret < 0) {
+			ut_string_free(&stats);
+			errno = -ret;
+			return NULL;
+		}
+	}
+
+	return stats;
+}
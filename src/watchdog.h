@@ -0,0 +1,44 @@
+/**
+ * @file watchdog.h
+ * @brief measures the time spent in the main loop's callbacks, to detect and
+ * explain its stalls
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef WATCHDOG_H_
+#define WATCHDOG_H_
+#include <time.h>
+
+#define WATCHDOG_ENTITY_MAX 0x80
+
+struct watchdog_probe {
+	struct timespec start;
+	/* command or hook name, must be a string with static storage */
+	const char *name;
+	/* sha1 of the entity concerned, or any information identifying it */
+	char entity[WATCHDOG_ENTITY_MAX];
+};
+
+int watchdog_init(void);
+struct watchdog_probe watchdog_probe_start(const char *name,
+		const char *entity);
+/* logs the callback if it took more than the configured threshold */
+void watchdog_probe_end(struct watchdog_probe *probe);
+/*
+ * declares a probe ended automatically at the end of the enclosing scope, for
+ * use at the beginning of the main loop's callbacks, entity can be NULL
+ */
+#define WATCHDOG_PROBE(name, entity) \
+	struct watchdog_probe __attribute__((cleanup(watchdog_probe_end))) \
+			_watchdog_probe = watchdog_probe_start((name), (entity))
+/*
+ * to be called at the end of each loop iteration, accounts the time spent in
+ * the callbacks during the iteration in the loop lag histogram
+ */
+void watchdog_loop_iteration_end(void);
+/* returns a text report of the histogram, to be freed after usage */
+char *watchdog_get_stats(void);
+
+#endif /* WATCHDOG_H_ */
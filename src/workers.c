@@ -0,0 +1,202 @@
+/**
+ * @file workers.c
+ * @brief pool of threads running the jobs which would block the main loop for
+ * too long, e.g. hashing a firmware or removing a directory tree
+ *
+ * The jobs are run by the threads in their submission order, once done, they
+ * are queued and the main loop is woken up through an eventfd, their done
+ * callback is then called from the main loop, so that the folders are only
+ * ever modified by the main thread.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#include <pthread.h>
+
+#include <stdlib.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+
+#define ULOG_TAG firmwared_workers
+#include <ulog.h>
+ULOG_DECLARE_TAG(firmwared_workers);
+
+#include <rs_dll.h>
+
+#include <io_mon.h>
+#include <io_src_evt.h>
+
+#include <ut_utils.h>
+
+#include "firmwared.h"
+#include "config.h"
+#include "watchdog.h"
+#include "workers.h"
+
+#define to_job(p) ut_container_of(p, struct worker_job, node)
+
+struct workers {
+	pthread_t *threads;
+	int nb_threads;
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+	/* both lists are protected by mutex */
+	struct rs_dll pending;
+	struct rs_dll done;
+	struct io_src_evt evt;
+	bool stop;
+};
+
+static struct workers workers = {
+	.mutex = PTHREAD_MUTEX_INITIALIZER,
+	.cond = PTHREAD_COND_INITIALIZER,
+};
+
+static void *worker_routine(void *arg)
+{
+	int ret;
+	struct rs_node *node;
+	struct worker_job *job;
+
+	pthread_mutex_lock(&workers.mutex);
+	while (true) {
+		while (!workers.stop && rs_dll_get_count(&workers.pending) == 0)
+			pthread_cond_wait(&workers.cond, &workers.mutex);
+		if (workers.stop)
+			break;
+		node = rs_dll_pop(&workers.pending);
+		pthread_mutex_unlock(&workers.mutex);
+
+		job = to_job(node);
+		job->status = job->work(job);
+
+		pthread_mutex_lock(&workers.mutex);
+		rs_dll_enqueue(&workers.done, &job->node);
+		ret = io_src_evt_notify(&workers.evt, 1);
+		if (ret < 0)
+			ULOGE("io_src_evt_notify: %s", strerror(-ret));
+	}
+	pthread_mutex_unlock(&workers.mutex);
+
+	return NULL;
+}
+
+static void workers_evt_cb(struct io_src_evt *evt, uint64_t value)
+{
+	struct rs_node *node;
+	struct worker_job *job;
+	WATCHDOG_PROBE("workers completion", NULL);
+
+	do {
+		pthread_mutex_lock(&workers.mutex);
+		node = rs_dll_pop(&workers.done);
+		pthread_mutex_unlock(&workers.mutex);
+		if (node == NULL)
+			break;
+
+		/* the done callback is allowed to free the job */
+		job = to_job(node);
+		job->done(job, job->status);
+	} while (true);
+}
+
+static void stop_threads(void)
+{
+	int i;
+
+	pthread_mutex_lock(&workers.mutex);
+	workers.stop = true;
+	pthread_cond_broadcast(&workers.cond);
+	pthread_mutex_unlock(&workers.mutex);
+
+	for (i = 0; i < workers.nb_threads; i++)
+		pthread_join(workers.threads[i], NULL);
+	workers.nb_threads = 0;
+}
+
+int workers_init(void)
+{
+	int ret;
+	int i;
+	int nb_threads;
+
+	ULOGD("%s", __func__);
+
+	rs_dll_init(&workers.pending, NULL);
+	rs_dll_init(&workers.done, NULL);
+	workers.stop = false;
+	ret = io_src_evt_init(&workers.evt, workers_evt_cb, false, 0);
+	if (ret < 0) {
+		ULOGE("io_src_evt_init: %s", strerror(-ret));
+		return ret;
+	}
+	ret = io_mon_add_source(firmwared_get_mon(),
+			io_src_evt_get_source(&workers.evt));
+	if (ret < 0) {
+		ULOGE("io_mon_add_source: %s", strerror(-ret));
+		goto err;
+	}
+
+	nb_threads = config_get_int(CONFIG_WORKERS);
+	workers.threads = calloc(nb_threads, sizeof(*workers.threads));
+	if (workers.threads == NULL) {
+		ret = -errno;
+		ULOGE("calloc: %m");
+		goto err;
+	}
+	for (i = 0; i < nb_threads; i++) {
+		ret = -pthread_create(workers.threads + i, NULL,
+				worker_routine, NULL);
+		if (ret < 0) {
+			ULOGE("pthread_create: %s", strerror(-ret));
+			goto err;
+		}
+		workers.nb_threads++;
+	}
+
+	return 0;
+err:
+	workers_cleanup();
+
+	return ret;
+}
+
+int workers_submit(struct worker_job *job, worker_job_work_cb work,
+		worker_job_done_cb done)
+{
+	if (job == NULL || work == NULL || done == NULL)
+		return -EINVAL;
+	if (workers.nb_threads == 0)
+		return -ENOSYS;
+
+	job->work = work;
+	job->done = done;
+	job->status = 0;
+
+	pthread_mutex_lock(&workers.mutex);
+	rs_dll_enqueue(&workers.pending, &job->node);
+	pthread_cond_signal(&workers.cond);
+	pthread_mutex_unlock(&workers.mutex);
+
+	return 0;
+}
+
+/*
+ * the jobs not run yet are forgotten, the ones running are waited for, but their
+ * done callback won't be called
+ */
+void workers_cleanup(void)
+{
+	ULOGD("%s", __func__);
+
+	stop_threads();
+	free(workers.threads);
+	workers.threads = NULL;
+	io_mon_remove_source(firmwared_get_mon(),
+			io_src_evt_get_source(&workers.evt));
+	io_src_evt_clean(&workers.evt);
+	rs_dll_init(&workers.pending, NULL);
+	rs_dll_init(&workers.done, NULL);
+}
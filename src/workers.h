@@ -0,0 +1,34 @@
+/**
+ * @file workers.h
+ * @brief pool of threads running the jobs which would block the main loop for
+ * too long, e.g. hashing a firmware or removing a directory tree
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef WORKERS_H_
+#define WORKERS_H_
+#include <rs_node.h>
+
+struct worker_job;
+
+/* called in a worker thread, mustn't touch the folders */
+typedef int (*worker_job_work_cb)(struct worker_job *job);
+/* called in the main loop with the value returned by work */
+typedef void (*worker_job_done_cb)(struct worker_job *job, int status);
+
+struct worker_job {
+	struct rs_node node;
+	worker_job_work_cb work;
+	worker_job_done_cb done;
+	int status;
+};
+
+int workers_init(void);
+/* the job must stay valid until it's done callback has been called */
+int workers_submit(struct worker_job *job, worker_job_work_cb work,
+		worker_job_done_cb done);
+void workers_cleanup(void);
+
+#endif /* WORKERS_H_ */
@@ -0,0 +1,53 @@
+#!/bin/bash
+
+# checks aborting a preparation which doesn't exist fails, then prepares a
+# firmware with the detached option and check the preparation isn't aborted
+# when fdc disconnects
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+firmware=
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+answer=$(fdc abort firmwares ${PWD}/example_firmware.ext2 || true)
+pattern='.*firmwared error: No such file or directory.*'
+[[ ${answer} =~ ${pattern} ]]
+
+answer=$(fdc prepare firmwares ${PWD}/example_firmware.ext2 detached=maybe \
+		|| true)
+pattern='.*firmwared error: Invalid argument.*'
+[[ ${answer} =~ ${pattern} ]]
+
+# fdc is killed before the preparation can complete
+timeout -s KILL 0.1 fdc prepare firmwares ${PWD}/example_firmware.ext2 \
+		detached=yes || true
+for i in $(seq 50); do
+	firmware=$(fdc list firmwares)
+	firmware=${firmware%[*}
+	if [ -n "${firmware}" ]; then
+		break
+	fi
+	sleep .1
+done
+[ -n "${firmware}" ]
@@ -0,0 +1,44 @@
+#!/bin/bash
+
+# prepares a firmware and check it's addition is reported by the changes_since
+# command, then that an unknown epoch requires a resynchronization
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm -f example_firmware.ext2
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+read epoch generation resync < <(fdc changes_since)
+[ "${resync}" = "1" ]
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%%[*}
+sha1=$(fdc get_property firmwares ${firmware} sha1)
+
+fdc changes_since ${epoch} ${generation} | grep -q \
+		"^[0-9]* ADDED firmwares ${sha1} ${firmware}$"
+
+read new_epoch generation resync < <(fdc changes_since unknown ${generation})
+[ "${new_epoch}" = "${epoch}" ]
+[ "${resync}" = "1" ]
@@ -10,5 +10,5 @@ fi
 set -eu
 
 answer="$(echo $(printf "%s\n" $(fdc commands) | sort))"
-expected="ADD_PROPERTY COMMANDS CONFIG_KEYS DROP FOLDERS GET_CONFIG GET_PROPERTY HELP KILL LIST PING PREPARE PROPERTIES QUIT REMOUNT RESTART SET_PROPERTY SHOW START VERSION"
+expected="ABORT ADD_PROPERTY CHANGES_SINCE COMMANDS CONFIG_KEYS DEFINE_TEMPLATE DROP FOLDERS GET_CONFIG GET_PROPERTIES GET_PROPERTY GROUP HELP KILL LIST LIST_PAGE PING PREPARE PROPERTIES QUERY QUIT REMOUNT RESTART SET_DEADLINE SET_PROPERTIES SET_PROPERTY SHOW SHOW_PROPERTIES START STATS SUBSCRIBE UNWATCH VERSION WATCH"
 test "${answer}" = "${expected}"
@@ -10,5 +10,5 @@ fi
 set -eu
 
 answer=$(fdc config_keys)
-expected="apparmor_profile container_interface curl_hook disable_apparmor dump_profile host_interface_prefix mount_hook mount_path net_first_two_bytes net_hook post_prepare_instance_hook prevent_removal resources_dir repository_path socket_path x11_path nvidia_path verbose_hook_scripts"
+expected="ack_policy apparmor_profile container_interface curl_hook disable_apparmor dump_profile group_parallelism host_interface_prefix indexed_properties journal_size lag_threshold listen max_firmware_preparations max_instance_preparations max_output_bytes max_output_messages max_preparations mount_hook mount_path net_first_two_bytes net_hook notification_policy post_prepare_instance_hook prevent_removal progress_interval progress_policy progress_step resources_dir repository_path socket_path status_path status_slots templates workers x11_path nvidia_path verbose_hook_scripts"
 [ "${answer}" = "${expected}" ]
\ No newline at end of file
@@ -0,0 +1,60 @@
+#!/bin/bash
+
+# prepares two instances, then starts, kills and drops them with group commands
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+instances=""
+firmware=""
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm -f example_firmware.ext2
+	for instance in ${instances}; do
+		fdc kill ${instance}
+		fdc drop instances ${instance}
+	done
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%%[*}
+
+fdc prepare instances ${firmware}
+fdc prepare instances ${firmware}
+
+instances=$(fdc query instances "*" name | tail -n +2 | sort)
+first=$(echo ${instances} | cut -d ' ' -f 1)
+second=$(echo ${instances} | cut -d ' ' -f 2)
+
+answer=$(fdc group start instances "state=READY" | cut -d ' ' -f 1,3 | sort)
+expected="${first} ok
+${second} ok"
+[ "${answer}" = "${expected}" ]
+
+sleep .5 # TODO bug, killing an instance too fast can block it in stopping stace
+answer=$(fdc group kill instances "${first},${second}" | cut -d ' ' -f 1,3 |
+		sort)
+[ "${answer}" = "${expected}" ]
+
+answer=$(fdc group drop instances "*" | cut -d ' ' -f 1,3 | sort)
+[ "${answer}" = "${expected}" ]
+instances=""
@@ -0,0 +1,47 @@
+#!/bin/bash
+
+# registers a firmware, list the firmwares folder page by page and check it
+# contains it
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+on_exit() {
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%%[*}
+
+answer=$(fdc list_page firmwares "" 0)
+[[ ${answer} =~ ${firmware}\[[a-f0-9]+\] ]]
+
+# one item per page, the last page has no next cursor
+cursor=""
+count=0
+while true; do
+	answer=$(fdc list_page firmwares "${cursor}" 1)
+	cursor=${answer##* }
+	count=$((count + 1))
+	if [[ ${cursor} =~ \] ]]; then
+		break
+	fi
+	[ ${count} -lt 1000 ]
+done
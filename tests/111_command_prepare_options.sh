@@ -0,0 +1,39 @@
+#!/bin/bash
+
+# prepares a firmware with a priority option and check if it succeeds, then
+# check an unknown option is rejected
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+answer=$(fdc prepare firmwares ${PWD}/example_firmware.ext2 priority=high)
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%[*}
+pattern='.*new entity in firmwares folder created.*'
+[[ ${answer} =~ ${pattern} ]]
+
+answer=$(fdc prepare instances ${firmware} unknown=option || true)
+pattern='.*firmwared error: Invalid argument.*'
+[[ ${answer} =~ ${pattern} ]]
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# defines a template, prepares an instance with it and check the template's
+# properties are set, then check an undefined template is rejected
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+instance=""
+firmware=""
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	fdc define_template instances test_template
+	if [ -n "${instance}" ]; then
+		fdc drop instances ${instance}
+	fi
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%%[*}
+
+answer=$(fdc define_template instances test_template interface eth9 \
+		cmdline[1] ro.test=1)
+[ "${answer}" = "template test_template of instances defined with 2 properties" ]
+
+fdc prepare instances ${firmware} template=test_template
+
+instance=$(fdc list instances)
+instance=${instance%%[*}
+[ "$(fdc get_property instances ${instance} interface)" = "eth9" ]
+[ "$(fdc get_property instances ${instance} cmdline[1])" = "ro.test=1" ]
+
+answer=$(fdc prepare instances ${firmware} template=undefined || true)
+pattern='.*firmwared error: No such file or directory.*'
+[[ ${answer} =~ ${pattern} ]]
@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# prepares the same firmware twice at the same time and check both requests
+# succeed with the same firmware, which is registered only once
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+firmware=
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm -f example_firmware.ext2 first_answer second_answer
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2 > first_answer &
+first=$!
+fdc prepare firmwares ${PWD}/example_firmware.ext2 > second_answer
+wait ${first}
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%[*}
+[ $(echo "${firmware}" | wc -w) -eq 1 ]
+pattern=".*sha1: ${firmware}.*"
+[[ $(cat first_answer) =~ ${pattern} ]]
+[[ $(cat second_answer) =~ ${pattern} ]]
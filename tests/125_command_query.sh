@@ -0,0 +1,42 @@
+#!/bin/bash
+
+# prepares a firmware and check the query command retrieves it, and only it,
+# with the columns requested
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm -f example_firmware.ext2
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%%[*}
+sha1=$(fdc get_property firmwares ${firmware} sha1)
+
+answer=$(fdc query firmwares "name=${firmware} AND sha1~${sha1:0:8}*" name,sha1)
+expected="name sha1
+${firmware} ${sha1}"
+[ "${answer}" = "${expected}" ]
+
+answer=$(fdc query firmwares "name!=${firmware} AND sha1=${sha1}")
+[ "${answer}" = "sha1 name" ]
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+# sets a deadline, expects it to be acknowledged
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+answer=$(fdc set_deadline 100)
+expected="deadline set to 100ms"
+[ "${answer}" = "${expected}" ]
@@ -0,0 +1,54 @@
+#!/bin/bash
+
+# prepares an instance, sets several properties at once and check it worked
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	if [ -n "${instance}" ]; then
+		fdc drop instances ${instance}
+	fi
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%[*}
+
+fdc prepare instances ${firmware}
+echo ${firmware}
+instance=$(fdc list instances)
+instance=${instance%[*}
+echo ${instance}
+fdc set_properties instances 0 ${instance} interface plop \
+	${instance} stolen_interface plip
+answer=$(fdc get_property instances ${instance} interface)
+[ "${answer}" = "plop" ]
+answer=$(fdc get_property instances ${instance} stolen_interface)
+[ "${answer}" = "plip" ]
+
+# an atomic update is rolled back when one of the properties can't be set
+answer=$(fdc set_properties instances 1 ${instance} interface plup \
+	${instance} plop plap)
+[[ ${answer} =~ .*"interface error "[0-9]+.* ]]
+answer=$(fdc get_property instances ${instance} interface)
+[ "${answer}" = "plop" ]
@@ -0,0 +1,16 @@
+#!/bin/bash
+
+# asks for the statistics, expects the loop lag histogram and the output queues
+# counters to be reported
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+answer=$(fdc stats)
+echo "${answer}" | grep -q "^loop_iterations: [0-9]*$"
+echo "${answer}" | grep -q "^lag_ms\[0\]: [0-9]*$"
+echo "${answer}" | grep -q "^output_dropped: [0-9]*$"
@@ -0,0 +1,19 @@
+#!/bin/bash
+
+# subscribes to some notifications and checks the subscription is acknowledged,
+# then checks an unknown notification type is rejected
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+answer=$(fdc subscribe instances,firmwares some_entity DEAD,STARTED)
+expected="subscribed to instances,firmwares some_entity DEAD,STARTED"
+[ "${answer}" = "${expected}" ]
+
+answer=$(fdc subscribe instances some_entity NOT_A_NOTIFICATION || true)
+pattern='.*firmwared error: Invalid argument.*'
+[[ ${answer} =~ ${pattern} ]]
@@ -0,0 +1,52 @@
+#!/bin/bash
+
+# prepares an instance, watches one of its properties and check the change is
+# notified when the property is set
+
+if [ -n "${VV+x}" ]
+then
+	set -x
+fi
+
+set -eu
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm -f example_firmware.ext2 watch.out
+	if [ -n "${instance}" ]; then
+		fdc drop instances ${instance}
+	fi
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%[*}
+
+fdc prepare instances ${firmware}
+
+instance=$(fdc list instances)
+instance=${instance%[*}
+
+FDC_TIMEOUT=5 fdc watch instances ${instance} interface > watch.out &
+watcher=$!
+# leaves time for the watch to be registered
+sleep .5
+fdc set_property instances ${instance} interface plop
+wait ${watcher}
+
+answer=$(cat watch.out)
+expected="${instance} interface plop"
+[ "${answer}" = "${expected}" ]
@@ -0,0 +1,61 @@
+#!/bin/bash
+
+# prepares an instance, checks it's published in the status table with its
+# firmware, then that it disappears from it when dropped
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+on_exit() {
+	status=$?
+	# we don't want to fail here, to guarantee the cleanup
+	set +e
+	rm example_firmware.ext2
+	if [ -n "${instance}" ]; then
+		fdc drop instances ${instance}
+	fi
+	if [ -n "${firmware}" ]; then
+		fdc drop firmwares ${firmware}
+	fi
+	exit ${status}
+}
+
+TESTS_DIR="$( cd "$( dirname "${BASH_SOURCE[0]}" )" && pwd )"
+
+tar xf ${TESTS_DIR}/../examples/example_firmware.tar.bz2
+
+trap on_exit EXIT
+
+fdc prepare firmwares ${PWD}/example_firmware.ext2
+
+firmware=$(fdc list firmwares)
+firmware=${firmware%[*}
+
+fdc prepare instances ${firmware}
+
+instance=$(fdc list instances)
+instance=${instance%[*}
+
+tab=$'\t'
+status_path=$(fdc get_config status_path)
+net_first_two_bytes=$(fdc get_config net_first_two_bytes)
+id=$(fdc get_property instances ${instance} id)
+pid=$(fdc get_property instances ${instance} pid)
+firmware_path=$(fdc get_property instances ${instance} firmware_path)
+
+answer=$(fdc --status ${status_path} | grep "^firmwares${tab}")
+[[ "${answer}" =~ ^firmwares${tab}${firmware}${tab}[a-f0-9]{40}${tab} ]]
+
+answer=$(fdc --status ${status_path} | grep "^instances${tab}")
+answer=$(echo "${answer}" | cut -f 2,4-)
+expected="${instance}${tab}ready${tab}${pid}${tab}${id}${tab}\
+${net_first_two_bytes}${id}.1${tab}${firmware_path}"
+[ "${answer}" = "${expected}" ]
+
+fdc drop instances ${instance}
+instance=
+[ -z "$(fdc --status ${status_path} | grep "^instances${tab}")" ]
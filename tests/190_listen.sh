@@ -0,0 +1,46 @@
+#!/bin/bash
+
+# connects through the read-only listener configured with FIRMWARED_LISTEN and
+# checks the commands modifying something are denied on it, but not on the main
+# socket
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+tab=$'\t'
+
+ro=
+listen=$(fdc get_config listen)
+for spec in ${listen//,/ }; do
+	case ${spec} in
+	*:rw)
+		;;
+	*)
+		ro=${spec%:ro}
+		;;
+	esac
+done
+if [ -z "${ro}" ]; then
+	echo "no read-only listener configured, nothing to test"
+	exit 0
+fi
+
+[ "$(FIRMWARED_SOCKET_PATH=${ro} fdc ping)" = "PONG" ]
+
+# denied before being executed on the read-only listener
+status=0
+answer=$(echo "drop firmwares not_a_firmware" | \
+	FIRMWARED_SOCKET_PATH=${ro} fdc --batch) || status=$?
+[ ${status} -eq 1 ]
+[[ "${answer}" =~ ^1${tab}ERROR${tab}1${tab} ]]
+
+# executed, then failing, on the main socket
+status=0
+answer=$(echo "drop firmwares not_a_firmware" | fdc --batch) || status=$?
+[ ${status} -eq 1 ]
+[[ "${answer}" =~ ^1${tab}ERROR${tab}[0-9]+${tab} ]]
+! [[ "${answer}" =~ ^1${tab}ERROR${tab}1${tab} ]]
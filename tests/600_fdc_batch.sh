@@ -0,0 +1,29 @@
+#!/bin/bash
+
+# sends several commands over one connection with fdc --batch and checks one
+# tab-separated line is output per command
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+tab=$'\t'
+
+answer=$(printf "ping\n\n# comment\nget_config 'net_first_two_bytes'\n" | \
+	fdc --batch)
+net_first_two_bytes=$(fdc get_config net_first_two_bytes)
+expected="1${tab}PONG
+4${tab}GET_CONFIG${tab}net_first_two_bytes${tab}${net_first_two_bytes}"
+[ "${answer}" = "${expected}" ]
+
+# the failures don't stop the batch, the exit status is the last failure's
+status=0
+answer=$(printf "not_a_command\nshow instances not_an_instance\nping\n" | \
+	fdc --batch) || status=$?
+[ ${status} -eq 1 ]
+echo "${answer}" | head -n 1 | egrep "^1${tab}INVALID${tab}"
+echo "${answer}" | sed -n 2p | egrep "^2${tab}ERROR${tab}[0-9]+${tab}"
+[ "$(echo "${answer}" | sed -n 3p)" = "3${tab}PONG" ]
@@ -0,0 +1,23 @@
+#!/bin/bash
+
+# checks the installed mapping file matches the messages known by libfwd
+
+if [ -n "${VV+x}" ]
+then
+	set -xu
+fi
+
+set -e
+
+prefix=$(dirname $(which fdc))/..
+answer=$(LIBFWD_GET_MESSAGES= ${prefix}/lib/libfwd.so)
+expected=$(cat ${prefix}/share/firmwared/fwd_messages)
+[ "${answer}" = "${expected}" ]
+
+# the name lookup gives the command when an answer has the same name
+for name in PING HELP LIST_PAGE; do
+	answer=$(LIBFWD_MESSAGE=${name} ${prefix}/lib/libfwd.so)
+	expected=$(awk -v name=${name} '$3 == name { print $1; exit }' \
+			${prefix}/share/firmwared/fwd_messages)
+	[ "${answer}" = "${expected}" ]
+done
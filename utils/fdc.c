@@ -0,0 +1,1138 @@
+/**
+ * @file fdc.c
+ * @brief command-line client for firmwared
+ *
+ * Sends one command to firmwared and outputs its answer in a script-friendly
+ * way, or, with --batch, reads commands from the standard input, one per line,
+ * sends them in a row over the same connection and outputs each answer on one
+ * tab-separated line, or, with --status, prints the status table published by
+ * firmwared, without connecting to it.
+ *
+ * @date Oct 18, 2026
+ * @author agent@local
+ * @copyright Copyright (C) 2026 Parrot S.A.
+ */
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+#include <unistd.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <inttypes.h>
+#include <string.h>
+#include <strings.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+#include <argz.h>
+
+#include <libpomp.h>
+
+#include <ut_utils.h>
+#include <ut_string.h>
+
+#include <fwd.h>
+#include <fwd_client.h>
+#include <fwd_status.h>
+
+#define FDC_DEFAULT_TIMEOUT 2
+#define FDC_INFINITE_TIMEOUT -1
+#define FDC_MAX_DEFAULTS 3
+#define FDC_VARIADIC UINT_MAX
+
+/* the exit statuses are those of the former shell implementation */
+enum fdc_status {
+	FDC_SUCCESS = 0,
+	FDC_ERROR_OTHER = 1,
+	FDC_ERROR_INVALID_COMMAND = 2,
+	FDC_ERROR_TIMEOUT = 3,
+};
+
+/* arguments expected by a command, not counting the sequence number */
+struct fdc_syntax {
+	unsigned min;
+	unsigned max;
+	/* values of the optional arguments, indexed by their position */
+	const char *defaults[FDC_MAX_DEFAULTS];
+	/*
+	 * the leading arguments are followed by COUNT tuples of this size,
+	 * COUNT being deduced from the number of arguments
+	 */
+	unsigned leading;
+	unsigned tuple;
+	/* the arguments following the first one are joined with spaces */
+	bool join;
+	/* doesn't time out unless FDC_TIMEOUT is set */
+	bool long_running;
+};
+
+/* order shall match enum fwd_message */
+static const struct fdc_syntax syntaxes[] = {
+		[FWD_COMMAND_ADD_PROPERTY] = { .min = 2, .max = 2 },
+		/* without arguments, retrieves the epoch and the generation */
+		[FWD_COMMAND_CHANGES_SINCE] = {
+				.min = 0,
+				.max = 2,
+				.defaults = { "", "0" },
+		},
+		[FWD_COMMAND_COMMANDS] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_CONFIG_KEYS] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_DEFINE_TEMPLATE] = {
+				.min = 2,
+				.max = FDC_VARIADIC,
+				.leading = 2,
+				.tuple = 2,
+		},
+		[FWD_COMMAND_DROP] = { .min = 2, .max = 2 },
+		[FWD_COMMAND_FOLDERS] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_GET_CONFIG] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_GET_PROPERTIES] = {
+				.min = 3,
+				.max = FDC_VARIADIC,
+				.leading = 1,
+				.tuple = 2,
+		},
+		[FWD_COMMAND_GET_PROPERTY] = { .min = 3, .max = 3 },
+		/* starting many instances can take a while */
+		[FWD_COMMAND_GROUP] = { .min = 3, .max = 3, .long_running = true },
+		[FWD_COMMAND_HELP] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_KILL] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_LIST] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_LIST_PAGE] = {
+				.min = 1,
+				.max = 3,
+				.defaults = { NULL, "", "0" },
+		},
+		[FWD_COMMAND_PING] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_PREPARE] = {
+				.min = 2,
+				.max = FDC_VARIADIC,
+				.join = true,
+		},
+		[FWD_COMMAND_PROPERTIES] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_QUERY] = {
+				.min = 1,
+				.max = 3,
+				.defaults = { NULL, "*", "sha1,name" },
+		},
+		[FWD_COMMAND_QUIT] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_REMOUNT] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_SET_DEADLINE] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_SET_PROPERTIES] = {
+				.min = 5,
+				.max = FDC_VARIADIC,
+				.leading = 2,
+				.tuple = 3,
+		},
+		[FWD_COMMAND_SET_PROPERTY] = { .min = 4, .max = 4 },
+		[FWD_COMMAND_SHOW] = { .min = 2, .max = 2 },
+		[FWD_COMMAND_SHOW_PROPERTIES] = { .min = 2, .max = 2 },
+		[FWD_COMMAND_START] = { .min = 1, .max = 1 },
+		[FWD_COMMAND_STATS] = { .min = 0, .max = 0 },
+		[FWD_COMMAND_SUBSCRIBE] = { .min = 3, .max = 3 },
+		[FWD_COMMAND_UNWATCH] = { .min = 3, .max = 3 },
+		[FWD_COMMAND_VERSION] = { .min = 0, .max = 0 },
+		/*
+		 * the watch ends with the connection, so fdc waits for the
+		 * first change
+		 */
+		[FWD_COMMAND_WATCH] = { .min = 3, .max = 3, .long_running = true },
+		[FWD_COMMAND_ABORT] = { .min = 2, .max = 2 },
+};
+
+struct fdc_value {
+	uint8_t type;
+	union pomp_value v;
+};
+
+/* the strings point inside the message received, valid while processing it */
+struct fdc_answer {
+	enum fwd_message id;
+	uint32_t seqnum;
+	/* arguments following the sequence number */
+	struct fdc_value *values;
+	unsigned nb_values;
+	unsigned capacity;
+};
+
+struct fdc;
+
+struct fdc_request {
+	struct fdc *fdc;
+	enum fwd_message command;
+	/* arguments as given on the command-line */
+	char **user_args;
+	unsigned nb_user_args;
+	/* arguments as sent, defaults included */
+	const char **args;
+	unsigned nb_args;
+	char *joined;
+	char count[16];
+	/* in seconds, FDC_INFINITE_TIMEOUT for no timeout */
+	int timeout;
+	/* in batch mode, number of the line of the command */
+	unsigned line;
+	bool done;
+	enum fdc_status status;
+	/* the progress of a preparation has been output */
+	bool progress;
+	/* WATCHED has been received, the first change is waited for */
+	bool watching;
+};
+
+struct fdc {
+	struct fwd_client *client;
+	bool batch;
+	bool verbose;
+	/* the request waiting for its answer, if any */
+	struct fdc_request *request;
+	struct fdc_answer answer;
+};
+
+static void usage(void)
+{
+	printf("Usage : fdc COMMAND [arguments_list]\n"
+			"        fdc --batch\n"
+			"        fdc --status [STATUS_TABLE_PATH]\n"
+			"\tCommand names are case-insensitive.\n"
+			"\tThe arguments_list depend on the commands used.\n"
+			"\tUse 'fdc commands' to obtain the list of available "
+			"commands.\n"
+			"\tUse 'fdc help COMMAND' to get some help on a command "
+			"COMMAND.\n"
+			"\tWith --batch, the commands are read from the "
+			"standard input, one per line.\n"
+			"\tWith --status, the status table is printed, one "
+			"entity per line.\n");
+}
+
+static int64_t now_ms(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+static void request_clean(struct fdc_request *req)
+{
+	free(req->args);
+	ut_string_free(&req->joined);
+	memset(req, 0, sizeof(*req));
+}
+
+/* returns FDC_ERROR_OTHER if the arguments don't match the command's syntax */
+static enum fdc_status request_init(struct fdc_request *req, struct fdc *fdc,
+		enum fwd_message command, unsigned nb_user_args,
+		char *user_args[])
+{
+	const struct fdc_syntax *syntax = syntaxes + command;
+	const char *timeout;
+	unsigned i;
+	unsigned nb_tuple_args;
+
+	memset(req, 0, sizeof(*req));
+	req->fdc = fdc;
+	req->command = command;
+	req->user_args = user_args;
+	req->nb_user_args = nb_user_args;
+
+	if (nb_user_args < syntax->min || nb_user_args > syntax->max)
+		return FDC_ERROR_OTHER;
+	nb_tuple_args = nb_user_args - syntax->leading;
+	if (syntax->tuple != 0 && nb_tuple_args % syntax->tuple != 0)
+		return FDC_ERROR_OTHER;
+
+	req->args = calloc(nb_user_args + FDC_MAX_DEFAULTS + 1,
+			sizeof(*req->args));
+	if (req->args == NULL)
+		return FDC_ERROR_OTHER;
+	for (i = 0; i < nb_user_args; i++)
+		req->args[i] = user_args[i];
+	for (; i < FDC_MAX_DEFAULTS && syntax->defaults[i] != NULL; i++)
+		req->args[i] = syntax->defaults[i];
+	req->nb_args = i;
+	if (syntax->tuple != 0) {
+		snprintf(req->count, sizeof(req->count), "%u",
+				nb_tuple_args / syntax->tuple);
+		memmove(req->args + syntax->leading + 1,
+				req->args + syntax->leading,
+				nb_tuple_args * sizeof(*req->args));
+		req->args[syntax->leading] = req->count;
+		req->nb_args++;
+	}
+	if (syntax->join) {
+		for (i = 1; i < nb_user_args; i++)
+			if (ut_string_append(&req->joined, "%s%s",
+					i == 1 ? "" : " ", user_args[i]) < 0)
+				return FDC_ERROR_OTHER;
+		req->args[1] = req->joined;
+		req->nb_args = 2;
+	}
+
+	timeout = getenv("FDC_TIMEOUT");
+	if (command == FWD_COMMAND_PREPARE)
+		req->timeout = FDC_INFINITE_TIMEOUT;
+	else if (timeout != NULL)
+		req->timeout = atoi(timeout);
+	else if (syntax->long_running)
+		req->timeout = FDC_INFINITE_TIMEOUT;
+	else
+		req->timeout = FDC_DEFAULT_TIMEOUT;
+
+	return FDC_SUCCESS;
+}
+
+static int decode_cb(struct pomp_decoder *dec, uint8_t type,
+		const union pomp_value *v, uint32_t buflen, void *userdata)
+{
+	struct fdc_answer *answer = userdata;
+	struct fdc_value *values;
+	unsigned capacity;
+
+	if (answer->nb_values == answer->capacity) {
+		capacity = answer->capacity == 0 ? 16 : 2 * answer->capacity;
+		values = realloc(answer->values, capacity * sizeof(*values));
+		if (values == NULL)
+			return 0;
+		answer->values = values;
+		answer->capacity = capacity;
+	}
+	answer->values[answer->nb_values].type = type;
+	answer->values[answer->nb_values].v = *v;
+	answer->nb_values++;
+
+	return 1;
+}
+
+static void pomp_decoder_destroy_p(struct pomp_decoder **dec)
+{
+	if (*dec != NULL)
+		pomp_decoder_destroy(*dec);
+	*dec = NULL;
+}
+
+static int answer_decode(struct fdc_answer *answer, const struct pomp_msg *msg)
+{
+	int ret;
+	struct pomp_decoder __attribute__((cleanup(pomp_decoder_destroy_p)))
+			*dec = NULL;
+
+	answer->id = pomp_msg_get_id(msg);
+	answer->nb_values = 0;
+	dec = pomp_decoder_new();
+	if (dec == NULL)
+		return -ENOMEM;
+	ret = pomp_decoder_init(dec, msg);
+	if (ret < 0)
+		return ret;
+	ret = pomp_decoder_walk(dec, decode_cb, answer, 0);
+	pomp_decoder_clear(dec);
+	if (ret < 0)
+		return ret;
+	if (answer->nb_values == 0 ||
+			answer->values[0].type != POMP_PROT_DATA_TYPE_U32)
+		return -EPROTO;
+
+	/* the sequence number is kept apart */
+	answer->seqnum = answer->values[0].v.u32;
+	answer->nb_values--;
+	memmove(answer->values, answer->values + 1,
+			answer->nb_values * sizeof(*answer->values));
+
+	return 0;
+}
+
+static const char *str_at(const struct fdc_answer *answer, unsigned i)
+{
+	if (i >= answer->nb_values ||
+			answer->values[i].type != POMP_PROT_DATA_TYPE_STR)
+		return "";
+
+	return answer->values[i].v.str;
+}
+
+static uint32_t u32_at(const struct fdc_answer *answer, unsigned i)
+{
+	if (i >= answer->nb_values ||
+			answer->values[i].type != POMP_PROT_DATA_TYPE_U32)
+		return 0;
+
+	return answer->values[i].v.u32;
+}
+
+static int32_t i32_at(const struct fdc_answer *answer, unsigned i)
+{
+	if (i >= answer->nb_values ||
+			answer->values[i].type != POMP_PROT_DATA_TYPE_I32)
+		return 0;
+
+	return answer->values[i].v.i32;
+}
+
+static uint64_t u64_at(const struct fdc_answer *answer, unsigned i)
+{
+	if (i >= answer->nb_values ||
+			answer->values[i].type != POMP_PROT_DATA_TYPE_U64)
+		return 0;
+
+	return answer->values[i].v.u64;
+}
+
+static const char *last_str(const struct fdc_answer *answer)
+{
+	unsigned i = answer->nb_values;
+
+	while (i-- > 0)
+		if (answer->values[i].type == POMP_PROT_DATA_TYPE_STR)
+			return answer->values[i].v.str;
+
+	return "";
+}
+
+/* outputs a free text, the empty ones are skipped, like empty lines */
+static void print_text(const char *text)
+{
+	size_t len = strlen(text);
+
+	if (len == 0)
+		return;
+	fputs(text, stdout);
+	if (text[len - 1] != '\n')
+		putchar('\n');
+}
+
+/* outputs a string with its tabs, newlines and backslashes escaped */
+static void print_escaped(FILE *out, const char *str)
+{
+	for (; *str != '\0'; str++) {
+		switch (*str) {
+		case '\t':
+			fputs("\\t", out);
+			break;
+		case '\n':
+			fputs("\\n", out);
+			break;
+		case '\\':
+			fputs("\\\\", out);
+			break;
+		default:
+			fputc(*str, out);
+		}
+	}
+}
+
+static void print_values(FILE *out, const struct fdc_answer *answer)
+{
+	unsigned i;
+	const struct fdc_value *value;
+
+	for (i = 0; i < answer->nb_values; i++) {
+		value = answer->values + i;
+		fputc('\t', out);
+		switch (value->type) {
+		case POMP_PROT_DATA_TYPE_I32:
+			fprintf(out, "%"PRIi32, value->v.i32);
+			break;
+		case POMP_PROT_DATA_TYPE_U32:
+			fprintf(out, "%"PRIu32, value->v.u32);
+			break;
+		case POMP_PROT_DATA_TYPE_U64:
+			fprintf(out, "%"PRIu64, value->v.u64);
+			break;
+		case POMP_PROT_DATA_TYPE_STR:
+			print_escaped(out, value->v.str);
+			break;
+		default:
+			fputc('?', out);
+		}
+	}
+}
+
+/* outputs the tuples of strings and errnos as "A B ok_word" or "A B error N" */
+static void print_results(const struct fdc_answer *answer, unsigned first,
+		unsigned count, const char *ok_word, bool swap)
+{
+	unsigned i;
+	unsigned base;
+	const char *a;
+	const char *b;
+
+	for (i = 0; i < count; i++) {
+		base = first + 3 * i;
+		a = str_at(answer, base + (swap ? 1 : 0));
+		b = str_at(answer, base + (swap ? 0 : 1));
+		if (i32_at(answer, base + 2) == 0)
+			printf("%s %s %s\n", a, b, ok_word);
+		else
+			printf("%s %s error %"PRIi32"\n", a, b,
+					i32_at(answer, base + 2));
+	}
+}
+
+static void print_changes(const struct fdc_answer *answer)
+{
+	unsigned i;
+	unsigned base;
+	char __attribute__((cleanup(ut_string_free))) *line = NULL;
+
+	printf("%s %"PRIu64" %"PRIu32"\n", str_at(answer, 0),
+			u64_at(answer, 1), u32_at(answer, 2));
+	for (i = 0; i < u32_at(answer, 3); i++) {
+		base = 4 + 7 * i;
+		ut_string_free(&line);
+		if (asprintf(&line, "%"PRIu64" %s %s %s %s %s %s",
+				u64_at(answer, base), str_at(answer, base + 1),
+				str_at(answer, base + 2),
+				str_at(answer, base + 3),
+				str_at(answer, base + 4),
+				str_at(answer, base + 5),
+				str_at(answer, base + 6)) < 0) {
+			line = NULL;
+			return;
+		}
+		/* PROPERTY and VALUE are empty but for CHANGED */
+		puts(ut_string_rstrip(line));
+	}
+}
+
+static void print_list_page(const struct fdc_answer *answer)
+{
+	unsigned i;
+	unsigned count = u32_at(answer, 2);
+	const char *cursor = str_at(answer, 1);
+
+	if (count == 0 && *cursor == '\0')
+		return;
+	for (i = 0; i < count; i++)
+		printf("%s%s[%s]", i == 0 ? "" : " ",
+				str_at(answer, 4 + 2 * i),
+				str_at(answer, 3 + 2 * i));
+	if (*cursor != '\0')
+		printf("%s%s", count == 0 ? "" : " ", cursor);
+	putchar('\n');
+}
+
+static void print_query(const struct fdc_answer *answer)
+{
+	unsigned row;
+	unsigned column;
+	unsigned nb_columns = u32_at(answer, 1);
+	unsigned nb_rows = u32_at(answer, 2);
+
+	/* the first row contains the column names */
+	for (row = 0; row <= nb_rows; row++)
+		for (column = 0; column < nb_columns; column++)
+			printf("%s%c", str_at(answer,
+					3 + row * nb_columns + column),
+					column + 1 == nb_columns ? '\n' : ' ');
+}
+
+static void print_progress(struct fdc_request *req,
+		const struct fdc_answer *answer)
+{
+	const char *progress = str_at(answer, 2);
+
+	/* the progress overwrites itself, which only makes sense on a tty */
+	if (!isatty(STDOUT_FILENO))
+		return;
+
+	if (ut_string_match_prefix(progress, "queued "))
+		printf("position %s in the queue", progress + strlen("queued "));
+	else
+		printf("%s%% done", progress);
+	printf("\n\033[1A\033[?25l");
+	fflush(stdout);
+	req->progress = true;
+}
+
+/* outputs the answer terminating the request in a script-friendly way */
+static void print_answer(struct fdc_request *req,
+		const struct fdc_answer *answer)
+{
+	unsigned i;
+	const char *identifier = req->nb_user_args > 0 ? req->user_args[0] : "";
+
+	if (req->progress)
+		/* restores the cursor */
+		printf("\033[?25h");
+
+	/* order shall match enum fwd_message */
+	switch (answer->id) {
+	case FWD_ANSWER_CHANGES:
+		print_changes(answer);
+		break;
+	case FWD_ANSWER_COMMANDS:
+		printf("%s RESTART\n", str_at(answer, 0));
+		break;
+	case FWD_ANSWER_DEADLINE_SET:
+		printf("deadline set to %"PRIu32"ms\n", u32_at(answer, 0));
+		break;
+	case FWD_ANSWER_GET_CONFIG:
+		print_text(str_at(answer, 1));
+		break;
+	case FWD_ANSWER_GET_PROPERTIES:
+		for (i = 0; i < u32_at(answer, 1); i++) {
+			if (i32_at(answer, 4 + 4 * i) == 0)
+				printf("%s %s %s\n", str_at(answer, 2 + 4 * i),
+						str_at(answer, 3 + 4 * i),
+						str_at(answer, 5 + 4 * i));
+			else
+				printf("%s %s error %"PRIi32"\n",
+						str_at(answer, 2 + 4 * i),
+						str_at(answer, 3 + 4 * i),
+						i32_at(answer, 4 + 4 * i));
+		}
+		break;
+	case FWD_ANSWER_GROUP_DONE:
+		print_results(answer, 3, u32_at(answer, 2), "ok", true);
+		break;
+	case FWD_ANSWER_LIST:
+		print_text(str_at(answer, 2));
+		break;
+	case FWD_ANSWER_LIST_PAGE:
+		print_list_page(answer);
+		break;
+	case FWD_ANSWER_PONG:
+		printf("PONG\n");
+		break;
+	case FWD_ANSWER_PROPERTIES_SET:
+		print_results(answer, 3, u32_at(answer, 2), "set", false);
+		break;
+	case FWD_ANSWER_PROPERTY_ADDED:
+		printf("property %s added\n", str_at(answer, 1));
+		break;
+	case FWD_ANSWER_QUERY:
+		print_query(answer);
+		break;
+	case FWD_ANSWER_REMOUNTED:
+		printf("%s remounted\n", identifier);
+		break;
+	case FWD_ANSWER_SHOW_PROPERTIES:
+		for (i = 0; i < u32_at(answer, 3); i++)
+			printf("%s: %s\n", str_at(answer, 4 + 2 * i),
+					str_at(answer, 5 + 2 * i));
+		break;
+	case FWD_ANSWER_SUBSCRIBED:
+		printf("subscribed to %s %s %s\n", str_at(answer, 0),
+				str_at(answer, 1), str_at(answer, 2));
+		break;
+	case FWD_ANSWER_TEMPLATE_DEFINED:
+		printf("template %s of %s defined with %"PRIu32" properties\n",
+				str_at(answer, 1), str_at(answer, 0),
+				u32_at(answer, 2));
+		break;
+	case FWD_ANSWER_UNWATCHED:
+		printf("stopped watching %s %s %s\n", str_at(answer, 0),
+				str_at(answer, 1), str_at(answer, 2));
+		break;
+
+	case FWD_ANSWER_BYEBYE:
+		printf("firmwared said bye bye\n");
+		break;
+	case FWD_ANSWER_DEAD:
+		printf("%s killed\n", identifier);
+		break;
+	case FWD_ANSWER_DROPPED:
+		printf("%s dropped\n", req->user_args[1]);
+		break;
+	case FWD_ANSWER_PREPARED:
+		printf("new entity in %s folder created\nsha1: %s\nname: %s\n",
+				str_at(answer, 0), str_at(answer, 1),
+				str_at(answer, 2));
+		break;
+	case FWD_ANSWER_PROPERTY_CHANGED:
+		printf("%s %s %s\n", str_at(answer, 2), str_at(answer, 3),
+				str_at(answer, 4));
+		break;
+	case FWD_ANSWER_STARTED:
+		printf("%s started\n", identifier);
+		break;
+	case FWD_ANSWER_ABORTED:
+		printf("%s aborted\n", str_at(answer, 1));
+		break;
+
+	default:
+		/*
+		 * CONFIG_KEYS, FOLDERS, GET_PROPERTY, HELP, PROPERTIES,
+		 * PROPERTY_SET, SHOW, STATS, VERSION and the like, carry their
+		 * result in their last argument
+		 */
+		print_text(last_str(answer));
+	}
+}
+
+/* decodes the message in fdc->answer, which is dumped in verbose mode */
+static int fdc_decode(struct fdc *fdc, const struct pomp_msg *msg)
+{
+	int ret;
+	struct fdc_answer *answer = &fdc->answer;
+
+	ret = answer_decode(answer, msg);
+	if (ret < 0) {
+		fprintf(stderr, "invalid message %"PRIu32" received: %s\n",
+				pomp_msg_get_id(msg), strerror(-ret));
+		return ret;
+	}
+	if (fdc->verbose) {
+		fprintf(stderr, "< %s %"PRIu32, fwd_message_str(answer->id),
+				answer->seqnum);
+		print_values(stderr, answer);
+		fputc('\n', stderr);
+	}
+
+	return 0;
+}
+
+static void answer_cb(struct fwd_client *client, int status,
+		const struct pomp_msg *msg, void *userdata)
+{
+	struct fdc_request *req = userdata;
+	struct fdc *fdc = req->fdc;
+	struct fdc_answer *answer = &fdc->answer;
+
+	/* cancelled on timeout, which has already been reported */
+	if (status == -ECANCELED)
+		return;
+
+	req->done = true;
+	req->status = FDC_ERROR_OTHER;
+	if (msg == NULL) {
+		if (fdc->batch)
+			printf("%u\tDISCONNECTED\n", req->line);
+		else
+			printf("Connection with firmwared lost\n");
+		return;
+	}
+	if (fdc_decode(fdc, msg) < 0)
+		return;
+	if (status == 0)
+		req->status = FDC_SUCCESS;
+
+	if (fdc->batch) {
+		printf("%u\t%s", req->line, fwd_message_str(answer->id));
+		print_values(stdout, answer);
+		putchar('\n');
+	} else if (status < 0) {
+		printf("firmwared error: %s\n", str_at(answer, 1));
+	} else if (req->command == FWD_COMMAND_WATCH) {
+		/* the changes are notified with an invalid sequence number */
+		req->watching = true;
+		req->done = false;
+	} else {
+		print_answer(req, answer);
+	}
+}
+
+static void notification_cb(struct fwd_client *client,
+		const struct pomp_msg *msg, void *userdata)
+{
+	struct fdc *fdc = userdata;
+	struct fdc_request *req = fdc->request;
+	struct fdc_answer *answer = &fdc->answer;
+
+	if (!fdc->verbose && (fdc->batch || req == NULL))
+		return;
+	if (fdc_decode(fdc, msg) < 0)
+		return;
+	if (fdc->batch || req == NULL || req->done)
+		return;
+
+	if (answer->id == FWD_ANSWER_PREPARE_PROGRESS &&
+			fwd_client_msg_matches(client, msg, req)) {
+		print_progress(req, answer);
+	} else if (answer->id == FWD_ANSWER_PROPERTY_CHANGED &&
+			req->watching) {
+		print_answer(req, answer);
+		req->done = true;
+	}
+}
+
+/* deadline is in ms, on the monotonic clock, or negative for no deadline */
+static int fdc_wait(struct fdc *fdc, const struct fdc_request *req,
+		int64_t deadline)
+{
+	int ret;
+	int64_t remaining = -1;
+
+	while (!req->done) {
+		if (deadline >= 0) {
+			remaining = deadline - now_ms();
+			if (remaining <= 0)
+				return -ETIMEDOUT;
+		}
+		ret = fwd_client_wait_and_process(fdc->client, remaining);
+		if (ret < 0 && ret != -ETIMEDOUT)
+			return ret;
+	}
+
+	return 0;
+}
+
+/* the deadline covers the connection to firmwared */
+static enum fdc_status fdc_request_run(struct fdc *fdc,
+		struct fdc_request *req)
+{
+	int ret;
+	unsigned i;
+	int64_t deadline = -1;
+
+	if (req->timeout >= 0)
+		deadline = now_ms() + 1000 * (int64_t)req->timeout;
+
+	if (fdc->verbose) {
+		fprintf(stderr, "> %s", fwd_message_str(req->command));
+		for (i = 0; i < req->nb_args; i++)
+			fprintf(stderr, " \"%s\"", req->args[i]);
+		fputc('\n', stderr);
+	}
+	ret = fwd_client_send_strv(fdc->client, req->command, answer_cb, req,
+			req->nb_args, req->args);
+	if (ret < 0) {
+		fprintf(stderr, "sending %s failed: %s\n",
+				fwd_message_str(req->command), strerror(-ret));
+		return FDC_ERROR_OTHER;
+	}
+	fdc->request = req;
+	ret = fdc_wait(fdc, req, deadline);
+	fdc->request = NULL;
+	if (ret < 0) {
+		/* a late answer mustn't be taken for the next request's */
+		fwd_client_cancel(fdc->client, req);
+		return ret == -ETIMEDOUT ? FDC_ERROR_TIMEOUT : FDC_ERROR_OTHER;
+	}
+
+	return req->status;
+}
+
+static int fdc_init(struct fdc *fdc)
+{
+	memset(fdc, 0, sizeof(*fdc));
+	fdc->verbose = getenv("V") != NULL;
+
+	fdc->client = fwd_client_new(getenv("FIRMWARED_SOCKET_PATH"));
+	if (fdc->client == NULL)
+		return -errno;
+
+	return fwd_client_set_notification_cb(fdc->client,
+			FWD_MESSAGE_INVALID, notification_cb, fdc);
+}
+
+static void fdc_cleanup(struct fdc *fdc)
+{
+	fwd_client_destroy(&fdc->client);
+	free(fdc->answer.values);
+	memset(fdc, 0, sizeof(*fdc));
+}
+
+/* returns FWD_MESSAGE_INVALID if the name isn't the one of a command */
+static enum fwd_message command_from_str(const char *name)
+{
+	enum fwd_message command;
+	char upper[64];
+	size_t i;
+
+	for (i = 0; name[i] != '\0' && i < sizeof(upper) - 1; i++)
+		upper[i] = toupper(name[i]);
+	upper[i] = '\0';
+
+	command = fwd_message_from_str(upper);
+	if (fwd_message_is_invalid(command) || command > FWD_COMMAND_LAST)
+		return FWD_MESSAGE_INVALID;
+
+	return command;
+}
+
+static enum fdc_status fdc_command(struct fdc *fdc, enum fwd_message command,
+		unsigned nb_args, char *args[])
+{
+	enum fdc_status status;
+	struct fdc_request req;
+
+	status = request_init(&req, fdc, command, nb_args, args);
+	if (status == FDC_SUCCESS) {
+		status = fdc_request_run(fdc, &req);
+	} else {
+		printf("Command-line error\n");
+		usage();
+	}
+	request_clean(&req);
+
+	return status;
+}
+
+/* fdc meta-command which performs kill, remount and start on an instance */
+static enum fdc_status fdc_restart(struct fdc *fdc, unsigned nb_args,
+		char *args[])
+{
+	enum fdc_status status;
+
+	if (nb_args != 1) {
+		printf("Command-line error\n");
+		usage();
+		return FDC_ERROR_OTHER;
+	}
+
+	/* the instance may not be running */
+	status = fdc_command(fdc, FWD_COMMAND_KILL, nb_args, args);
+	if (status == FDC_ERROR_TIMEOUT)
+		return status;
+	status = fdc_command(fdc, FWD_COMMAND_REMOUNT, nb_args, args);
+	if (status != FDC_SUCCESS)
+		return status;
+
+	return fdc_command(fdc, FWD_COMMAND_START, nb_args, args);
+}
+
+static enum fdc_status fdc_run(struct fdc *fdc, const char *name,
+		unsigned nb_args, char *args[])
+{
+	enum fwd_message command;
+
+	if (strcasecmp(name, "RESTART") == 0)
+		return fdc_restart(fdc, nb_args, args);
+	if (strcasecmp(name, "HELP") == 0 && nb_args == 1 &&
+			strcasecmp(args[0], "RESTART") == 0) {
+		printf("Command RESTART\n"
+				"Synopsis: RESTART INSTANCE_IDENTIFIER\n"
+				"Overview: fdc meta-command which performs "
+				"kill, remount and start on an instance.\n");
+		return FDC_SUCCESS;
+	}
+
+	command = command_from_str(name);
+	if (command == FWD_MESSAGE_INVALID) {
+		printf("Command \"%s\" not found\n", name);
+		usage();
+		return FDC_ERROR_INVALID_COMMAND;
+	}
+
+	return fdc_command(fdc, command, nb_args, args);
+}
+
+static void argz_free(char **argz)
+{
+	free(*argz);
+	*argz = NULL;
+}
+
+/*
+ * splits a line in words separated by blanks, quotes and backslashes are
+ * interpreted like in a shell, but nothing is expanded, a # starting a word
+ * starts a comment
+ */
+static int split_line(const char *line, char **argz, size_t *argz_len)
+{
+	int ret;
+	char __attribute__((cleanup(ut_string_free))) *word = NULL;
+	size_t len = 0;
+	char quote = '\0';
+	bool in_word = false;
+	const char *p;
+
+	word = malloc(strlen(line) + 1);
+	if (word == NULL)
+		return -errno;
+
+	for (p = line; *p != '\0'; p++) {
+		if (quote == '\'') {
+			if (*p == '\'')
+				quote = '\0';
+			else
+				word[len++] = *p;
+		} else if (*p == '\\' && p[1] != '\0') {
+			word[len++] = *++p;
+			in_word = true;
+		} else if (quote == '"') {
+			if (*p == '"')
+				quote = '\0';
+			else
+				word[len++] = *p;
+		} else if (*p == '\'' || *p == '"') {
+			quote = *p;
+			in_word = true;
+		} else if (isspace(*p)) {
+			if (!in_word)
+				continue;
+			word[len] = '\0';
+			ret = -argz_add(argz, argz_len, word);
+			if (ret < 0)
+				return ret;
+			len = 0;
+			in_word = false;
+		} else if (*p == '#' && !in_word) {
+			break;
+		} else {
+			word[len++] = *p;
+			in_word = true;
+		}
+	}
+	if (quote != '\0')
+		return -EINVAL;
+	if (!in_word)
+		return 0;
+	word[len] = '\0';
+
+	return -argz_add(argz, argz_len, word);
+}
+
+/* outputs "LINE\tINVALID\tREASON", the answers are output by process_message */
+static enum fdc_status batch_command(struct fdc *fdc, unsigned line,
+		char *args[], unsigned nb_args)
+{
+	enum fdc_status status;
+	enum fwd_message command;
+	struct fdc_request req;
+
+	command = command_from_str(args[0]);
+	if (command == FWD_MESSAGE_INVALID) {
+		printf("%u\tINVALID\tcommand %s not found\n", line, args[0]);
+		return FDC_ERROR_INVALID_COMMAND;
+	}
+	status = request_init(&req, fdc, command, nb_args - 1, args + 1);
+	if (status != FDC_SUCCESS) {
+		printf("%u\tINVALID\tinvalid arguments for %s\n", line,
+				fwd_message_str(command));
+	} else {
+		req.line = line;
+		status = fdc_request_run(fdc, &req);
+		if (status == FDC_ERROR_TIMEOUT)
+			printf("%u\tTIMEOUT\n", line);
+	}
+	request_clean(&req);
+
+	return status;
+}
+
+/*
+ * each command read on stdin is sent once the previous one is answered, the
+ * exit status is the one of the last command which failed
+ */
+static enum fdc_status fdc_batch(struct fdc *fdc)
+{
+	int ret;
+	enum fdc_status status = FDC_SUCCESS;
+	enum fdc_status command_status;
+	char __attribute__((cleanup(ut_string_free))) *line = NULL;
+	char __attribute__((cleanup(argz_free))) *argz = NULL;
+	char **args = NULL;
+	size_t size = 0;
+	size_t argz_len;
+	unsigned line_number = 0;
+
+	fdc->batch = true;
+	while (getline(&line, &size, stdin) != -1) {
+		line_number++;
+		argz_free(&argz);
+		argz_len = 0;
+		ret = split_line(line, &argz, &argz_len);
+		if (ret < 0) {
+			printf("%u\tINVALID\t%s\n", line_number, strerror(-ret));
+			status = FDC_ERROR_OTHER;
+			continue;
+		}
+		if (argz_len == 0)
+			continue;
+		args = calloc(argz_count(argz, argz_len) + 1, sizeof(*args));
+		if (args == NULL)
+			return FDC_ERROR_OTHER;
+		argz_extract(argz, argz_len, args);
+		command_status = batch_command(fdc, line_number, args,
+				argz_count(argz, argz_len));
+		free(args);
+		if (command_status != FDC_SUCCESS)
+			status = command_status;
+		fflush(stdout);
+	}
+
+	return status;
+}
+
+/* one tab-separated line per entity, in the order of the slots */
+static enum fdc_status fdc_status(const char *path)
+{
+	int ret;
+	int i;
+	struct fwd_status *status;
+	struct fwd_status_entry *entries;
+	const struct fwd_status_entry *e;
+
+	status = fwd_status_open(path);
+	if (status == NULL) {
+		fprintf(stderr, "fwd_status_open: %m\n");
+		return FDC_ERROR_OTHER;
+	}
+	entries = calloc(fwd_status_get_nb_slots(status), sizeof(*entries));
+	if (entries == NULL) {
+		fwd_status_close(&status);
+		return FDC_ERROR_OTHER;
+	}
+	ret = fwd_status_snapshot(status, entries);
+	fwd_status_close(&status);
+	if (ret < 0) {
+		fprintf(stderr, "fwd_status_snapshot: %s\n", strerror(-ret));
+		free(entries);
+		return FDC_ERROR_OTHER;
+	}
+	for (i = 0; i < ret; i++) {
+		e = entries + i;
+		printf("%s\t%s\t%s\t%s\t%"PRId32"\t%"PRIu32"\t%s\t%s\n",
+				e->folder, e->name, e->sha1, e->state, e->pid,
+				e->id, e->ip, e->firmware);
+	}
+	free(entries);
+
+	return FDC_SUCCESS;
+}
+
+int main(int argc, char *argv[])
+{
+	int ret;
+	enum fdc_status status;
+	struct fdc fdc;
+
+	if (argc < 2) {
+		printf("Command-line error\n");
+		usage();
+		return FDC_ERROR_OTHER;
+	}
+	if (ut_string_match(argv[1], "-h") ||
+			ut_string_match(argv[1], "--help")) {
+		usage();
+		return FDC_SUCCESS;
+	}
+
+	if (ut_string_match(argv[1], "--status")) {
+		if (argc <= 3)
+			return fdc_status(argv[2]);
+		printf("Command-line error\n");
+		usage();
+		return FDC_ERROR_OTHER;
+	}
+
+	ret = fdc_init(&fdc);
+	if (ret < 0) {
+		fprintf(stderr, "fdc_init: %s\n", strerror(-ret));
+		return FDC_ERROR_OTHER;
+	}
+	if (ut_string_match(argv[1], "--batch")) {
+		if (argc == 2) {
+			status = fdc_batch(&fdc);
+		} else {
+			printf("Command-line error\n");
+			usage();
+			status = FDC_ERROR_OTHER;
+		}
+	} else {
+		status = fdc_run(&fdc, argv[1], argc - 2, argv + 2);
+		if (status == FDC_ERROR_TIMEOUT)
+			printf("Connection with firmwared timed out\n");
+	}
+	fdc_cleanup(&fdc);
+
+	return status;
+}